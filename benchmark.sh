@@ -0,0 +1,75 @@
+#!/bin/sh
+#******************************************************************
+# Conway's Game of Life - Benchmark Suite
+#
+# Usage: ./benchmark.sh [results.csv]
+#
+# Author: hrosicka
+# Description:
+#   Builds every game-of-life-*.c program and runs it headless
+#   (--bench) at several board sizes, with each step kernel and
+#   thread count. Every run appends one row to a CSV file (default
+#   benchmark-results.csv) with generations/s, cell-updates/s and
+#   ns/cell, so results of two releases can be compared directly.
+#   Each program also runs ENSEMBLE soups of its own board size with
+#   the 64-board ensemble and one at a time (--ensemble).
+#
+# Environment:
+#   SIZES     Board sizes, square (default "64 256 1024 4096 16384")
+#   KERNELS   Step kernels (default "packed lut simd blocked")
+#   THREADS   Thread counts (default "1" and the number of CPUs)
+#   ENSEMBLE  Soups of the --ensemble runs (default 4096)
+#   WORK      Cell updates per run; the generation count of a run is
+#             WORK / (size * size), between 10 and 100000
+#   CC, CFLAGS  Compiler and flags used for the build
+#******************************************************************
+
+set -e
+
+RESULTS=${1:-benchmark-results.csv}
+SIZES=${SIZES:-"64 256 1024 4096 16384"}
+KERNELS=${KERNELS:-"packed lut simd blocked"}
+CPUS=$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 1)
+if [ "$CPUS" -gt 1 ]; then
+    THREADS=${THREADS:-"1 $CPUS"}
+else
+    THREADS=${THREADS:-1}
+fi
+ENSEMBLE=${ENSEMBLE:-4096}
+WORK=${WORK:-4000000000}
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:-"-O2"}
+
+PROGRAMS="blinker toad glider lwss pulsar beacon gun"
+LIBRARY="life/*.c"
+BUILD=bench-build
+
+mkdir -p "$BUILD"
+rm -f "$RESULTS"
+
+for program in $PROGRAMS; do
+    $CC $CFLAGS "game-of-life-$program.c" $LIBRARY -o "$BUILD/game-of-life-$program" -lm -lpthread
+done
+
+for program in $PROGRAMS; do
+    for size in $SIZES; do
+        generations=$((WORK / (size * size)))
+        [ "$generations" -lt 10 ] && generations=10
+        [ "$generations" -gt 100000 ] && generations=100000
+
+        for kernel in $KERNELS; do
+            for threads in $THREADS; do
+                "$BUILD/game-of-life-$program" --bench --generations "$generations" \
+                    --width "$size" --height "$size" --kernel "$kernel" --threads "$threads" \
+                    --bench-csv "$RESULTS"
+            done
+        done
+    done
+
+    for threads in $THREADS; do
+        "$BUILD/game-of-life-$program" --ensemble "$ENSEMBLE" --generations 1000 --threads "$threads" \
+            --bench-csv "$RESULTS"
+    done
+done
+
+echo "Results written to $RESULTS"
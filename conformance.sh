@@ -0,0 +1,43 @@
+#!/bin/sh
+#******************************************************************
+# Conway's Game of Life - Kernel Conformance Suite
+#
+# Usage: ./conformance.sh [boards]
+#
+# Author: hrosicka
+# Description:
+#   Builds the glider program with sanitizers and runs --conform:
+#   random boards (default 1000) are run through every step kernel,
+#   instruction set and thread count, and through the ensemble,
+#   sparse, domain and mapped engines, and compared with the scalar
+#   reference. Exits
+#   with status 1 and prints the shrunk board if any run differs or
+#   a sanitizer reports an error. The boards do not depend on the
+#   program, so one program is enough.
+#
+# Environment:
+#   SANITIZE  Sanitizers to build with (default "address,undefined";
+#             "thread" for data races, empty for none)
+#   SEED      Seed of the first board (default 1)
+#   CC, CFLAGS  Compiler and flags used for the build
+#******************************************************************
+
+set -e
+
+BOARDS=${1:-1000}
+SANITIZE=${SANITIZE-"address,undefined"}
+SEED=${SEED:-1}
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:-"-O1 -g"}
+
+LIBRARY="life/*.c"
+BUILD=conform-build
+
+if [ -n "$SANITIZE" ]; then
+    CFLAGS="$CFLAGS -fsanitize=$SANITIZE -fno-sanitize-recover=all -fno-omit-frame-pointer"
+fi
+
+mkdir -p "$BUILD"
+$CC $CFLAGS game-of-life-glider.c $LIBRARY -o "$BUILD/game-of-life-glider" -lm -lpthread
+
+"$BUILD/game-of-life-glider" --conform "$BOARDS" --seed "$SEED"
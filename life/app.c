@@ -0,0 +1,1723 @@
+/*******************************************************************
+ * Conway's Game of Life - Shared Program Driver
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of life_main() declared in app.h.
+ *******************************************************************/
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app.h"
+#include "census.h"
+#include "checkpoint.h"
+#include "clock.h"
+#include "conform.h"
+#include "cycle.h"
+#include "domain.h"
+#include "ensemble.h"
+#include "hashlife.h"
+#include "load.h"
+#include "mapped.h"
+#include "pace.h"
+#include "random.h"
+#include "record.h"
+#include "render.h"
+#include "simd.h"
+#include "sparse.h"
+#include "stats.h"
+#include "triple.h"
+
+#define VIEW_MAX_WIDTH 240      // Widest part of the board that is printed
+#define VIEW_MAX_HEIGHT 120     // Tallest part of the board that is printed
+#define HASHLIFE_MEMORY_MB 256  // Default memory cap for --hashlife
+#define BENCH_GENERATIONS 1000  // Default generation count for --bench
+#define ASYNC_FPS 30            // Default display rate for --async
+#define CYCLE_DELAY 100         // Minimum frame delay (ms) once the board repeats
+#define NS_PER_MS 1000000LL
+#define SOUP_SIZE 16            // Default side of a --census or --ensemble soup
+#define ENSEMBLE_DENSITY 50     // Percent of live cells in an --ensemble soup
+#define SOUP_GENERATIONS 20000  // Generations a --census soup gets to settle
+
+/**
+ * @brief Options collected from the command line.
+ */
+struct options {
+    int width;
+    int height;
+    int threads;
+    enum life_kernel kernel;
+    long long step;
+    long long speed;
+    int unbounded;
+    int async;
+    int fps;
+    int bench;
+    long long generations;
+    const char *bench_csv;
+    int use_hashlife;
+    unsigned long long hashlife_target;
+    size_t hashlife_memory;
+    const char *pattern_file;
+    long long offset_x;
+    long long offset_y;
+    long long checkpoint_every;
+    const char *checkpoint_file;
+    const char *resume_file;
+    int use_jump;
+    long long jump_target;
+    int has_rule;
+    struct life_ruleset rule;
+    long long census_soups;
+    long long ensemble_boards;
+    long long conform_boards;
+    unsigned long long seed;
+    int soup_size;
+    long long stats_every;
+    const char *stats_file;
+    int processes;
+    const char *mapped_file;
+    const char *record_file;
+    long long record_every;
+    int record_scale;
+};
+
+/**
+ * @brief Prints the options to out: stdout for --help, stderr after a
+ * bad option.
+ */
+static void print_usage(const struct life_program *program, FILE *out) {
+    fprintf(out,
+            "Usage: %s [options]\n"
+            "  --width N             Number of columns (default %d)\n"
+            "  --height N            Number of rows (default %d)\n"
+            "  --threads N           Threads used to compute each generation (default 1)\n"
+            "  --kernel NAME         Step kernel: packed, lut, simd or blocked (default packed)\n"
+            "  --isa NAME            Instruction set of the simd kernel: avx512, avx2, sse2 or scalar\n"
+            "                        (default: the widest the CPU supports)\n"
+            "  --rule RULE           Rule such as B36/S23 or highlife (default B3/S23,\n"
+            "                        or the rule named by the --pattern file)\n"
+            "  --step N              Generations computed between frames (default 1)\n"
+            "  --speed N             Target generations per second (default set by the program's delay)\n"
+            "  --unbounded           Run on an unbounded plane; the board size sets the view\n"
+            "  --async               Simulate at full speed on its own thread\n"
+            "  --fps N               Display rate for --async (default %d)\n"
+            "  --bench               Step without rendering and report the speed\n"
+            "  --generations N       Generations computed by --bench (default %d)\n"
+            "  --bench-csv FILE      Also append the --bench results to a CSV file\n"
+            "  --hashlife N          Jump to generation N on an unbounded plane and exit\n"
+            "  --hashlife-memory MB  Memory cap for --hashlife (default %d)\n"
+            "  --pattern FILE        Start from an RLE, Life 1.06 or .cells file instead\n"
+            "  --offset ROW,COL      Shift the starting pattern (default 0,0)\n"
+            "  --checkpoint-every N  Save a checkpoint every N generations\n"
+            "  --checkpoint FILE     Checkpoint file (default %s.ckpt)\n"
+            "  --resume FILE         Continue from a checkpoint instead of the patterns\n"
+            "  --jump N              Print generation N of the board, skipping cycles, and exit\n"
+            "  --census N            Run N random soups to the end, print what they became and exit\n"
+            "  --ensemble N          Run N random soups on the board 64 at a time, compare with one at a time\n"
+            "  --seed N              Seed of the first --census or --ensemble soup or --conform board (default 1)\n"
+            "  --soup-size N         Side of each --census or --ensemble soup (default %d)\n"
+            "  --conform N           Check every kernel against the scalar reference on N random boards\n"
+            "  --stats N             Show board statistics and phase times every N generations\n"
+            "  --stats-file FILE     Write statistics for every generation to FILE (.json: JSON lines, else CSV)\n"
+            "  --processes N         Split the board into bands run by N worker processes\n"
+            "  --mapped FILE         Keep the board in FILE (created if missing) instead of memory\n"
+            "  --record FILE         Record the run to FILE (.gif: animated GIF, else a delta frame stream)\n"
+            "  --record-every N      Generations between recorded frames (default 1)\n"
+            "  --record-scale N      Board cells per recorded pixel, in each direction (default 1)\n"
+            "  --help, -h            Print these options and exit\n",
+            program->name, program->width, program->height, ASYNC_FPS, BENCH_GENERATIONS,
+            HASHLIFE_MEMORY_MB, program->name, SOUP_SIZE);
+}
+
+/**
+ * @brief Returns the time between two ticks of an interactive loop, in nanoseconds.
+ *
+ * A tick computes --step generations. Without --speed it lasts the
+ * program's delay; a delay of 0 runs unpaced.
+ */
+static long long tick_period(const struct life_program *program, const struct options *options) {
+    if (options->speed == 0) {
+        return (long long)program->delay * NS_PER_MS;
+    }
+    double period = (double)options->step * 1e9 / (double)options->speed;
+    return period < 1.0 ? 1 : (long long)period;
+}
+
+/**
+ * @brief Parses a whole decimal number between min and max.
+ *
+ * @return int 0 on success, -1 if the text is not such a number.
+ */
+static int parse_number(const char *text, long long min, long long max, long long *value) {
+    char *end;
+    long long parsed = strtoll(text, &end, 10);
+    if (end == text || *end != '\0' || parsed < min || parsed > max) {
+        return -1;
+    }
+    *value = parsed;
+    return 0;
+}
+
+/**
+ * @brief Parses "ROW,COL" into two whole numbers.
+ *
+ * @return int 0 on success, -1 if the text is malformed.
+ */
+static int parse_offset(const char *text, long long *x, long long *y) {
+    char *end;
+    *x = strtoll(text, &end, 10);
+    if (end == text || *end != ',') {
+        return -1;
+    }
+    const char *rest = end + 1;
+    *y = strtoll(rest, &end, 10);
+    return end == rest || *end != '\0' ? -1 : 0;
+}
+
+/**
+ * @brief Fills in options from the command line.
+ *
+ * @return int 0 on success, 1 if --help was given, -1 on an unknown or
+ *         malformed option.
+ */
+static int parse_options(const struct life_program *program, int argc, char *argv[], struct options *options) {
+    options->width = program->width;
+    options->height = program->height;
+    options->threads = 1;
+    options->kernel = LIFE_KERNEL_PACKED;
+    options->step = 1;
+    options->speed = 0;
+    options->unbounded = 0;
+    options->async = 0;
+    options->fps = ASYNC_FPS;
+    options->bench = 0;
+    options->generations = BENCH_GENERATIONS;
+    options->bench_csv = NULL;
+    options->use_hashlife = 0;
+    options->hashlife_target = 0;
+    options->hashlife_memory = HASHLIFE_MEMORY_MB;
+    options->pattern_file = NULL;
+    options->offset_x = 0;
+    options->offset_y = 0;
+    options->checkpoint_every = 0;
+    options->checkpoint_file = NULL;
+    options->resume_file = NULL;
+    options->use_jump = 0;
+    options->jump_target = 0;
+    options->has_rule = 0;
+    options->rule = (struct life_ruleset)LIFE_RULE_CONWAY;
+    options->census_soups = 0;
+    options->ensemble_boards = 0;
+    options->conform_boards = 0;
+    options->seed = 1;
+    options->soup_size = SOUP_SIZE;
+    options->stats_every = 0;
+    options->stats_file = NULL;
+    options->processes = 0;
+    options->mapped_file = NULL;
+    options->record_file = NULL;
+    options->record_every = 1;
+    options->record_scale = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *name = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        long long number;
+
+        if (strcmp(name, "--unbounded") == 0) {
+            options->unbounded = 1;
+            continue;
+        }
+        if (strcmp(name, "--async") == 0) {
+            options->async = 1;
+            continue;
+        }
+        if (strcmp(name, "--bench") == 0) {
+            options->bench = 1;
+            continue;
+        }
+        if (strcmp(name, "--help") == 0 || strcmp(name, "-h") == 0) {
+            return 1;
+        }
+        if (value == NULL) {
+            fprintf(stderr, "Missing value for %s\n", name);
+            return -1;
+        }
+        i++;
+
+        if (strcmp(name, "--width") == 0 && parse_number(value, 1, 1 << 30, &number) == 0) {
+            options->width = (int)number;
+        } else if (strcmp(name, "--height") == 0 && parse_number(value, 1, 1 << 30, &number) == 0) {
+            options->height = (int)number;
+        } else if (strcmp(name, "--threads") == 0 && parse_number(value, 1, 4096, &number) == 0) {
+            options->threads = (int)number;
+        } else if (strcmp(name, "--kernel") == 0 && life_kernel_parse(value, &options->kernel) == 0) {
+            // Parsed in the condition
+        } else if (strcmp(name, "--isa") == 0 && life_simd_select(value) == 0) {
+            // Selected in the condition; fails if the CPU lacks it
+        } else if (strcmp(name, "--rule") == 0 && life_rule_parse(value, &options->rule) == 0) {
+            options->has_rule = 1;
+        } else if (strcmp(name, "--step") == 0 && parse_number(value, 1, 1LL << 40, &number) == 0) {
+            options->step = number;
+        } else if (strcmp(name, "--speed") == 0 && parse_number(value, 1, 1LL << 40, &number) == 0) {
+            options->speed = number;
+        } else if (strcmp(name, "--fps") == 0 && parse_number(value, 1, 1000, &number) == 0) {
+            options->fps = (int)number;
+        } else if (strcmp(name, "--generations") == 0 && parse_number(value, 1, 1LL << 40, &number) == 0) {
+            options->generations = number;
+        } else if (strcmp(name, "--bench-csv") == 0) {
+            options->bench_csv = value;
+        } else if (strcmp(name, "--hashlife") == 0 && parse_number(value, 0, 1LL << 56, &number) == 0) {
+            options->use_hashlife = 1;
+            options->hashlife_target = (unsigned long long)number;
+        } else if (strcmp(name, "--hashlife-memory") == 0 && parse_number(value, 1, 1 << 20, &number) == 0) {
+            options->hashlife_memory = (size_t)number;
+        } else if (strcmp(name, "--pattern") == 0) {
+            options->pattern_file = value;
+        } else if (strcmp(name, "--offset") == 0 && parse_offset(value, &options->offset_x, &options->offset_y) == 0) {
+            // Parsed in the condition
+        } else if (strcmp(name, "--checkpoint-every") == 0 && parse_number(value, 1, 1LL << 40, &number) == 0) {
+            options->checkpoint_every = number;
+        } else if (strcmp(name, "--checkpoint") == 0) {
+            options->checkpoint_file = value;
+        } else if (strcmp(name, "--resume") == 0) {
+            options->resume_file = value;
+        } else if (strcmp(name, "--census") == 0 && parse_number(value, 1, 0xffffffffLL, &number) == 0) {
+            options->census_soups = number;
+        } else if (strcmp(name, "--ensemble") == 0 && parse_number(value, 1, 1LL << 30, &number) == 0) {
+            options->ensemble_boards = number;
+        } else if (strcmp(name, "--conform") == 0 && parse_number(value, 1, LLONG_MAX, &number) == 0) {
+            options->conform_boards = number;
+        } else if (strcmp(name, "--seed") == 0 && parse_number(value, 0, LLONG_MAX, &number) == 0) {
+            options->seed = (unsigned long long)number;
+        } else if (strcmp(name, "--soup-size") == 0 && parse_number(value, 1, 1024, &number) == 0) {
+            options->soup_size = (int)number;
+        } else if (strcmp(name, "--stats") == 0 && parse_number(value, 1, 1LL << 40, &number) == 0) {
+            options->stats_every = number;
+        } else if (strcmp(name, "--stats-file") == 0) {
+            options->stats_file = value;
+        } else if (strcmp(name, "--processes") == 0 &&
+                   parse_number(value, 1, LIFE_DOMAIN_MAX_WORKERS, &number) == 0) {
+            options->processes = (int)number;
+        } else if (strcmp(name, "--mapped") == 0) {
+            options->mapped_file = value;
+        } else if (strcmp(name, "--record") == 0) {
+            options->record_file = value;
+        } else if (strcmp(name, "--record-every") == 0 && parse_number(value, 1, 1LL << 40, &number) == 0) {
+            options->record_every = number;
+        } else if (strcmp(name, "--record-scale") == 0 && parse_number(value, 1, 1 << 20, &number) == 0) {
+            options->record_scale = (int)number;
+        } else if (strcmp(name, "--jump") == 0 && parse_number(value, 0, 1LL << 62, &number) == 0) {
+            options->use_jump = 1;
+            options->jump_target = number;
+        } else {
+            fprintf(stderr, "Invalid option: %s %s\n", name, value);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Creates the renderer for the visible part of the board.
+ *
+ * Boards larger than VIEW_MAX_WIDTH x VIEW_MAX_HEIGHT are shown from
+ * the top-left corner.
+ */
+static struct life_render *create_view(const struct life_program *program, const struct options *options) {
+    int rows = options->height < VIEW_MAX_HEIGHT ? options->height : VIEW_MAX_HEIGHT;
+    int cols = options->width < VIEW_MAX_WIDTH ? options->width : VIEW_MAX_WIDTH;
+    return life_render_create(rows, cols, program->alive_glyph, program->dead_glyph);
+}
+
+static int grid_cell(const void *board, long long x, long long y) {
+    return life_grid_get(board, (int)x, (int)y);
+}
+
+static int sparse_cell(const void *board, long long x, long long y) {
+    return life_sparse_get(board, x, y);
+}
+
+static int grid_run(void *board, long long x, long long y, long long length) {
+    life_grid_set_run(board, x, y, length);
+    return 0;
+}
+
+static int sparse_run(void *board, long long x, long long y, long long length) {
+    return life_sparse_set_run(board, x, y, length);
+}
+
+static int hashlife_run(void *board, long long x, long long y, long long length) {
+    for (long long i = 0; i < length; i++) {
+        if (hashlife_set(board, x, y + i, 1) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Places the starting pattern on a board through its run callback.
+ *
+ * The pattern is the --pattern file if one was given, otherwise the
+ * program's own patterns; either is shifted by --offset.
+ *
+ * @param rule Set to the rule to run: --rule if given, else the rule
+ *             named by the file, else B3/S23.
+ * @param verbose Print how the file was loaded, or why it was not.
+ * @return int 0 on success, -1 on failure (the reason is printed if
+ *         verbose is set).
+ */
+static int place_start(const struct life_program *program, const struct options *options,
+                       life_load_run run, void *board, struct life_ruleset *rule, int verbose) {
+    *rule = options->rule;
+    if (options->pattern_file == NULL) {
+        for (int p = 0; p < program->pattern_count; p++) {
+            const struct life_pattern *pattern = &program->patterns[p];
+            for (int i = 0; i < pattern->size; i++) {
+                if (run(board, options->offset_x + pattern->start_x + pattern->cells[i][0],
+                        options->offset_y + pattern->start_y + pattern->cells[i][1], 1) != 0) {
+                    if (verbose) {
+                        fprintf(stderr, "Out of memory\n");
+                    }
+                    return -1;
+                }
+            }
+        }
+        return 0;
+    }
+
+    struct life_load_info info;
+    double start = life_clock_seconds();
+    if (life_load_file(options->pattern_file, LIFE_FORMAT_AUTO, options->offset_x, options->offset_y,
+                       run, board, &info) != 0) {
+        if (!verbose) {
+            return -1;
+        }
+        if (info.error_line > 0) {
+            fprintf(stderr, "Cannot load %s: error on line %ld\n", options->pattern_file, info.error_line);
+        } else {
+            fprintf(stderr, "Cannot load %s\n", options->pattern_file);
+        }
+        return -1;
+    }
+    if (verbose) {
+        fprintf(stderr, "Loaded %lld cells from %s in %.3f s\n",
+                info.cells, options->pattern_file, life_clock_seconds() - start);
+    }
+    if (info.has_rule && !options->has_rule) {
+        *rule = info.rule;
+    }
+    return 0;
+}
+
+/**
+ * @brief Saves a checkpoint if the board just passed a multiple of --checkpoint-every.
+ *
+ * A failed save is reported and the run goes on.
+ *
+ * @param before Generation before the last step.
+ * @param after Generation the board is at now.
+ */
+static void checkpoint(const struct life_program *program, const struct options *options,
+                       const struct life_grid *grid, long long before, long long after) {
+    long long every = options->checkpoint_every;
+    if (every == 0 || before / every == after / every) {
+        return;
+    }
+    char name[256];
+    const char *path = options->checkpoint_file;
+    if (path == NULL) {
+        snprintf(name, sizeof(name), "%s.ckpt", program->name);
+        path = name;
+    }
+    if (life_checkpoint_save(grid, after, path) != 0) {
+        fprintf(stderr, "Cannot write checkpoint %s\n", path);
+    }
+}
+
+/**
+ * @brief Starts recording if --record was given; the board is the first frame.
+ *
+ * @param generation Generation the board is at.
+ * @param recorder Output, NULL without --record.
+ * @return int 0 on success, -1 if the file cannot be created (the
+ *             reason is printed).
+ */
+static int open_record(const struct options *options, const struct life_grid *grid, long long generation,
+                       struct life_recorder **recorder) {
+    *recorder = NULL;
+    if (options->record_file == NULL) {
+        return 0;
+    }
+    struct life_record_options record = { options->record_file, grid->width, grid->height,
+                                          options->record_scale, options->record_every };
+    *recorder = life_recorder_open(&record);
+    if (*recorder == NULL) {
+        fprintf(stderr, "Cannot record to %s\n", options->record_file);
+        return -1;
+    }
+    life_recorder_submit(*recorder, grid, generation);
+    return 0;
+}
+
+/**
+ * @brief Hands the board to the recorder if it just passed a multiple of --record-every.
+ *
+ * @param recorder The recorder, or NULL.
+ * @param before Generation before the last step.
+ * @param after Generation the board is at now.
+ */
+static void record(const struct options *options, struct life_recorder *recorder,
+                   const struct life_grid *grid, long long before, long long after) {
+    long long every = options->record_every;
+    if (recorder == NULL || before / every == after / every) {
+        return;
+    }
+    life_recorder_submit(recorder, grid, after);
+}
+
+/**
+ * @brief Finishes the recording, if any, and prints how many frames it holds.
+ */
+static void close_record(const struct options *options, struct life_recorder *recorder) {
+    if (recorder == NULL) {
+        return;
+    }
+    struct life_record_totals totals;
+    if (life_recorder_close(recorder, &totals) != 0) {
+        fprintf(stderr, "Cannot write %s\n", options->record_file);
+    }
+    fprintf(stderr, "Recorded %lld frames to %s (%lld dropped)\n", totals.written, options->record_file,
+            totals.dropped);
+}
+
+/**
+ * @brief Statistics of a run on the fixed board (--stats, --stats-file).
+ *
+ * While enabled is 0 nothing here is touched: no clock is read and the
+ * step kernels run without their statistics code.
+ */
+struct run_stats {
+    int enabled;                        // --stats or --stats-file was given
+    long long every;                    // Generations between two stats lines, 0 for none
+    const char *path;                   // --stats-file
+    struct life_stats_stream stream;    // One record per generation, if open
+    struct life_timers timers;          // Time spent in each phase
+    struct life_timers line_timers;     // timers when the last line was made
+    long long line_generation;          // Generation of the last line
+    char line[LIFE_RENDER_STATUS_MAX];  // Latest stats line, empty before the first
+};
+
+/**
+ * @brief Turns on the statistics asked for on the command line.
+ *
+ * @param generation Generation the board starts at.
+ * @return int 0 on success, -1 on failure (the reason is printed).
+ */
+static int open_stats(const struct options *options, struct life_grid *grid, long long generation,
+                      struct run_stats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->enabled = options->stats_every != 0 || options->stats_file != NULL;
+    if (!stats->enabled) {
+        return 0;
+    }
+    if (life_grid_track_stats(grid, 1) != 0) {
+        fprintf(stderr, "Out of memory\n");
+        return -1;
+    }
+    stats->every = options->stats_every;
+    stats->path = options->stats_file;
+    if (stats->path != NULL && life_stats_open(&stats->stream, stats->path) != 0) {
+        fprintf(stderr, "Cannot open %s\n", stats->path);
+        return -1;
+    }
+    stats->line_generation = generation;
+    life_timers_start(&stats->timers);
+    stats->line_timers = stats->timers;
+    return 0;
+}
+
+static void close_stats(struct run_stats *stats) {
+    if (life_stats_close(&stats->stream) != 0) {
+        fprintf(stderr, "Cannot write %s\n", stats->path);
+    }
+}
+
+/**
+ * @brief Charges the time since the last lap to a phase, if statistics are on.
+ */
+static void lap(struct run_stats *stats, enum life_phase phase) {
+    if (stats->enabled) {
+        life_timers_lap(&stats->timers, phase);
+    }
+}
+
+/**
+ * @brief Remakes the stats line if the board just passed a multiple of --stats.
+ *
+ * @param board Statistics of the board, or NULL to compute them.
+ * @param generation Generation the board is at.
+ * @return int 1 if the line was remade, 0 otherwise.
+ */
+static int update_line(struct run_stats *stats, const struct life_grid *grid,
+                       const struct life_grid_stats *board, long long generation) {
+    if (stats->every == 0 || stats->line_generation / stats->every == generation / stats->every) {
+        return 0;
+    }
+    struct life_grid_stats computed;
+    if (board == NULL) {
+        life_grid_stats(grid, &computed);
+        board = &computed;
+    }
+    life_stats_format_line(stats->line, sizeof(stats->line), board, &stats->timers, &stats->line_timers,
+                           generation - stats->line_generation);
+    stats->line_timers = stats->timers;
+    stats->line_generation = generation;
+    return 1;
+}
+
+/**
+ * @brief Advances the board n generations and updates the statistics.
+ *
+ * Goes through the cycle tracker if one is given. With a stream open
+ * the board is advanced one generation at a time, so that every
+ * generation gets its record.
+ *
+ * @param cycle The board's cycle tracker, or NULL.
+ * @param generation Generation the board is at.
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int advance(struct run_stats *stats, struct life_grid *grid, struct life_cycle *cycle,
+                   long long generation, long long n) {
+    if (stats->stream.file == NULL) {
+        int status = cycle != NULL ? life_cycle_advance(cycle, grid, n) : life_grid_step_n(grid, n);
+        if (stats->enabled && status == 0) {
+            life_timers_lap(&stats->timers, LIFE_PHASE_STEP);
+            update_line(stats, grid, NULL, generation + n);
+            life_timers_lap(&stats->timers, LIFE_PHASE_OTHER);
+        }
+        return status;
+    }
+
+    for (long long i = 1; i <= n; i++) {
+        int status = cycle != NULL ? life_cycle_advance(cycle, grid, 1) : life_grid_step_n(grid, 1);
+        if (status != 0) {
+            return -1;
+        }
+        life_timers_lap(&stats->timers, LIFE_PHASE_STEP);
+        struct life_grid_stats board;
+        life_grid_stats(grid, &board);
+        update_line(stats, grid, &board, generation + i);
+        if (life_stats_write(&stats->stream, generation + i, &board, &stats->timers) != 0) {
+            fprintf(stderr, "Cannot write %s\n", stats->path);
+            life_stats_close(&stats->stream);
+            return advance(stats, grid, cycle, generation + i, n - i);
+        }
+        life_timers_lap(&stats->timers, LIFE_PHASE_OTHER);
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes the name of a kernel for the --bench report, with the
+ * instruction set the simd kernel runs on (e.g. "simd/avx2").
+ */
+static void kernel_label(enum life_kernel kernel, char *text, size_t size) {
+    if (kernel == LIFE_KERNEL_SIMD) {
+        snprintf(text, size, "%s/%s", life_kernel_name(kernel), life_simd_isa());
+    } else {
+        snprintf(text, size, "%s", life_kernel_name(kernel));
+    }
+}
+
+/**
+ * @brief Prints the result of a --bench run and appends it to the CSV file.
+ *
+ * @param program The program that was run.
+ * @param options The options of the run.
+ * @param engine Name of the engine or kernel that was measured.
+ * @param seconds Time spent stepping.
+ * @param cell_updates Number of cells computed over all generations.
+ * @param skip_ratio Fraction of the board that was skipped.
+ * @param population Live cells after the last generation.
+ * @return int 0 on success, 1 if the CSV file cannot be written.
+ */
+static int report_bench(const struct life_program *program, const struct options *options,
+                        const char *engine, double seconds, double cell_updates,
+                        double skip_ratio, long long population) {
+    double rate = options->generations / seconds;
+    double updates = cell_updates / seconds;
+    double ns_per_cell = seconds * 1e9 / cell_updates;
+
+    printf("%s: %d x %d, %s, %d thread(s), %lld generations in %.3f s\n",
+           program->name, options->width, options->height, engine, options->threads,
+           options->generations, seconds);
+    printf("  %.1f generations/s, %.3g cell-updates/s, %.4f ns/cell, %.1f%% skipped, population %lld\n",
+           rate, updates, ns_per_cell, 100.0 * skip_ratio, population);
+
+    if (options->bench_csv == NULL) {
+        return 0;
+    }
+    FILE *csv = fopen(options->bench_csv, "a");
+    if (csv == NULL) {
+        fprintf(stderr, "Cannot open %s\n", options->bench_csv);
+        return 1;
+    }
+    if (ftell(csv) == 0) {
+        fprintf(csv, "program,engine,width,height,threads,generations,seconds,"
+                     "generations_per_s,cell_updates_per_s,ns_per_cell,skip_ratio,population\n");
+    }
+    fprintf(csv, "%s,%s,%d,%d,%d,%lld,%.6f,%.3f,%.6g,%.6f,%.4f,%lld\n",
+            program->name, engine, options->width, options->height, options->threads,
+            options->generations, seconds, rate, updates, ns_per_cell, skip_ratio, population);
+    fclose(csv);
+    return 0;
+}
+
+/**
+ * @brief Appends a stats line, if there is one, to a status line.
+ */
+static void append_stats(char *status, size_t size, const char *line) {
+    if (line[0] == '\0') {
+        return;
+    }
+    size_t length = strlen(status);
+    for (const char *separator = "  "; *separator != '\0' && length + 1 < size; separator++) {
+        status[length++] = *separator;
+    }
+    for (; *line != '\0' && length + 1 < size; line++) {
+        status[length++] = *line;
+    }
+    status[length] = '\0';
+}
+
+/**
+ * @brief Appends the timing statistics of a pacer to a status line.
+ */
+static void append_pace(char *status, size_t size, const struct life_pacer *pacer) {
+    char pace[LIFE_RENDER_STATUS_MAX];
+    life_pacer_format(pacer, pace, sizeof(pace));
+    append_stats(status, size, pace);
+}
+
+/**
+ * @brief Steps the board --generations times without rendering.
+ *
+ * Every cell of the board counts as updated in every generation,
+ * including the tiles the engine skips, so ns/cell is comparable
+ * across kernels and patterns. With --checkpoint-every the run is
+ * stepped in chunks that end on checkpoint generations, and with
+ * --stats in chunks that end on stats lines, which are printed to
+ * stderr. With --record the chunks also end on recorded generations.
+ * The time spent saving, writing statistics and handing frames to the
+ * recorder is not counted.
+ *
+ * @param recorder The recorder, or NULL.
+ * @param generation Generation the board starts at.
+ * @return int Exit status for main().
+ */
+static int run_bench(struct life_grid *grid, const struct life_program *program, const struct options *options,
+                     struct run_stats *stats, struct life_recorder *recorder, long long generation) {
+    double seconds = 0.0;
+    long long every = options->checkpoint_every;
+    for (long long done = 0; done < options->generations;) {
+        long long chunk = options->generations - done;
+        if (every != 0 && chunk > every - generation % every) {
+            chunk = every - generation % every;
+        }
+        if (stats->every != 0 && chunk > stats->every - generation % stats->every) {
+            chunk = stats->every - generation % stats->every;
+        }
+        if (recorder != NULL && chunk > options->record_every - generation % options->record_every) {
+            chunk = options->record_every - generation % options->record_every;
+        }
+        double start = life_clock_seconds();
+        double step_start = stats->timers.seconds[LIFE_PHASE_STEP];
+        if (advance(stats, grid, NULL, generation, chunk) != 0) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        seconds += stats->enabled ? stats->timers.seconds[LIFE_PHASE_STEP] - step_start : life_clock_seconds() - start;
+        if (stats->every != 0 && stats->line_generation == generation + chunk) {
+            fprintf(stderr, "Generation: %lld  %s\n", generation + chunk, stats->line);
+        }
+        record(options, recorder, grid, generation, generation + chunk);
+        checkpoint(program, options, grid, generation, generation + chunk);
+        generation += chunk;
+        done += chunk;
+    }
+
+    double cells = (double)grid->width * (double)grid->height;
+    char engine[64];
+    kernel_label(grid->kernel, engine, sizeof(engine));
+    return report_bench(program, options, engine, seconds,
+                        cells * (double)options->generations,
+                        life_grid_skip_ratio(grid), life_grid_population(grid));
+}
+
+/**
+ * @brief One frame handed from the simulation thread to the display.
+ */
+struct view_frame {
+    long long generation;   // Generation shown in the frame
+    int words;              // 64-bit words per row
+    uint64_t *rows;         // Visible window, bit-packed like a life_grid row
+    char stats[LIFE_RENDER_STATUS_MAX];  // Stats line of the simulation, if any
+};
+
+/**
+ * @brief State shared by the simulation thread and the display loop.
+ */
+struct async_sim {
+    const struct life_program *program;
+    const struct options *options;
+    struct life_grid *grid;         // Board being simulated, or NULL
+    struct life_sparse *plane;      // Unbounded plane being simulated, or NULL
+    struct run_stats *stats;        // Statistics of the simulation thread
+    struct life_recorder *recorder; // Recorder of the board, or NULL
+    int rows;                       // Rows of the visible window
+    long long first_generation;     // Generation the board starts at
+    struct view_frame slots[3];
+    struct life_triple frames;      // Latest completed generation
+    atomic_llong generation;        // Generations completed so far
+    atomic_int stop;                // Set by the display to end the thread
+    atomic_int failed;              // Set by the thread when memory runs out
+};
+
+static int frame_cell(const void *board, long long x, long long y) {
+    const struct view_frame *frame = board;
+    return (int)((frame->rows[x * frame->words + y / 64] >> (y % 64)) & 1);
+}
+
+/**
+ * @brief Copies the visible window into the back slot and publishes it.
+ */
+static void publish_frame(struct async_sim *sim, long long generation) {
+    struct view_frame *frame = life_triple_back(&sim->frames);
+    frame->generation = generation;
+    if (sim->grid != NULL) {
+        for (int x = 0; x < sim->rows; x++) {
+            memcpy(frame->rows + (size_t)x * frame->words, sim->grid->cells + (size_t)x * sim->grid->words,
+                   (size_t)frame->words * sizeof(uint64_t));
+        }
+    } else {
+        life_sparse_read_rows(sim->plane, 0, 0, sim->rows, frame->words, frame->rows);
+    }
+    if (sim->stats->enabled) {
+        memcpy(frame->stats, sim->stats->line, sizeof(frame->stats));
+    }
+    life_triple_publish(&sim->frames);
+}
+
+/**
+ * @brief Simulation thread: steps as fast as possible and publishes
+ * every completed generation to the triple buffer.
+ */
+static void *simulate(void *arg) {
+    struct async_sim *sim = arg;
+    long long step = sim->options->step;
+    long long generation = sim->first_generation;
+
+    while (!atomic_load_explicit(&sim->stop, memory_order_relaxed)) {
+        publish_frame(sim, generation);
+        lap(sim->stats, LIFE_PHASE_COPY);
+        int status = sim->grid != NULL ? advance(sim->stats, sim->grid, NULL, generation, step)
+                                       : life_sparse_step_n(sim->plane, step);
+        if (status != 0) {
+            atomic_store(&sim->failed, 1);
+            break;
+        }
+        if (sim->grid != NULL) {
+            record(sim->options, sim->recorder, sim->grid, generation, generation + step);
+            lap(sim->stats, LIFE_PHASE_COPY);
+            checkpoint(sim->program, sim->options, sim->grid, generation, generation + step);
+            lap(sim->stats, LIFE_PHASE_OTHER);
+        }
+        generation += step;
+        atomic_store_explicit(&sim->generation, generation, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Runs the simulation and the display at independent rates.
+ *
+ * The board (or the plane) is stepped on its own thread at full
+ * speed, while this thread draws the latest completed generation
+ * --fps times per second. The status line shows both rates, and
+ * the stats line of the simulation thread if there is one.
+ *
+ * @param stats Statistics of the board, disabled for a plane.
+ * @param recorder Recorder of the board, or NULL.
+ * @param generation Generation the board starts at.
+ * @return int 1 if memory runs out (the loop never ends otherwise).
+ */
+static int run_async(const struct life_program *program, const struct options *options,
+                     struct life_grid *grid, struct life_sparse *plane, struct run_stats *stats,
+                     struct life_recorder *recorder, long long first_generation) {
+    struct async_sim sim = { .program = program, .options = options, .grid = grid, .plane = plane,
+                             .stats = stats, .recorder = recorder, .first_generation = first_generation };
+    struct life_render *view = create_view(program, options);
+    if (view == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    int cols = options->width < VIEW_MAX_WIDTH ? options->width : VIEW_MAX_WIDTH;
+    sim.rows = options->height < VIEW_MAX_HEIGHT ? options->height : VIEW_MAX_HEIGHT;
+    int words = (cols + 63) / 64;
+    uint64_t *storage = calloc((size_t)3 * sim.rows * words, sizeof(uint64_t));
+    if (storage == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        life_render_free(view);
+        return 1;
+    }
+    for (int i = 0; i < 3; i++) {
+        sim.slots[i].words = words;
+        sim.slots[i].rows = storage + (size_t)i * sim.rows * words;
+    }
+    life_triple_init(&sim.frames, &sim.slots[0], &sim.slots[1], &sim.slots[2]);
+    atomic_init(&sim.generation, first_generation);
+    atomic_init(&sim.stop, 0);
+    atomic_init(&sim.failed, 0);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, simulate, &sim) != 0) {
+        fprintf(stderr, "Cannot start the simulation thread\n");
+        free(storage);
+        life_render_free(view);
+        return 1;
+    }
+
+    // Rates are measured over windows of about one second
+    double window_start = life_clock_seconds();
+    long long window_generation = first_generation;
+    int window_frames = 0;
+    double sim_rate = 0.0, display_rate = 0.0;
+    struct life_pacer pacer;
+    life_pacer_start(&pacer, 1000000000LL / options->fps);
+
+    while (!atomic_load(&sim.failed)) {
+        const struct view_frame *frame = life_triple_read(&sim.frames, NULL);
+
+        double now = life_clock_seconds();
+        if (now - window_start >= 1.0) {
+            long long generation = atomic_load_explicit(&sim.generation, memory_order_relaxed);
+            sim_rate = (double)(generation - window_generation) / (now - window_start);
+            display_rate = window_frames / (now - window_start);
+            window_start = now;
+            window_generation = generation;
+            window_frames = 0;
+        }
+
+        char status[LIFE_RENDER_STATUS_MAX];
+        snprintf(status, sizeof(status), "Generation: %lld  Simulation: %.0f gen/s  Display: %.1f fps",
+                 frame->generation, sim_rate, display_rate);
+        append_pace(status, sizeof(status), &pacer);
+        append_stats(status, sizeof(status), frame->stats);
+        life_render_frame(view, frame_cell, frame, status);
+        window_frames++;
+
+        life_pacer_wait(&pacer); // Display pacing
+    }
+
+    atomic_store(&sim.stop, 1);
+    pthread_join(thread, NULL);
+    fprintf(stderr, "Out of memory\n");
+    free(storage);
+    life_render_free(view);
+    return 1;
+}
+
+/**
+ * @brief Advances the board to generation --jump and prints it.
+ *
+ * The board is stepped until it repeats itself; the rest of the way
+ * is skipped, so even very distant generations of an oscillator are
+ * printed at once. Prints the board-sized window, the population and
+ * the period if one was found.
+ *
+ * @param generation Generation the board starts at.
+ * @return int 0 on success, 1 on failure.
+ */
+static int run_jump(struct life_grid *grid, const struct life_program *program, const struct options *options,
+                    long long generation) {
+    if (options->jump_target < generation) {
+        fprintf(stderr, "The board is already at generation %lld\n", generation);
+        return 1;
+    }
+    struct life_cycle cycle;
+    life_cycle_init(&cycle, grid, generation);
+    int status = life_cycle_advance(&cycle, grid, options->jump_target - generation);
+    if (status != 0) {
+        fprintf(stderr, "Out of memory\n");
+        life_cycle_release(&cycle);
+        return 1;
+    }
+
+    for (int i = 0; i < options->height && i < VIEW_MAX_HEIGHT; i++) {
+        for (int j = 0; j < options->width && j < VIEW_MAX_WIDTH; j++) {
+            fputs(life_grid_get(grid, i, j) ? program->alive_glyph : program->dead_glyph, stdout);
+        }
+        printf("\n");
+    }
+    printf("Generation: %lld\n", cycle.generation);
+    printf("Population: %lld\n", life_grid_population(grid));
+    if (life_cycle_period(&cycle) != 0) {
+        printf("Period: %lld (repeating since generation %lld)\n", life_cycle_period(&cycle), cycle.start);
+    } else {
+        printf("Period: none found\n");
+    }
+    life_cycle_release(&cycle);
+    return 0;
+}
+
+/**
+ * @brief Fast-forwards the program's patterns on an unbounded plane.
+ *
+ * Prints the board-sized window at the origin, followed by the
+ * population and the HashLife node and cache counters.
+ *
+ * @return int 0 on success, 1 on failure.
+ */
+static int run_hashlife(const struct life_program *program, const struct options *options) {
+    struct hashlife *hl = hashlife_create(options->hashlife_memory << 20);
+    struct life_ruleset rule;
+    if (hl != NULL && place_start(program, options, hashlife_run, hl, &rule, 1) != 0) {
+        hashlife_free(hl);
+        return 1;
+    }
+    if (hl != NULL) {
+        hashlife_set_rule(hl, &rule);
+    }
+    if (hl == NULL || hashlife_advance(hl, options->hashlife_target) != 0) {
+        fprintf(stderr, "HashLife ran out of memory\n");
+        hashlife_free(hl);
+        return 1;
+    }
+
+    for (int i = 0; i < options->height && i < VIEW_MAX_HEIGHT; i++) {
+        for (int j = 0; j < options->width && j < VIEW_MAX_WIDTH; j++) {
+            fputs(hashlife_get(hl, i, j) ? program->alive_glyph : program->dead_glyph, stdout);
+        }
+        printf("\n");
+    }
+
+    struct hashlife_stats stats;
+    hashlife_get_stats(hl, &stats);
+    unsigned long long lookups = stats.hits + stats.misses;
+    printf("Generation: %llu\n", (unsigned long long)hashlife_generation(hl));
+    printf("Population: %llu\n", (unsigned long long)hashlife_population(hl));
+    printf("Nodes: %zu (%zu KB)\n", stats.nodes, stats.bytes / 1024);
+    printf("Cache hit rate: %.1f%% (%llu of %llu lookups), evictions: %llu\n",
+           lookups ? 100.0 * stats.hits / lookups : 0.0,
+           (unsigned long long)stats.hits, lookups, (unsigned long long)stats.collections);
+
+    hashlife_free(hl);
+    return 0;
+}
+
+/**
+ * @brief Runs a census of random soups and prints the frequency table.
+ *
+ * The program's board and patterns are not used; every soup is a
+ * random square on an unbounded plane, run under --rule.
+ *
+ * @return int 0 on success, 1 on failure.
+ */
+static int run_census(const struct options *options) {
+    struct life_census_options census_options = {
+        options->census_soups, options->seed, options->soup_size, SOUP_GENERATIONS, options->rule
+    };
+    struct life_pool *pool = options->threads > 1 ? life_pool_create(options->threads) : NULL;
+    struct life_census census;
+    int status = life_census_run(&census_options, pool, &census);
+    life_pool_free(pool);
+    if (status != 0) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    char rule[LIFE_RULE_TEXT_MAX];
+    life_rule_format(&options->rule, rule, sizeof(rule));
+    printf("%-24s %12s %8s\n", "Object", "Count", "Share");
+    for (size_t i = 0; i < census.entry_count; i++) {
+        const struct life_census_entry *entry = &census.entries[i];
+        printf("%-24s %12lld %7.3f%%\n", entry->name, entry->count,
+               100.0 * (double)entry->count / (double)census.objects);
+    }
+    printf("%lld soups of %dx%d (%s), %lld objects, %lld unsettled\n",
+           census.soups, options->soup_size, options->soup_size, rule, census.objects, census.unsettled);
+    printf("%.3f s, %.1f soups/s on %d thread(s)\n",
+           census.seconds, (double)census.soups / census.seconds, options->threads);
+    life_census_release(&census);
+    return 0;
+}
+
+/**
+ * @brief The --ensemble boards, run one at a time on the bit-packed board.
+ */
+struct single_runs {
+    const struct life_program *program;
+    const struct options *options;
+    const struct life_ensemble_board *boards;
+    long long *populations;     // Output, one per board
+    atomic_int failed;
+};
+
+/**
+ * @brief Pool task: runs every count-th board, starting at index, each
+ * one on its own, so the threads share the boards as the ensemble's do.
+ */
+static void run_single_boards(void *arg, int index, int count) {
+    struct single_runs *runs = arg;
+    const struct options *options = runs->options;
+    struct life_grid *grid = life_grid_create(options->width, options->height, runs->program->edges);
+    if (grid == NULL) {
+        atomic_store(&runs->failed, 1);
+        return;
+    }
+    grid->kernel = options->kernel;
+    grid->rule = options->rule;
+    for (long long i = index; i < options->ensemble_boards; i += count) {
+        life_grid_clear(grid);
+        const struct life_pattern *soup = runs->boards[i].patterns;
+        life_grid_place_pattern(grid, soup->cells, soup->size, soup->start_x, soup->start_y);
+        if (life_grid_step_n(grid, options->generations) != 0) {
+            atomic_store(&runs->failed, 1);
+            break;
+        }
+        runs->populations[i] = life_grid_population(grid);
+    }
+    life_grid_free(grid);
+}
+
+/**
+ * @brief Runs --ensemble random soups on the program's board.
+ *
+ * Every board starts from its own soup, a square of --soup-size cells
+ * (clipped to the board) in the middle of the board, seeded from --seed
+ * and the board's number. The program's patterns are not used. The
+ * boards are run for --generations generations with
+ * life_ensemble_run_batch(), 64 at a time, and then again one at a
+ * time with --kernel. With --threads, the threads share the boards in
+ * both runs. Both runs are reported as --bench would report them, and
+ * their populations must match.
+ *
+ * @return int 0 on success, 1 on failure.
+ */
+static int run_ensemble(const struct life_program *program, const struct options *options) {
+    const long long count = options->ensemble_boards;
+    const int rows = options->soup_size < options->height ? options->soup_size : options->height;
+    const int columns = options->soup_size < options->width ? options->soup_size : options->width;
+    int (*cells)[2] = malloc((size_t)count * (size_t)rows * (size_t)columns * sizeof(*cells));
+    struct life_pattern *soups = malloc((size_t)count * sizeof(*soups));
+    struct life_ensemble_board *boards = malloc((size_t)count * sizeof(*boards));
+    long long *populations = malloc(2 * (size_t)count * sizeof(*populations));
+    struct life_pool *pool = options->threads > 1 ? life_pool_create(options->threads) : NULL;
+    int status = cells == NULL || soups == NULL || boards == NULL || populations == NULL ? -1 : 0;
+
+    size_t used = 0;
+    for (long long i = 0; i < count && status == 0; i++) {
+        uint64_t state = options->seed + (uint64_t)i * 0xD1B54A32D192ED03ULL;
+        soups[i].cells = (const int (*)[2])(cells + used);
+        soups[i].start_x = (options->height - rows) / 2;
+        soups[i].start_y = (options->width - columns) / 2;
+        soups[i].size = 0;
+        for (int x = 0; x < rows; x++) {
+            for (int y = 0; y < columns; y++) {
+                if (life_splitmix64(&state) % 100 < ENSEMBLE_DENSITY) {
+                    cells[used][0] = x;
+                    cells[used][1] = y;
+                    used++;
+                    soups[i].size++;
+                }
+            }
+        }
+        boards[i].patterns = &soups[i];
+        boards[i].pattern_count = 1;
+    }
+
+    double ensemble_seconds = 0.0, single_seconds = 0.0;
+    if (status == 0) {
+        double start = life_clock_seconds();
+        status = life_ensemble_run_batch(options->width, options->height, program->edges, &options->rule,
+                                         boards, (size_t)count, options->generations, pool, populations);
+        ensemble_seconds = life_clock_seconds() - start;
+    }
+    if (status == 0) {
+        double start = life_clock_seconds();
+        struct single_runs runs = { program, options, boards, populations + count, 0 };
+        atomic_init(&runs.failed, 0);
+        if (pool != NULL) {
+            life_pool_run(pool, run_single_boards, &runs);
+        } else {
+            run_single_boards(&runs, 0, 1);
+        }
+        status = atomic_load(&runs.failed) ? -1 : 0;
+        single_seconds = life_clock_seconds() - start;
+    }
+    if (status != 0) {
+        fprintf(stderr, "Out of memory\n");
+    }
+
+    long long mismatch = -1, empty = 0, lowest = LLONG_MAX, highest = 0;
+    double total = 0.0;
+    for (long long i = 0; i < count && status == 0; i++) {
+        if (populations[i] != populations[count + i] && mismatch < 0) {
+            mismatch = i;
+        }
+        empty += populations[i] == 0;
+        lowest = populations[i] < lowest ? populations[i] : lowest;
+        highest = populations[i] > highest ? populations[i] : highest;
+        total += (double)populations[i];
+    }
+
+    int result = 1;
+    if (status == 0) {
+        double updates = (double)count * options->width * options->height * (double)options->generations;
+        char kernel[32], engine[64];
+        kernel_label(options->kernel, kernel, sizeof(kernel));
+        snprintf(engine, sizeof(engine), "%s/one at a time", kernel);
+        result = report_bench(program, options, "ensemble", ensemble_seconds, updates, 0.0, (long long)total) |
+                 report_bench(program, options, engine, single_seconds, updates, 0.0, (long long)total);
+        printf("%lld soups of %dx%d: population min %lld, mean %.1f, max %lld, %lld died out\n",
+               count, rows, columns, lowest, total / (double)count, highest, empty);
+        if (mismatch >= 0) {
+            fprintf(stderr, "Soup %lld: population %lld in the ensemble, %lld one at a time\n",
+                    mismatch, populations[mismatch], populations[count + mismatch]);
+            result = 1;
+        } else {
+            printf("Populations match; the ensemble is %.1fx faster\n", single_seconds / ensemble_seconds);
+        }
+    }
+
+    life_pool_free(pool);
+    free(cells);
+    free(soups);
+    free(boards);
+    free(populations);
+    return result;
+}
+
+/**
+ * @brief Runs --conform boards through every kernel and thread count.
+ *
+ * Boards get a random rule half of the time unless --rule is given.
+ * If a run differs from the reference, the shrunk run is printed, its
+ * first generation as a plaintext pattern that --pattern can load.
+ *
+ * @return int 0 if every run matched, 1 otherwise.
+ */
+static int run_conform(const struct options *options) {
+    struct life_conform_options conform_options = {
+        options->conform_boards, options->seed, !options->has_rule, options->rule
+    };
+    struct life_conform_result result;
+    double start = life_clock_seconds();
+    if (life_conform_run(&conform_options, &result) != 0) {
+        life_conform_release(&result);
+        fprintf(stderr, "Out of memory, or cannot create a temporary file for the mapped board\n");
+        return 1;
+    }
+    if (!result.failed) {
+        printf("%lld boards, %lld runs (%d kernels, instruction sets and engines, 1-%d threads) match the reference"
+               " in %.3f s\n", result.boards, result.runs, result.variants, LIFE_CONFORM_THREADS,
+               life_clock_seconds() - start);
+        return 0;
+    }
+
+    const struct life_conform_case *failure = &result.failure;
+    char rule[LIFE_RULE_TEXT_MAX];
+    life_rule_format(&failure->rule, rule, sizeof(rule));
+    printf("!Name: conform-seed-%llu-board-%lld\n", (unsigned long long)options->seed, result.board);
+    char engine[64];
+    life_conform_label(failure, engine, sizeof(engine));
+    printf("!Engine %s, %d thread(s), statistics %s, %lld generation(s) per step\n",
+           engine, failure->threads, failure->stats ? "on" : "off", failure->chunk);
+    printf("!Board %d x %d, %s, %s: %s differ from the reference at generation %lld\n",
+           failure->width, failure->height, failure->edges == LIFE_EDGES_WRAP ? "torus" : "clipped", rule,
+           result.what, result.generation);
+    for (int x = 0; x < failure->height; x++) {
+        for (int y = 0; y < failure->width; y++) {
+            putchar(failure->cells[(size_t)x * failure->width + y] ? 'O' : '.');
+        }
+        putchar('\n');
+    }
+    life_conform_release(&result);
+    return 1;
+}
+
+/**
+ * @brief Simulates the program's patterns on an unbounded sparse plane.
+ *
+ * The board size only sets the window that is printed, starting at
+ * row 0, column 0; patterns may leave it and keep evolving.
+ *
+ * @return int 1 if memory runs out (the loop never ends otherwise).
+ */
+static int run_unbounded(const struct life_program *program, const struct options *options) {
+    struct life_sparse *plane = life_sparse_create();
+    if (plane == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    struct life_ruleset rule;
+    if (place_start(program, options, sparse_run, plane, &rule, 1) != 0) {
+        life_sparse_free(plane);
+        return 1;
+    }
+    life_sparse_set_rule(plane, &rule);
+    int ok = 1;
+
+    if (options->bench) {
+        // Count the cells of every allocated tile as updated
+        double cell_updates = 0;
+        double start = life_clock_seconds();
+        for (long long g = 0; ok && g < options->generations; g++) {
+            cell_updates += (double)life_sparse_tiles(plane) * LIFE_SPARSE_TILE * LIFE_SPARSE_TILE;
+            ok = life_sparse_step_n(plane, 1) == 0;
+        }
+        double seconds = life_clock_seconds() - start;
+        int status = ok ? report_bench(program, options, "sparse", seconds, cell_updates, 0.0,
+                                       life_sparse_population(plane)) : 1;
+        if (!ok) {
+            fprintf(stderr, "Out of memory\n");
+        }
+        life_sparse_free(plane);
+        return status;
+    }
+
+    if (options->async) {
+        struct run_stats stats = { 0 };
+        int status = run_async(program, options, NULL, plane, &stats, NULL, 0);
+        life_sparse_free(plane);
+        return status;
+    }
+
+    struct life_render *view = create_view(program, options);
+    ok = view != NULL;
+    struct life_pacer pacer;
+    life_pacer_start(&pacer, tick_period(program, options));
+    while (ok) {
+        if (life_pacer_frame(&pacer)) {
+            char status[LIFE_RENDER_STATUS_MAX];
+            snprintf(status, sizeof(status), "Generation: %lld  Population: %lld  Tiles: %zu",
+                     life_sparse_generation(plane), life_sparse_population(plane), life_sparse_tiles(plane));
+            append_pace(status, sizeof(status), &pacer);
+            life_render_frame(view, sparse_cell, plane, status);
+        }
+
+        ok = life_sparse_step_n(plane, options->step) == 0;
+
+        life_pacer_wait(&pacer); // Visualization pacing
+    }
+
+    life_render_free(view);
+    fprintf(stderr, "Out of memory\n");
+    life_sparse_free(plane);
+    return 1;
+}
+
+/**
+ * @brief What a worker of run_domain() needs to place its part of the
+ * starting pattern.
+ */
+struct domain_start {
+    const struct life_program *program;
+    const struct options *options;
+};
+
+/**
+ * @brief One worker's band, as seen by band_run().
+ */
+struct band_board {
+    struct life_grid *band;
+    long long first_row;    // Row of the whole board held in band row 1
+    long long rows;         // Rows in the band, halo rows excluded
+};
+
+static int band_run(void *board, long long x, long long y, long long length) {
+    struct band_board *band = board;
+    if (x >= band->first_row && x < band->first_row + band->rows) {
+        life_grid_set_run(band->band, x - band->first_row + 1, y, length);
+    }
+    return 0;
+}
+
+/**
+ * @brief Fills one worker's band: every worker reads the whole starting
+ * pattern and keeps the runs that fall in its rows. Only the first one
+ * reports on the file.
+ */
+static int fill_band(void *arg, struct life_grid *band, int first_row, int rows) {
+    const struct domain_start *start = arg;
+    struct band_board board = { band, first_row, rows };
+    return place_start(start->program, start->options, band_run, &board, &band->rule, first_row == 0);
+}
+
+/**
+ * @brief Runs the fixed board split into bands of rows, one per worker
+ * process (--processes).
+ *
+ * Each worker only holds its own band, and the display only the
+ * visible window, which is read back from the workers for each frame.
+ *
+ * @return int Exit status for main(); the display loop only ends if a
+ *         worker runs out of memory.
+ */
+static int run_domain(const struct life_program *program, const struct options *options) {
+    int rows = options->height < VIEW_MAX_HEIGHT ? options->height : VIEW_MAX_HEIGHT;
+    int cols = options->width < VIEW_MAX_WIDTH ? options->width : VIEW_MAX_WIDTH;
+    int words = (cols + 63) / 64;
+    struct life_domain_options domain_options = {
+        options->width, options->height, program->edges, options->processes,
+        options->threads, options->kernel, rows, words
+    };
+    struct domain_start start = { program, options };
+    struct life_domain *domain = life_domain_create(&domain_options, fill_band, &start);
+    if (domain == NULL) {
+        fprintf(stderr, "Cannot run a %d x %d board in %d processes\n",
+                options->width, options->height, options->processes);
+        return 1;
+    }
+
+    if (options->bench) {
+        double begin = life_clock_seconds();
+        int ok = life_domain_step_n(domain, options->generations) == 0;
+        double seconds = life_clock_seconds() - begin;
+        int status = 1;
+        if (ok) {
+            char kernel[32], engine[64];
+            kernel_label(options->kernel, kernel, sizeof(kernel));
+            snprintf(engine, sizeof(engine), "%s/%d processes", kernel, options->processes);
+            double cells = (double)options->width * (double)options->height;
+            status = report_bench(program, options, engine, seconds, cells * (double)options->generations,
+                                  life_domain_skip_ratio(domain), life_domain_population(domain));
+        } else {
+            fprintf(stderr, "Out of memory\n");
+        }
+        life_domain_free(domain);
+        return status;
+    }
+
+    struct view_frame frame = { 0, words, malloc((size_t)rows * (size_t)words * sizeof(uint64_t)), "" };
+    struct life_render *view = create_view(program, options);
+    int ok = frame.rows != NULL && view != NULL;
+    if (!ok) {
+        fprintf(stderr, "Out of memory\n");
+    }
+    struct life_pacer pacer;
+    life_pacer_start(&pacer, tick_period(program, options));
+    for (long long generation = 0; ok; generation += options->step) {
+        if (life_pacer_frame(&pacer)) {
+            char status[LIFE_RENDER_STATUS_MAX];
+            snprintf(status, sizeof(status), "Generation: %lld  Processes: %d", generation, options->processes);
+            append_pace(status, sizeof(status), &pacer);
+            life_domain_read_rows(domain, 0, rows, words, frame.rows);
+            life_render_frame(view, frame_cell, &frame, status);
+        }
+
+        ok = life_domain_step_n(domain, options->step) == 0;
+        if (!ok) {
+            fprintf(stderr, "Out of memory\n");
+        }
+
+        life_pacer_wait(&pacer); // Visualization pacing
+    }
+
+    life_render_free(view);
+    free(frame.rows);
+    life_domain_free(domain);
+    return 1;
+}
+
+static int mapped_run(void *board, long long x, long long y, long long length) {
+    life_mapped_set_run(board, x, y, length);
+    return 0;
+}
+
+/**
+ * @brief Runs the fixed board out of core, in the --mapped file.
+ *
+ * An existing file is continued, with its own size, edges, rule
+ * (unless --rule is given) and generation. Otherwise the file is
+ * created with the board size and the starting pattern.
+ *
+ * @return int Exit status for main(); the display loop only ends if
+ *         memory runs out.
+ */
+static int run_mapped(const struct life_program *program, const struct options *options) {
+    struct options sized = *options;
+    struct life_mapped *board = life_mapped_open(options->mapped_file);
+    if (board != NULL) {
+        if (options->has_rule) {
+            board->rule = options->rule;
+        }
+    } else {
+        board = life_mapped_create(options->mapped_file, options->width, options->height, program->edges);
+        if (board == NULL) {
+            fprintf(stderr, "Cannot open or create %s\n", options->mapped_file);
+            return 1;
+        }
+        if (place_start(program, options, mapped_run, board, &board->rule, 1) != 0) {
+            life_mapped_close(board);
+            return 1;
+        }
+    }
+    sized.width = board->width;
+    sized.height = board->height;
+    board->kernel = options->kernel;
+    board->pool = options->threads > 1 ? life_pool_create(options->threads) : NULL;
+    int status = 1;
+
+    if (options->bench) {
+        double start = life_clock_seconds();
+        int ok = life_mapped_step_n(board, options->generations) == 0;
+        double seconds = life_clock_seconds() - start;
+        if (ok) {
+            char kernel[32], engine[64];
+            kernel_label(options->kernel, kernel, sizeof(kernel));
+            snprintf(engine, sizeof(engine), "%s/mapped", kernel);
+            double cells = (double)board->width * (double)board->height;
+            status = report_bench(program, &sized, engine, seconds, cells * (double)options->generations,
+                                  0.0, life_mapped_population(board));
+        } else {
+            fprintf(stderr, "Out of memory\n");
+        }
+    } else {
+        int rows = board->height < VIEW_MAX_HEIGHT ? board->height : VIEW_MAX_HEIGHT;
+        int words = ((board->width < VIEW_MAX_WIDTH ? board->width : VIEW_MAX_WIDTH) + 63) / 64;
+        struct view_frame frame = { 0, words, malloc((size_t)rows * (size_t)words * sizeof(uint64_t)), "" };
+        struct life_render *view = create_view(program, &sized);
+        int ok = frame.rows != NULL && view != NULL;
+        struct life_pacer pacer;
+        life_pacer_start(&pacer, tick_period(program, options));
+        while (ok) {
+            if (life_pacer_frame(&pacer)) {
+                char line[LIFE_RENDER_STATUS_MAX];
+                snprintf(line, sizeof(line), "Generation: %lld  File: %s", board->generation, options->mapped_file);
+                append_pace(line, sizeof(line), &pacer);
+                life_mapped_read_rows(board, 0, rows, words, frame.rows);
+                life_render_frame(view, frame_cell, &frame, line);
+            }
+
+            ok = life_mapped_step_n(board, options->step) == 0;
+
+            life_pacer_wait(&pacer); // Visualization pacing
+        }
+        fprintf(stderr, "Out of memory\n");
+        life_render_free(view);
+        free(frame.rows);
+    }
+
+    life_pool_free(board->pool);
+    if (life_mapped_close(board) != 0) {
+        fprintf(stderr, "Cannot write %s\n", options->mapped_file);
+        status = 1;
+    }
+    return status;
+}
+
+int life_main(const struct life_program *program, int argc, char *argv[]) {
+    struct options options;
+    int parsed = parse_options(program, argc, argv, &options);
+    if (parsed != 0) {
+        print_usage(program, parsed > 0 ? stdout : stderr);
+        return parsed > 0 ? 0 : 1;
+    }
+
+    if ((options.use_hashlife || options.unbounded) &&
+        (options.checkpoint_every != 0 || options.resume_file != NULL)) {
+        fprintf(stderr, "Checkpoints are only supported on the fixed board\n");
+        return 1;
+    }
+    if ((options.use_hashlife || options.unbounded) && options.use_jump) {
+        fprintf(stderr, "--jump is only supported on the fixed board\n");
+        return 1;
+    }
+    if ((options.use_hashlife || options.unbounded || options.use_jump) &&
+        (options.stats_every != 0 || options.stats_file != NULL)) {
+        fprintf(stderr, "Statistics are only supported while the fixed board runs\n");
+        return 1;
+    }
+    if (options.processes != 0 &&
+        (options.use_hashlife || options.unbounded || options.census_soups != 0 || options.ensemble_boards != 0 || options.async ||
+         options.use_jump || options.checkpoint_every != 0 || options.resume_file != NULL ||
+         options.stats_every != 0 || options.stats_file != NULL)) {
+        fprintf(stderr, "--processes only runs the fixed board, interactively or with --bench\n");
+        return 1;
+    }
+    if (options.mapped_file != NULL &&
+        (options.use_hashlife || options.unbounded || options.census_soups != 0 || options.ensemble_boards != 0 || options.async ||
+         options.use_jump || options.checkpoint_every != 0 || options.resume_file != NULL ||
+         options.stats_every != 0 || options.stats_file != NULL || options.processes != 0)) {
+        fprintf(stderr, "--mapped only runs the fixed board, interactively or with --bench\n");
+        return 1;
+    }
+    if (options.record_file != NULL &&
+        (options.use_hashlife || options.unbounded || options.census_soups != 0 || options.ensemble_boards != 0 || options.use_jump ||
+         options.processes != 0 || options.mapped_file != NULL)) {
+        fprintf(stderr, "--record only records the fixed board in memory\n");
+        return 1;
+    }
+    if (options.processes > options.height) {
+        fprintf(stderr, "--processes cannot exceed the number of rows\n");
+        return 1;
+    }
+    if (options.conform_boards != 0) {
+        return run_conform(&options);
+    }
+    if (options.census_soups != 0) {
+        return run_census(&options);
+    }
+    if (options.ensemble_boards != 0) {
+        return run_ensemble(program, &options);
+    }
+    if (options.use_hashlife) {
+        return run_hashlife(program, &options);
+    }
+    if (options.unbounded) {
+        return run_unbounded(program, &options);
+    }
+    if (options.processes != 0) {
+        return run_domain(program, &options);
+    }
+    if (options.mapped_file != NULL) {
+        return run_mapped(program, &options);
+    }
+
+    struct life_grid *grid;
+    long long first_generation = 0;
+    if (options.resume_file != NULL) {
+        // The board size and edges come from the checkpoint
+        grid = life_checkpoint_load(options.resume_file, &first_generation);
+        if (grid == NULL) {
+            fprintf(stderr, "Cannot resume from %s\n", options.resume_file);
+            return 1;
+        }
+        options.width = grid->width;
+        options.height = grid->height;
+        if (options.has_rule) {
+            grid->rule = options.rule;
+        }
+    } else {
+        grid = life_grid_create(options.width, options.height, program->edges);
+        if (grid == NULL) {
+            fprintf(stderr, "Cannot allocate a %d x %d board\n", options.width, options.height);
+            return 1;
+        }
+        if (place_start(program, &options, grid_run, grid, &grid->rule, 1) != 0) {
+            life_grid_free(grid);
+            return 1;
+        }
+    }
+    grid->kernel = options.kernel;
+    grid->pool = options.threads > 1 ? life_pool_create(options.threads) : NULL;
+
+    if (options.use_jump) {
+        int status = run_jump(grid, program, &options, first_generation);
+        life_pool_free(grid->pool);
+        life_grid_free(grid);
+        return status;
+    }
+
+    struct run_stats stats;
+    struct life_recorder *recorder = NULL;
+    if (open_stats(&options, grid, first_generation, &stats) != 0 ||
+        open_record(&options, grid, first_generation, &recorder) != 0) {
+        close_stats(&stats);
+        life_pool_free(grid->pool);
+        life_grid_free(grid);
+        return 1;
+    }
+
+    if (options.bench) {
+        int status = run_bench(grid, program, &options, &stats, recorder, first_generation);
+        close_record(&options, recorder);
+        close_stats(&stats);
+        life_pool_free(grid->pool);
+        life_grid_free(grid);
+        return status;
+    }
+
+    if (options.async) {
+        int status = run_async(program, &options, grid, NULL, &stats, recorder, first_generation);
+        close_record(&options, recorder);
+        close_stats(&stats);
+        life_pool_free(grid->pool);
+        life_grid_free(grid);
+        return status;
+    }
+
+    struct life_render *view = create_view(program, &options);
+    if (view == NULL) {
+        fprintf(stderr, "Out of memory\n");
+    }
+    struct life_cycle cycle;
+    life_cycle_init(&cycle, grid, first_generation);
+
+    /**
+     * @section Main Simulation Loop
+     * The loop performs the following steps:
+     *  1. Redraw the cells that changed since the last frame.
+     *  2. Compute the next generation(s) according to the Game of Life rules.
+     *     Once the board repeats itself, they are taken from the cycle
+     *     instead, and without --speed the tick period is at least
+     *     CYCLE_DELAY.
+     *  3. Hand the board to the recorder and save a checkpoint if either is due.
+     *  4. Wait for the next tick of the pacer. Ticks lie on a fixed grid of
+     *     deadlines (the program's delay, or --speed), so the time spent in
+     *     steps 1-3 does not add up; while the loop is behind, frames are
+     *     left out rather than slowing the generations down.
+     * With --stats or --stats-file the time of each step is charged to
+     * its phase, and the stats line is added to the status line.
+     */
+    struct life_pacer pacer;
+    life_pacer_start(&pacer, tick_period(program, &options));
+    for (long long generation = first_generation; view != NULL; generation += options.step) {
+        long long period = life_cycle_period(&cycle);
+        if (life_pacer_frame(&pacer)) {
+            char status[LIFE_RENDER_STATUS_MAX];
+            if (period != 0) {
+                snprintf(status, sizeof(status), "Generation: %lld  Period: %lld (since generation %lld)",
+                         generation, period, cycle.start);
+            } else {
+                snprintf(status, sizeof(status), "Generation: %lld", generation);
+            }
+            append_pace(status, sizeof(status), &pacer);
+            append_stats(status, sizeof(status), stats.line);
+            life_render_frame(view, grid_cell, grid, status);
+        }
+        lap(&stats, LIFE_PHASE_RENDER);
+
+        if (advance(&stats, grid, &cycle, generation, options.step) != 0) {
+            fprintf(stderr, "Out of memory\n");
+            break;
+        }
+        record(&options, recorder, grid, generation, generation + options.step);
+        lap(&stats, LIFE_PHASE_COPY);
+        checkpoint(program, &options, grid, generation, generation + options.step);
+        lap(&stats, LIFE_PHASE_OTHER);
+
+        if (period != 0 && options.speed == 0 && pacer.period < CYCLE_DELAY * NS_PER_MS) {
+            life_pacer_set_period(&pacer, CYCLE_DELAY * NS_PER_MS);
+        }
+        life_pacer_wait(&pacer); // Visualization pacing
+        lap(&stats, LIFE_PHASE_SLEEP);
+    }
+
+    close_record(&options, recorder);
+    close_stats(&stats);
+    life_cycle_release(&cycle);
+    life_render_free(view);
+    life_pool_free(grid->pool);
+    life_grid_free(grid);
+    return 1;
+}
@@ -0,0 +1,98 @@
+/*******************************************************************
+ * Conway's Game of Life - Shared Program Driver
+ *
+ * Author: hrosicka
+ * Description:
+ *   Everything the game-of-life-*.c programs have in common: command
+ *   line options, board creation, pattern placement, printing and the
+ *   main simulation loop. A program only describes its board and its
+ *   patterns in a struct life_program and hands it to life_main().
+ *
+ * Options:
+ *   --width N, --height N   Board size (default: the program's own)
+ *   --threads N             Threads used to compute each generation
+ *   --kernel NAME           Step kernel: packed (default), lut, simd or
+ *                           blocked
+ *   --isa NAME              Instruction set of the simd kernel (default
+ *                           the widest the CPU supports)
+ *   --rule RULE             Life-like rule, e.g. B36/S23 (default B3/S23
+ *                           or the rule of the --pattern file)
+ *   --step N                Generations computed between frames
+ *   --hashlife N            Jump to generation N on an unbounded plane
+ *                           with HashLife, print it and exit
+ *   --unbounded             Simulate on an unbounded sparse plane;
+ *                           the board size only sets the view
+ *   --async                 Simulate at full speed on its own thread
+ *                           and display the latest generation
+ *   --fps N                 Display rate for --async
+ *   --speed N               Generations per second of the interactive
+ *                           loop, paced against the monotonic clock
+ *   --bench                 Step without rendering and report
+ *                           generations/s, cell-updates/s and ns/cell
+ *   --generations N         Generations computed by --bench
+ *   --bench-csv FILE        Also append the --bench results to FILE
+ *   --hashlife-memory MB    Memory cap of the HashLife engine
+ *   --pattern FILE          Start from an RLE, Life 1.06 or plaintext
+ *                           file instead of the program's patterns
+ *   --offset ROW,COL        Shift the starting pattern
+ *   --checkpoint-every N    Save the board every N generations
+ *   --checkpoint FILE       Checkpoint file (default: NAME.ckpt)
+ *   --resume FILE           Continue from a checkpoint
+ *   --jump N                Print generation N, skipping the rest once
+ *                           the board repeats itself, and exit
+ *   --census N              Run N random soups until they settle,
+ *                           print a table of the objects left and exit
+ *   --ensemble N            Run N random soups 64 at a time, then one
+ *                           at a time, compare and report both
+ *   --seed N                Seed of the --census or --ensemble soups or
+ *                           the --conform boards (default 1)
+ *   --soup-size N           Side of each --census or --ensemble soup
+ *                           (default 16)
+ *   --conform N             Check every kernel against the scalar
+ *                           reference on N random boards and exit
+ *   --stats N               Show live cells, births, deaths, bounding
+ *                           box and time per phase every N generations
+ *   --stats-file FILE       Write the statistics of every generation to
+ *                           FILE (CSV, or JSON lines for .json/.jsonl)
+ *   --processes N           Split the board into N bands of rows, each
+ *                           run by its own worker process
+ *   --mapped FILE           Keep the board in a memory-mapped file,
+ *                           created if missing, continued otherwise
+ *   --record FILE           Record the run on a background thread, as an
+ *                           animated GIF (.gif) or a delta frame stream
+ *   --record-every N        Generations between recorded frames
+ *   --record-scale N        Board cells per recorded pixel
+ *   --help, -h              Print the options and exit
+ *******************************************************************/
+
+#ifndef LIFE_APP_H
+#define LIFE_APP_H
+
+#include "grid.h"
+
+/**
+ * @brief Description of one simulation program.
+ */
+struct life_program {
+    const char *name;                    // Program name for the usage text
+    int width;                           // Default number of columns
+    int height;                          // Default number of rows
+    enum life_edges edges;               // Edge mode of the board
+    int delay;                           // Delay in milliseconds per generation
+    const char *alive_glyph;             // Printed for a live cell
+    const char *dead_glyph;              // Printed for a dead cell
+    const struct life_pattern *patterns; // Initial patterns
+    int pattern_count;
+};
+
+/**
+ * @brief Runs a program: parses options, sets up the board and simulates.
+ *
+ * @param program The program description.
+ * @param argc Argument count from main().
+ * @param argv Arguments from main().
+ * @return int Exit status for main().
+ */
+int life_main(const struct life_program *program, int argc, char *argv[]);
+
+#endif // LIFE_APP_H
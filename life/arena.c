@@ -0,0 +1,54 @@
+/*******************************************************************
+ * Conway's Game of Life - Aligned Arena Allocator
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the arena declared in arena.h, backed by an
+ *   anonymous memory mapping (zero-filled on first touch).
+ *******************************************************************/
+
+#include <sys/mman.h>
+
+#include "arena.h"
+
+size_t life_arena_block_size(size_t size) {
+    return (size + LIFE_ARENA_ALIGN - 1) & ~(size_t)(LIFE_ARENA_ALIGN - 1);
+}
+
+int life_arena_init(struct life_arena *arena, size_t size) {
+    arena->base = NULL;
+    arena->size = 0;
+    arena->used = 0;
+    if (size == 0) {
+        return -1;
+    }
+
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        return -1;
+    }
+    arena->base = base;
+    arena->size = size;
+    return 0;
+}
+
+void *life_arena_alloc(struct life_arena *arena, size_t size) {
+    size_t block = life_arena_block_size(size);
+    if (block > arena->size - arena->used) {
+        return NULL;
+    }
+    // The mapping is page aligned, so every block is cache-line aligned
+    void *p = arena->base + arena->used;
+    arena->used += block;
+    return p;
+}
+
+void life_arena_release(struct life_arena *arena) {
+    if (arena->base != NULL) {
+        munmap(arena->base, arena->size);
+    }
+    arena->base = NULL;
+    arena->size = 0;
+    arena->used = 0;
+}
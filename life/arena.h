@@ -0,0 +1,61 @@
+/*******************************************************************
+ * Conway's Game of Life - Aligned Arena Allocator
+ *
+ * Author: hrosicka
+ * Description:
+ *   Hands out cache-line aligned, zero-filled blocks from a single
+ *   memory mapping that is released all at once. Boards sized at
+ *   run time take every buffer they need from one arena, so a board
+ *   is one mapping no matter how many buffers it uses.
+ *
+ *   The mapping is reserved lazily by the operating system: pages
+ *   that are never touched (for example the empty parts of a huge
+ *   board) cost no physical memory.
+ *******************************************************************/
+
+#ifndef LIFE_ARENA_H
+#define LIFE_ARENA_H
+
+#include <stddef.h>
+
+#define LIFE_ARENA_ALIGN 64   // Alignment of every block (one cache line)
+
+struct life_arena {
+    unsigned char *base;   // Start of the mapping
+    size_t size;           // Bytes mapped
+    size_t used;           // Bytes handed out so far
+};
+
+/**
+ * @brief Returns the space a block takes in an arena, padding included.
+ *
+ * Sum this over all blocks to size an arena.
+ */
+size_t life_arena_block_size(size_t size);
+
+/**
+ * @brief Maps an arena able to hold size bytes.
+ *
+ * @param arena The arena to initialize.
+ * @param size Capacity in bytes (see life_arena_block_size()).
+ * @return int 0 on success, -1 if the memory could not be mapped.
+ */
+int life_arena_init(struct life_arena *arena, size_t size);
+
+/**
+ * @brief Takes a zero-filled, LIFE_ARENA_ALIGN-aligned block.
+ *
+ * @param arena The arena.
+ * @param size Block size in bytes.
+ * @return void* The block, or NULL if the arena is full.
+ */
+void *life_arena_alloc(struct life_arena *arena, size_t size);
+
+/**
+ * @brief Releases every block of the arena at once.
+ *
+ * @param arena The arena (its fields are reset).
+ */
+void life_arena_release(struct life_arena *arena);
+
+#endif // LIFE_ARENA_H
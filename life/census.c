@@ -0,0 +1,782 @@
+/*******************************************************************
+ * Conway's Game of Life - Random Soup Census
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the census declared in census.h.
+ *******************************************************************/
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "census.h"
+#include "clock.h"
+#include "grid.h"
+#include "random.h"
+#include "sparse.h"
+
+#define SETTLE_GENERATIONS 64   // Least number of generations the population must repeat
+#define OBJECT_RADIUS 2         // Live cells this close belong to the same object
+#define CLASSIFY_SIZE 128       // Side of the board an object is run on alone
+#define CLASSIFY_MARGIN 32      // Room left around it for ships to move
+#define MAX_OBJECT_SIDE (CLASSIFY_SIZE - 2 * CLASSIFY_MARGIN)
+#define CODE_UNSTABLE 1         // Object that does not repeat on its own
+#define CODE_OVERSIZED 2        // Object wider or taller than MAX_OBJECT_SIDE
+#define CODE_FLAG (1ULL << 63)  // Set in every hash code, so it never equals the two above
+#define MIN_TABLE 256           // Initial slots of a hash table
+
+struct cell {
+    long long x;
+    long long y;
+};
+
+/**
+ * @brief A well-known object, drawn with 'o' for live cells.
+ */
+struct known_object {
+    const char *name;
+    const char *rows[13];
+};
+
+static const struct known_object known_objects[] = {
+    { "block", { "oo", "oo" } },
+    { "beehive", { ".oo.", "o..o", ".oo." } },
+    { "loaf", { ".oo.", "o..o", ".o.o", "..o." } },
+    { "boat", { "oo.", "o.o", ".o." } },
+    { "ship", { "oo.", "o.o", ".oo" } },
+    { "tub", { ".o.", "o.o", ".o." } },
+    { "pond", { ".oo.", "o..o", "o..o", ".oo." } },
+    { "long boat", { "oo..", "o.o.", ".o.o", "..o." } },
+    { "barge", { ".o..", "o.o.", ".o.o", "..o." } },
+    { "mango", { ".oo..", "o..o.", ".o..o", "..oo." } },
+    { "eater", { "oo..", "o.o.", "..o.", "..oo" } },
+    { "aircraft carrier", { "oo..", "o..o", "..oo" } },
+    { "blinker", { "ooo" } },
+    { "toad", { ".ooo", "ooo." } },
+    { "beacon", { "oo..", "oo..", "..oo", "..oo" } },
+    { "pentadecathlon", { "..o....o..", "oo.oooo.oo", "..o....o.." } },
+    { "pulsar", { "..ooo...ooo..", ".............", "o....o.o....o", "o....o.o....o",
+                  "o....o.o....o", "..ooo...ooo..", ".............", "..ooo...ooo..",
+                  "o....o.o....o", "o....o.o....o", "o....o.o....o", ".............",
+                  "..ooo...ooo.." } },
+    { "glider", { ".o.", "..o", "ooo" } },
+    { "LWSS", { ".o..o", "o....", "o...o", "oooo." } },
+    { "MWSS", { "...o..", ".o...o", "o.....", "o....o", "ooooo." } },
+    { "HWSS", { "...oo..", ".o....o", "o......", "o.....o", "oooooo." } },
+};
+
+#define KNOWN_COUNT (sizeof(known_objects) / sizeof(known_objects[0]))
+
+/**
+ * @brief Open-addressing hash table of census entries keyed by a
+ * 64-bit hash (0 marks a free slot).
+ */
+struct table {
+    uint64_t *keys;
+    struct life_census_entry *values;
+    size_t capacity;
+    size_t used;
+};
+
+/**
+ * @brief State of one thread.
+ *
+ * range is read by the other threads when they steal; it sits on its
+ * own cache line.
+ */
+struct worker {
+    _Alignas(64) _Atomic uint64_t range;  // Soups left: first << 32 | end
+    struct life_grid *grid;               // Board objects are run on
+    struct cell *cells;                   // Live cells of a settled soup
+    size_t cell_capacity;
+    size_t *parent;                       // Union-find forest over cells
+    size_t *next_cell;                    // Next cell of the same object
+    struct cell *phase;                   // Cells of one phase of an object
+    struct cell *first;                   // Cells of the first phase
+    struct cell *scratch;                 // Transformed copy of a phase
+    struct table memo;                    // Class of every shape seen, by shape hash
+    struct table tally;                   // Objects found, by code
+    long long soups;
+    long long objects;
+    long long unsettled;
+    int failed;
+};
+
+/**
+ * @brief A census shared by its threads.
+ */
+struct census_run {
+    const struct life_census_options *options;
+    struct worker *workers;
+    int threads;
+};
+
+static void table_release(struct table *table) {
+    free(table->keys);
+    free(table->values);
+    memset(table, 0, sizeof(*table));
+}
+
+static int table_resize(struct table *table, size_t capacity) {
+    uint64_t *keys = calloc(capacity, sizeof(*keys));
+    struct life_census_entry *values = malloc(capacity * sizeof(*values));
+    if (keys == NULL || values == NULL) {
+        free(keys);
+        free(values);
+        return -1;
+    }
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->keys[i] == 0) {
+            continue;
+        }
+        size_t slot = (size_t)table->keys[i] & (capacity - 1);
+        while (keys[slot] != 0) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        keys[slot] = table->keys[i];
+        values[slot] = table->values[i];
+    }
+    free(table->keys);
+    free(table->values);
+    table->keys = keys;
+    table->values = values;
+    table->capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Returns the entry of a key, or NULL if there is none.
+ */
+static struct life_census_entry *table_find(const struct table *table, uint64_t key) {
+    if (table->capacity == 0) {
+        return NULL;
+    }
+    for (size_t slot = (size_t)key & (table->capacity - 1); table->keys[slot] != 0;
+         slot = (slot + 1) & (table->capacity - 1)) {
+        if (table->keys[slot] == key) {
+            return &table->values[slot];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns the entry of a key, adding a zeroed one if needed.
+ *
+ * @return struct life_census_entry* The entry, or NULL if out of memory.
+ */
+static struct life_census_entry *table_insert(struct table *table, uint64_t key) {
+    struct life_census_entry *entry = table_find(table, key);
+    if (entry != NULL) {
+        return entry;
+    }
+    if (2 * (table->used + 1) > table->capacity &&
+        table_resize(table, table->capacity == 0 ? MIN_TABLE : 2 * table->capacity) != 0) {
+        return NULL;
+    }
+    size_t slot = (size_t)key & (table->capacity - 1);
+    while (table->keys[slot] != 0) {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    table->keys[slot] = key;
+    table->used++;
+    memset(&table->values[slot], 0, sizeof(table->values[slot]));
+    return &table->values[slot];
+}
+
+static int compare_cells(const void *a, const void *b) {
+    const struct cell *p = a, *q = b;
+    if (p->x != q->x) {
+        return p->x < q->x ? -1 : 1;
+    }
+    return p->y < q->y ? -1 : p->y > q->y;
+}
+
+/**
+ * @brief Moves the cells so that the smallest row and column are 0.
+ */
+static void normalize(struct cell *cells, size_t count) {
+    long long min_x = cells[0].x, min_y = cells[0].y;
+    for (size_t i = 1; i < count; i++) {
+        min_x = cells[i].x < min_x ? cells[i].x : min_x;
+        min_y = cells[i].y < min_y ? cells[i].y : min_y;
+    }
+    for (size_t i = 0; i < count; i++) {
+        cells[i].x -= min_x;
+        cells[i].y -= min_y;
+    }
+}
+
+/**
+ * @brief Hashes a normalized, sorted list of cells.
+ */
+static uint64_t hash_cells(const struct cell *cells, size_t count) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < count; i++) {
+        hash = (hash ^ (uint64_t)cells[i].x) * 0x100000001b3ULL;
+        hash = (hash ^ (uint64_t)cells[i].y) * 0x100000001b3ULL;
+    }
+    uint64_t state = hash;
+    return life_splitmix64(&state) | CODE_FLAG;
+}
+
+/**
+ * @brief Smallest hash of a shape over its eight rotations and reflections.
+ */
+static uint64_t orientation_hash(const struct cell *cells, size_t count, struct cell *scratch) {
+    uint64_t best = UINT64_MAX;
+    for (int t = 0; t < 8; t++) {
+        for (size_t i = 0; i < count; i++) {
+            long long x = (t & 1) ? -cells[i].x : cells[i].x;
+            long long y = (t & 2) ? -cells[i].y : cells[i].y;
+            scratch[i].x = (t & 4) ? y : x;
+            scratch[i].y = (t & 4) ? x : y;
+        }
+        normalize(scratch, count);
+        qsort(scratch, count, sizeof(*scratch), compare_cells);
+        uint64_t hash = hash_cells(scratch, count);
+        best = hash < best ? hash : best;
+    }
+    return best;
+}
+
+/**
+ * @brief Lists the live cells of the classification board, sorted.
+ *
+ * @return size_t Number of cells.
+ */
+static size_t read_board(const struct life_grid *grid, struct cell *cells) {
+    size_t count = 0;
+    for (int x = 0; x < grid->height; x++) {
+        const uint64_t *row = grid->cells + (size_t)x * grid->words;
+        for (int w = 0; w < grid->words; w++) {
+            for (uint64_t word = row[w]; word != 0; word &= word - 1) {
+                cells[count].x = x;
+                cells[count].y = (long long)w * 64 + __builtin_ctzll(word);
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Tells whether a phase came within one cell of the board edge,
+ * where the clipped edge would change its evolution.
+ */
+static int near_edge(const struct cell *cells, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (cells[i].x < 2 || cells[i].y < 2 ||
+            cells[i].x >= CLASSIFY_SIZE - 2 || cells[i].y >= CLASSIFY_SIZE - 2) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs an object alone and finds its code, period and motion.
+ *
+ * @param worker The thread's buffers; its grid holds the object's rule.
+ * @param object Cells of the object, normalized and sorted.
+ * @param count Number of cells.
+ * @param result Filled in with code, period, moving and cells.
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int run_object(struct worker *worker, const struct cell *object, size_t count,
+                       struct life_census_entry *result) {
+    struct life_grid *grid = worker->grid;
+    life_grid_clear(grid);
+    for (size_t i = 0; i < count; i++) {
+        life_grid_set(grid, (int)object[i].x + CLASSIFY_MARGIN, (int)object[i].y + CLASSIFY_MARGIN, 1);
+    }
+    memcpy(worker->first, object, count * sizeof(*object));
+
+    result->code = orientation_hash(object, count, worker->scratch);
+    result->cells = (int)count;
+    for (int g = 1; g <= LIFE_CENSUS_MAX_PERIOD; g++) {
+        if (life_grid_step(grid) != 0) {
+            return -1;
+        }
+        size_t phase = read_board(grid, worker->phase);
+        if (phase == 0 || near_edge(worker->phase, phase)) {
+            break;
+        }
+        long long origin_x = worker->phase[0].x;
+        long long origin_y = LLONG_MAX;
+        for (size_t i = 0; i < phase; i++) {
+            origin_y = worker->phase[i].y < origin_y ? worker->phase[i].y : origin_y;
+        }
+        for (size_t i = 0; i < phase; i++) {
+            worker->phase[i].x -= origin_x;
+            worker->phase[i].y -= origin_y;
+        }
+        if (phase == count && memcmp(worker->phase, worker->first, count * sizeof(*object)) == 0) {
+            result->period = g;
+            result->moving = origin_x != CLASSIFY_MARGIN || origin_y != CLASSIFY_MARGIN;
+            return 0;
+        }
+        uint64_t hash = orientation_hash(worker->phase, phase, worker->scratch);
+        if (hash < result->code) {
+            result->code = hash;
+            result->cells = (int)phase;
+        }
+    }
+    result->code = CODE_UNSTABLE;
+    result->cells = 0;
+    return 0;
+}
+
+/**
+ * @brief Identifies one object and adds it to the thread's tally.
+ *
+ * @param fits 0 if the object is already known to be oversized.
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int tally_object(struct worker *worker, struct cell *object, size_t count, int fits) {
+    normalize(object, count);
+    struct life_census_entry found = { .code = CODE_OVERSIZED };
+    for (size_t i = 0; i < count; i++) {
+        if (object[i].x >= MAX_OBJECT_SIDE || object[i].y >= MAX_OBJECT_SIDE) {
+            fits = 0;
+        }
+    }
+    if (fits) {
+        // The same shape turns up over and over; run it only once
+        uint64_t shape = hash_cells(object, count);
+        struct life_census_entry *memo = table_find(&worker->memo, shape);
+        if (memo == NULL) {
+            if (run_object(worker, object, count, &found) != 0) {
+                return -1;
+            }
+            memo = table_insert(&worker->memo, shape);
+            if (memo == NULL) {
+                return -1;
+            }
+            *memo = found;
+        }
+        found = *memo;
+    }
+
+    struct life_census_entry *entry = table_insert(&worker->tally, found.code);
+    if (entry == NULL) {
+        return -1;
+    }
+    if (entry->count == 0) {
+        *entry = found;
+    }
+    entry->count++;
+    worker->objects++;
+    return 0;
+}
+
+static size_t find_root(size_t *parent, size_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+/**
+ * @brief Makes room for count cells in the thread's soup buffers.
+ */
+static int reserve_cells(struct worker *worker, size_t count) {
+    if (count <= worker->cell_capacity) {
+        return 0;
+    }
+    size_t capacity = worker->cell_capacity * 2 > count ? worker->cell_capacity * 2 : count;
+    struct cell *cells = realloc(worker->cells, capacity * sizeof(*cells));
+    if (cells != NULL) {
+        worker->cells = cells;
+    }
+    size_t *parent = realloc(worker->parent, capacity * sizeof(*parent));
+    if (parent != NULL) {
+        worker->parent = parent;
+    }
+    size_t *next_cell = realloc(worker->next_cell, capacity * sizeof(*next_cell));
+    if (next_cell != NULL) {
+        worker->next_cell = next_cell;
+    }
+    if (cells == NULL || parent == NULL || next_cell == NULL) {
+        return -1;
+    }
+    worker->cell_capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Splits the live cells of a settled soup into objects and tallies them.
+ */
+static int split_objects(struct worker *worker, const struct life_sparse *plane) {
+    size_t count = life_sparse_list_cells(plane, NULL, 0);
+    if (count == 0) {
+        return 0;
+    }
+    if (reserve_cells(worker, count) != 0) {
+        return -1;
+    }
+    life_sparse_list_cells(plane, (long long (*)[2])worker->cells, count);
+    struct cell *cells = worker->cells;
+    size_t *parent = worker->parent, *next_cell = worker->next_cell;
+    qsort(cells, count, sizeof(*cells), compare_cells);
+
+    for (size_t i = 0; i < count; i++) {
+        parent[i] = i;
+    }
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count && cells[j].x - cells[i].x <= OBJECT_RADIUS; j++) {
+            long long dy = cells[j].y - cells[i].y;
+            if (dy >= -OBJECT_RADIUS && dy <= OBJECT_RADIUS) {
+                size_t a = find_root(parent, i), b = find_root(parent, j);
+                parent[a > b ? a : b] = a < b ? a : b;
+            }
+        }
+    }
+
+    // Chain the cells of each object in order; the root is its first cell
+    for (size_t i = 0; i < count; i++) {
+        next_cell[i] = SIZE_MAX;
+    }
+    for (size_t i = count; i-- > 0;) {
+        size_t root = find_root(parent, i);
+        if (root != i) {
+            next_cell[i] = next_cell[root];
+            next_cell[root] = i;
+        }
+    }
+    for (size_t root = 0; root < count; root++) {
+        if (parent[root] != root) {
+            continue;
+        }
+        // More cells than a MAX_OBJECT_SIDE square holds cannot fit in one
+        size_t size = 0, limit = (size_t)MAX_OBJECT_SIDE * MAX_OBJECT_SIDE;
+        int fits = 1;
+        for (size_t i = root; i != SIZE_MAX; i = next_cell[i]) {
+            if (size == limit) {
+                fits = 0;
+                break;
+            }
+            worker->phase[size++] = cells[i];
+        }
+        if (tally_object(worker, worker->phase, size, fits) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs soup number index until it settles and tallies its objects.
+ */
+static int run_soup(struct worker *worker, const struct life_census_options *options, long long index) {
+    struct life_sparse *plane = life_sparse_create();
+    if (plane == NULL) {
+        return -1;
+    }
+    life_sparse_set_rule(plane, &options->rule);
+
+    struct life_xoshiro rng;
+    life_xoshiro_seed(&rng, options->seed + (uint64_t)index * 0xD1B54A32D192ED03ULL);
+    for (int x = 0; x < options->soup_size; x++) {
+        for (int y = 0; y < options->soup_size; y += 64) {
+            uint64_t bits = life_xoshiro_next(&rng);
+            for (int b = 0; b < 64 && y + b < options->soup_size; b++) {
+                if (((bits >> b) & 1) && life_sparse_set(plane, x, y + b, 1) != 0) {
+                    life_sparse_free(plane);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // run[p]: generations in a row whose population equals the one p earlier
+    long long history[LIFE_CENSUS_MAX_PERIOD + 1];
+    int run[LIFE_CENSUS_MAX_PERIOD + 1] = { 0 };
+    history[0] = life_sparse_population(plane);
+    int settled = 0;
+    for (long long g = 1; g <= options->max_generations && !settled; g++) {
+        if (life_sparse_step_n(plane, 1) != 0) {
+            life_sparse_free(plane);
+            return -1;
+        }
+        long long population = life_sparse_population(plane);
+        for (int p = 1; p <= LIFE_CENSUS_MAX_PERIOD && p <= g; p++) {
+            run[p] = population == history[(g - p) % (LIFE_CENSUS_MAX_PERIOD + 1)] ? run[p] + 1 : 0;
+            if (run[p] >= SETTLE_GENERATIONS && run[p] >= 2 * p) {
+                settled = 1;
+            }
+        }
+        history[g % (LIFE_CENSUS_MAX_PERIOD + 1)] = population;
+    }
+
+    int status = 0;
+    if (settled) {
+        status = split_objects(worker, plane);
+    } else {
+        worker->unsettled++;
+    }
+    worker->soups++;
+    life_sparse_free(plane);
+    return status;
+}
+
+static uint64_t pack_range(uint32_t first, uint32_t end) {
+    return (uint64_t)first << 32 | end;
+}
+
+/**
+ * @brief Moves the upper half of the largest range left to thread self.
+ *
+ * @return int 1 if soups were taken, 0 if every range is empty.
+ */
+static int steal(struct census_run *run, int self) {
+    for (;;) {
+        int victim = -1;
+        uint64_t seen = 0;
+        uint32_t most = 0;
+        for (int v = 0; v < run->threads; v++) {
+            uint64_t range = atomic_load(&run->workers[v].range);
+            uint32_t first = (uint32_t)(range >> 32), end = (uint32_t)range;
+            if (v != self && first < end && end - first > most) {
+                victim = v;
+                seen = range;
+                most = end - first;
+            }
+        }
+        if (victim < 0) {
+            return 0;
+        }
+        uint32_t first = (uint32_t)(seen >> 32), end = (uint32_t)seen;
+        uint32_t middle = end - (most + 1) / 2;
+        if (atomic_compare_exchange_weak(&run->workers[victim].range, &seen, pack_range(first, middle))) {
+            atomic_store(&run->workers[self].range, pack_range(middle, end));
+            return 1;
+        }
+    }
+}
+
+/**
+ * @brief Takes the next soup of thread self, stealing when it has none.
+ *
+ * @return int 1 if a soup was taken, 0 when the census is done.
+ */
+static int take_soup(struct census_run *run, int self, long long *soup) {
+    struct worker *worker = &run->workers[self];
+    for (;;) {
+        uint64_t range = atomic_load(&worker->range);
+        uint32_t first = (uint32_t)(range >> 32), end = (uint32_t)range;
+        if (first < end) {
+            if (atomic_compare_exchange_weak(&worker->range, &range, pack_range(first + 1, end))) {
+                *soup = first;
+                return 1;
+            }
+        } else if (!steal(run, self)) {
+            return 0;
+        }
+    }
+}
+
+/**
+ * @brief Pool task: runs soups until none are left.
+ */
+static void census_task(void *arg, int index, int count) {
+    (void)count;
+    struct census_run *run = arg;
+    struct worker *worker = &run->workers[index];
+    long long soup;
+    while (!worker->failed && take_soup(run, index, &soup)) {
+        if (run_soup(worker, run->options, soup) != 0) {
+            worker->failed = 1;
+        }
+    }
+}
+
+static int init_worker(struct worker *worker, const struct life_ruleset *rule) {
+    size_t board = (size_t)CLASSIFY_SIZE * CLASSIFY_SIZE;
+    worker->grid = life_grid_create(CLASSIFY_SIZE, CLASSIFY_SIZE, LIFE_EDGES_CLIP);
+    worker->phase = malloc(board * sizeof(struct cell));
+    worker->first = malloc(board * sizeof(struct cell));
+    worker->scratch = malloc(board * sizeof(struct cell));
+    if (worker->grid == NULL || worker->phase == NULL || worker->first == NULL || worker->scratch == NULL) {
+        return -1;
+    }
+    worker->grid->rule = *rule;
+    return 0;
+}
+
+static void release_worker(struct worker *worker) {
+    life_grid_free(worker->grid);
+    free(worker->cells);
+    free(worker->parent);
+    free(worker->next_cell);
+    free(worker->phase);
+    free(worker->first);
+    free(worker->scratch);
+    table_release(&worker->memo);
+    table_release(&worker->tally);
+}
+
+/**
+ * @brief Finds the codes of the well-known objects under the census rule.
+ *
+ * @param codes Output, one code per entry of known_objects (0 if the
+ *              object does not repeat under the rule).
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int find_known_codes(struct worker *worker, uint64_t codes[KNOWN_COUNT]) {
+    for (size_t k = 0; k < KNOWN_COUNT; k++) {
+        size_t count = 0;
+        for (int r = 0; r < 13 && known_objects[k].rows[r] != NULL; r++) {
+            for (int c = 0; known_objects[k].rows[r][c] != '\0'; c++) {
+                if (known_objects[k].rows[r][c] == 'o') {
+                    worker->scratch[count].x = r;
+                    worker->scratch[count].y = c;
+                    count++;
+                }
+            }
+        }
+        struct cell object[13 * 13];
+        memcpy(object, worker->scratch, count * sizeof(*object));
+        struct life_census_entry found = { 0 };
+        if (run_object(worker, object, count, &found) != 0) {
+            return -1;
+        }
+        codes[k] = found.period != 0 ? found.code : 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Names a table entry after a known object or its code.
+ */
+static void name_entry(struct life_census_entry *entry, const uint64_t codes[KNOWN_COUNT]) {
+    if (entry->code == CODE_UNSTABLE) {
+        snprintf(entry->name, sizeof(entry->name), "unstable");
+        return;
+    }
+    if (entry->code == CODE_OVERSIZED) {
+        snprintf(entry->name, sizeof(entry->name), "oversized");
+        return;
+    }
+    for (size_t k = 0; k < KNOWN_COUNT; k++) {
+        if (codes[k] == entry->code) {
+            snprintf(entry->name, sizeof(entry->name), "%s", known_objects[k].name);
+            return;
+        }
+    }
+    // xs: still life, xp: oscillator, xq: ship
+    const char *kind = entry->moving ? "xq" : entry->period == 1 ? "xs" : "xp";
+    snprintf(entry->name, sizeof(entry->name), "%s%d_%dc_%08x", kind, entry->period, entry->cells,
+             (unsigned)(entry->code & 0xffffffffu));
+}
+
+static int compare_entries(const void *a, const void *b) {
+    const struct life_census_entry *p = a, *q = b;
+    if (p->count != q->count) {
+        return p->count > q->count ? -1 : 1;
+    }
+    return strcmp(p->name, q->name);
+}
+
+/**
+ * @brief Adds up the tallies of every thread into the census table.
+ */
+static int merge_tallies(struct census_run *run, const uint64_t codes[KNOWN_COUNT], struct life_census *census) {
+    struct table total = { 0 };
+    for (int t = 0; t < run->threads; t++) {
+        const struct worker *worker = &run->workers[t];
+        census->soups += worker->soups;
+        census->objects += worker->objects;
+        census->unsettled += worker->unsettled;
+        for (size_t i = 0; i < worker->tally.capacity; i++) {
+            if (worker->tally.keys[i] == 0) {
+                continue;
+            }
+            struct life_census_entry *entry = table_insert(&total, worker->tally.keys[i]);
+            if (entry == NULL) {
+                table_release(&total);
+                return -1;
+            }
+            long long count = entry->count;
+            *entry = worker->tally.values[i];
+            entry->count += count;
+        }
+    }
+
+    census->entries = malloc((total.used > 0 ? total.used : 1) * sizeof(*census->entries));
+    if (census->entries == NULL) {
+        table_release(&total);
+        return -1;
+    }
+    for (size_t i = 0; i < total.capacity; i++) {
+        if (total.keys[i] != 0) {
+            struct life_census_entry *entry = &census->entries[census->entry_count++];
+            *entry = total.values[i];
+            name_entry(entry, codes);
+        }
+    }
+    qsort(census->entries, census->entry_count, sizeof(*census->entries), compare_entries);
+    table_release(&total);
+    return 0;
+}
+
+int life_census_run(const struct life_census_options *options, struct life_pool *pool,
+                    struct life_census *census) {
+    memset(census, 0, sizeof(*census));
+    if (options->soups < 0 || options->soups > UINT32_MAX || options->soup_size <= 0) {
+        return -1;
+    }
+    struct census_run run = { options, NULL, pool != NULL ? life_pool_threads(pool) : 1 };
+    run.workers = aligned_alloc(64, (size_t)run.threads * sizeof(struct worker));
+    if (run.workers == NULL) {
+        return -1;
+    }
+    memset(run.workers, 0, (size_t)run.threads * sizeof(struct worker));
+    int status = 0;
+    for (int t = 0; t < run.threads; t++) {
+        uint32_t first = (uint32_t)(options->soups * t / run.threads);
+        uint32_t end = (uint32_t)(options->soups * (t + 1) / run.threads);
+        atomic_init(&run.workers[t].range, pack_range(first, end));
+        if (init_worker(&run.workers[t], &options->rule) != 0) {
+            status = -1;
+        }
+    }
+
+    uint64_t codes[KNOWN_COUNT];
+    if (status == 0) {
+        status = find_known_codes(&run.workers[0], codes);
+    }
+    if (status == 0) {
+        double start = life_clock_seconds();
+        if (pool != NULL) {
+            life_pool_run(pool, census_task, &run);
+        } else {
+            census_task(&run, 0, 1);
+        }
+        census->seconds = life_clock_seconds() - start;
+        for (int t = 0; t < run.threads; t++) {
+            status |= run.workers[t].failed ? -1 : 0;
+        }
+    }
+    if (status == 0) {
+        status = merge_tallies(&run, codes, census);
+    }
+    for (int t = 0; t < run.threads; t++) {
+        release_worker(&run.workers[t]);
+    }
+    free(run.workers);
+    if (status != 0) {
+        life_census_release(census);
+    }
+    return status;
+}
+
+void life_census_release(struct life_census *census) {
+    free(census->entries);
+    census->entries = NULL;
+    census->entry_count = 0;
+}
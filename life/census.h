@@ -0,0 +1,94 @@
+/*******************************************************************
+ * Conway's Game of Life - Random Soup Census
+ *
+ * Author: hrosicka
+ * Description:
+ *   Finds out what random starting conditions turn into. Each soup is
+ *   a square of random cells on an unbounded plane (sparse.c), run
+ *   until it settles. What is left is split into objects, and every
+ *   object is identified and tallied.
+ *
+ * How It Works:
+ *   - Soup i is filled from a xoshiro256** generator seeded with the
+ *     census seed and i, so a census gives the same table for any
+ *     number of threads.
+ *   - A soup has settled once its population has repeated with some
+ *     period p <= LIFE_CENSUS_MAX_PERIOD for long enough. Gliders and
+ *     other ships fly off and keep the population periodic.
+ *   - Live cells closer than three cells (8-neighborhood of radius 2)
+ *     belong to the same object.
+ *   - Each object is run on its own until it returns to its first
+ *     shape, possibly moved. Its code is the smallest hash of its
+ *     cells over every phase, rotation and reflection, so the same
+ *     object found in any phase or orientation gets the same code.
+ *     Codes of well-known objects are replaced by their names.
+ *   - Threads take soups from their own range of soup numbers. A
+ *     thread that runs out steals half of the largest range left, so
+ *     slow soups never leave the other cores idle.
+ *******************************************************************/
+
+#ifndef LIFE_CENSUS_H
+#define LIFE_CENSUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pool.h"
+#include "rule.h"
+
+#define LIFE_CENSUS_MAX_PERIOD 60   // Longest period told apart (object or soup)
+#define LIFE_CENSUS_NAME_MAX 32     // Longest object name, terminator included
+
+/**
+ * @brief Parameters of a census.
+ */
+struct life_census_options {
+    long long soups;            // Number of soups
+    uint64_t seed;              // Seed of the first soup
+    int soup_size;              // Side of the random square
+    long long max_generations;  // Soups still active after this are not counted
+    struct life_ruleset rule;   // The rule
+};
+
+/**
+ * @brief One line of the frequency table.
+ */
+struct life_census_entry {
+    char name[LIFE_CENSUS_NAME_MAX];  // e.g. "blinker", or a code such as "xp2_8c_1f03a2b4"
+    uint64_t code;                    // Hash identifying the object
+    int period;                       // 1 for still lifes, 0 if unknown
+    int moving;                       // Set for ships
+    int cells;                        // Live cells in the first phase found
+    long long count;                  // Times the object was found
+};
+
+/**
+ * @brief Result of a census.
+ */
+struct life_census {
+    struct life_census_entry *entries;  // Sorted by decreasing count
+    size_t entry_count;
+    long long soups;                    // Soups run
+    long long objects;                  // Objects tallied
+    long long unsettled;                // Soups that did not settle in time
+    double seconds;                     // Wall-clock time of the census
+};
+
+/**
+ * @brief Runs a census.
+ *
+ * @param options The parameters.
+ * @param pool Worker threads, or NULL to run on the calling thread.
+ * @param census Filled in with the result; release it with
+ *               life_census_release().
+ * @return int 0 on success, -1 if out of memory.
+ */
+int life_census_run(const struct life_census_options *options, struct life_pool *pool,
+                    struct life_census *census);
+
+/**
+ * @brief Frees the table of a census.
+ */
+void life_census_release(struct life_census *census);
+
+#endif // LIFE_CENSUS_H
@@ -0,0 +1,232 @@
+/*******************************************************************
+ * Conway's Game of Life - Binary Checkpoints
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the checkpoint format declared in checkpoint.h.
+ *******************************************************************/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "checkpoint.h"
+
+#define MAGIC "LIFECKPT"
+#define BYTE_ORDER_MARK 0x01020304u
+#define WRITE_BUFFER (1 << 20)                  // stdio buffer used while saving
+#define CHECKSUM_PRIME 0x100000001b3ULL         // FNV-1a 64-bit prime
+#define CHECKSUM_SEED 0xcbf29ce484222325ULL     // FNV-1a 64-bit offset basis
+
+/**
+ * @brief The 64-byte file header.
+ */
+struct checkpoint_header {
+    char magic[8];          // MAGIC, not terminated
+    uint32_t version;       // LIFE_CHECKPOINT_VERSION
+    uint32_t byte_order;    // BYTE_ORDER_MARK
+    int32_t width;
+    int32_t height;
+    uint32_t edges;         // enum life_edges
+    uint16_t birth;         // Bit n set: a dead cell with n neighbors is born
+    uint16_t survival;      // Bit n set: a live cell with n neighbors survives
+    int64_t generation;
+    uint64_t words;         // Board words encoded in the records
+    uint8_t reserved[16];   // Zero
+};
+
+_Static_assert(sizeof(struct checkpoint_header) == 64, "checkpoint header must be 64 bytes");
+
+/**
+ * @brief Folds one 64-bit value into the running checksum.
+ */
+static inline uint64_t checksum_add(uint64_t sum, uint64_t value) {
+    return (sum ^ value) * CHECKSUM_PRIME;
+}
+
+/**
+ * @brief Streams the board as zero/literal records.
+ *
+ * A literal span continues over a single zero word, since a new
+ * record would cost more than the word it saves.
+ *
+ * @return int 0 on success, -1 on a write error.
+ */
+static int write_records(FILE *file, const uint64_t *cells, uint64_t total, uint64_t *checksum) {
+    uint64_t sum = *checksum;
+    uint64_t i = 0;
+    while (i < total) {
+        uint64_t zeros = 0;
+        while (i + zeros < total && cells[i + zeros] == 0) {
+            zeros++;
+        }
+        uint64_t start = i + zeros, end = start;
+        while (end < total && (cells[end] != 0 || (end + 1 < total && cells[end + 1] != 0))) {
+            end++;
+        }
+        uint64_t counts[2] = { zeros, end - start };
+        if (fwrite(counts, sizeof(counts), 1, file) != 1 ||
+            fwrite(cells + start, sizeof(uint64_t), counts[1], file) != counts[1]) {
+            return -1;
+        }
+        sum = checksum_add(checksum_add(sum, counts[0]), counts[1]);
+        for (uint64_t w = start; w < end; w++) {
+            sum = checksum_add(sum, cells[w]);
+        }
+        i = end;
+    }
+    *checksum = sum;
+    return 0;
+}
+
+int life_checkpoint_save(const struct life_grid *grid, long long generation, const char *path) {
+    size_t length = strlen(path);
+    char *temp = malloc(length + 5);
+    if (temp == NULL) {
+        return -1;
+    }
+    memcpy(temp, path, length);
+    memcpy(temp + length, ".tmp", 5);
+
+    FILE *file = fopen(temp, "wb");
+    if (file == NULL) {
+        free(temp);
+        return -1;
+    }
+    setvbuf(file, NULL, _IOFBF, WRITE_BUFFER);
+
+    struct checkpoint_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = LIFE_CHECKPOINT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.width = grid->width;
+    header.height = grid->height;
+    header.edges = (uint32_t)grid->edges;
+    header.birth = grid->rule.birth;
+    header.survival = grid->rule.survival;
+    header.generation = generation;
+    header.words = (uint64_t)grid->words * (uint64_t)grid->height;
+
+    uint64_t checksum = CHECKSUM_SEED;
+    int status = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 write_records(file, grid->cells, header.words, &checksum) == 0 &&
+                 fwrite(&checksum, sizeof(checksum), 1, file) == 1 ? 0 : -1;
+
+    // The data must be on disk before the rename makes it the checkpoint
+    if (fflush(file) != 0 || fsync(fileno(file)) != 0) {
+        status = -1;
+    }
+    if (fclose(file) != 0) {
+        status = -1;
+    }
+    if (status == 0 && rename(temp, path) != 0) {
+        status = -1;
+    }
+    if (status != 0) {
+        remove(temp);
+    }
+    free(temp);
+    return status;
+}
+
+/**
+ * @brief Decodes the records at data into the board.
+ *
+ * @return int 0 if the records fit the board and match the checksum
+ *             that follows them, -1 otherwise.
+ */
+static int read_records(struct life_grid *grid, const unsigned char *data, size_t size, uint64_t total) {
+    uint64_t sum = CHECKSUM_SEED;
+    uint64_t i = 0;
+    size_t offset = 0;
+    while (i < total) {
+        uint64_t counts[2];
+        if (size - offset < sizeof(counts)) {
+            return -1;
+        }
+        memcpy(counts, data + offset, sizeof(counts));
+        offset += sizeof(counts);
+        if (counts[0] > total - i || counts[1] > total - i - counts[0] ||
+            counts[1] > (size - offset) / sizeof(uint64_t) || counts[0] + counts[1] == 0) {
+            return -1;
+        }
+        sum = checksum_add(checksum_add(sum, counts[0]), counts[1]);
+        i += counts[0];
+
+        uint64_t *out = grid->cells + i;
+        memcpy(out, data + offset, counts[1] * sizeof(uint64_t));
+        for (uint64_t w = 0; w < counts[1]; w++) {
+            sum = checksum_add(sum, out[w]);
+        }
+        offset += counts[1] * sizeof(uint64_t);
+        i += counts[1];
+    }
+
+    uint64_t stored;
+    if (size - offset != sizeof(stored)) {
+        return -1;
+    }
+    memcpy(&stored, data + offset, sizeof(stored));
+    return stored == sum ? 0 : -1;
+}
+
+struct life_grid *life_checkpoint_load(const char *path, long long *generation) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct checkpoint_header)) {
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)st.st_size;
+    const unsigned char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+    posix_madvise((void *)data, size, POSIX_MADV_SEQUENTIAL);
+
+    struct checkpoint_header header;
+    memcpy(&header, data, sizeof(header));
+    struct life_grid *grid = NULL;
+    if (memcmp(header.magic, MAGIC, sizeof(header.magic)) == 0 &&
+        header.version == LIFE_CHECKPOINT_VERSION && header.byte_order == BYTE_ORDER_MARK &&
+        (header.birth & 1) == 0 && header.birth < (1u << 9) && header.survival < (1u << 9) &&
+        (header.edges == LIFE_EDGES_WRAP || header.edges == LIFE_EDGES_CLIP)) {
+        grid = life_grid_create(header.width, header.height, (enum life_edges)header.edges);
+    }
+    if (grid != NULL) {
+        grid->rule.birth = header.birth;
+        grid->rule.survival = header.survival;
+    }
+    if (grid != NULL && header.words != (uint64_t)grid->words * (uint64_t)grid->height) {
+        life_grid_free(grid);
+        grid = NULL;
+    }
+    if (grid != NULL && read_records(grid, data + sizeof(header), size - sizeof(header), header.words) != 0) {
+        life_grid_free(grid);
+        grid = NULL;
+    }
+    munmap((void *)data, size);
+    if (grid == NULL) {
+        return NULL;
+    }
+
+    // Keep the bits past the last column zero, as the step kernels expect
+    int used = grid->width % 64;
+    if (used != 0) {
+        for (int x = 0; x < grid->height; x++) {
+            grid->cells[(size_t)x * grid->words + grid->words - 1] &= (1ULL << used) - 1;
+        }
+    }
+    grid->all_active = 1;
+    *generation = header.generation;
+    return grid;
+}
@@ -0,0 +1,63 @@
+/*******************************************************************
+ * Conway's Game of Life - Binary Checkpoints
+ *
+ * Author: hrosicka
+ * Description:
+ *   Saves a bit-packed board to a compact binary file and resumes it
+ *   later, so a long run survives a crash or a restart.
+ *
+ * File Layout (version 1, integers in the writer's byte order):
+ *   - A 64-byte header: the magic "LIFECKPT", the format version, a
+ *     byte-order mark (files from a machine of the other byte order
+ *     are rejected), the board size and edge mode, the rule as
+ *     birth and survival neighbor-count masks, the generation
+ *     counter and the number of board words that follow.
+ *   - The board words in row-major order (the life_grid layout),
+ *     encoded as records of two 64-bit counts, "zero words" and
+ *     "literal words", each followed by that many literal words.
+ *     Empty regions therefore cost 16 bytes per run.
+ *   - A 64-bit checksum of the records.
+ *
+ *   Saving streams the records through a buffered file and never
+ *   holds a second copy of the board. The file is first written
+ *   next to the target and renamed over it once complete, so an
+ *   interrupted save leaves the previous checkpoint intact.
+ *
+ *   Loading maps the file and copies each literal span straight into
+ *   the new board. Zero runs are skipped, since the board's fresh
+ *   pages are already zero and are never touched. The records still
+ *   have to be walked and checksummed once: a compressed stream
+ *   cannot serve as the board in place (mapped.h keeps a board that
+ *   can).
+ *******************************************************************/
+
+#ifndef LIFE_CHECKPOINT_H
+#define LIFE_CHECKPOINT_H
+
+#include "grid.h"
+
+#define LIFE_CHECKPOINT_VERSION 1   // Version written by life_checkpoint_save()
+
+/**
+ * @brief Writes the board, its rule and its generation counter to a file.
+ *
+ * @param grid The board.
+ * @param generation Generation the board is at.
+ * @param path The file to write; replaced only once the new file is complete.
+ * @return int 0 on success, -1 if the file cannot be written.
+ */
+int life_checkpoint_save(const struct life_grid *grid, long long generation, const char *path);
+
+/**
+ * @brief Creates a board from a checkpoint file.
+ *
+ * The board has the size, edge mode and rule stored in the file.
+ *
+ * @param path The file to read.
+ * @param generation Set to the generation stored in the file.
+ * @return struct life_grid* The board, or NULL if the file cannot be
+ *         read, is not a valid checkpoint, or is out of memory.
+ */
+struct life_grid *life_checkpoint_load(const char *path, long long *generation);
+
+#endif // LIFE_CHECKPOINT_H
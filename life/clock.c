@@ -0,0 +1,17 @@
+/*******************************************************************
+ * Conway's Game of Life - Monotonic Clock
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the clock declared in clock.h.
+ *******************************************************************/
+
+#include <time.h>
+
+#include "clock.h"
+
+long long life_clock_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * LIFE_CLOCK_NS_PER_SECOND + ts.tv_nsec;
+}
@@ -0,0 +1,29 @@
+/*******************************************************************
+ * Conway's Game of Life - Monotonic Clock
+ *
+ * Author: hrosicka
+ * Description:
+ *   The one clock of the programs. The phase timers, the --bench,
+ *   --census and --conform timings and the frame pacer all read the
+ *   monotonic clock through life_clock_now(), so their figures can be
+ *   compared and setting the wall clock never disturbs them.
+ *******************************************************************/
+
+#ifndef LIFE_CLOCK_H
+#define LIFE_CLOCK_H
+
+#define LIFE_CLOCK_NS_PER_SECOND 1000000000LL
+
+/**
+ * @brief Returns the monotonic clock in nanoseconds.
+ */
+long long life_clock_now(void);
+
+/**
+ * @brief Returns the monotonic clock in seconds, for timing runs.
+ */
+static inline double life_clock_seconds(void) {
+    return (double)life_clock_now() / (double)LIFE_CLOCK_NS_PER_SECOND;
+}
+
+#endif // LIFE_CLOCK_H
@@ -0,0 +1,915 @@
+/*******************************************************************
+ * Conway's Game of Life - Kernel Conformance
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the conformance run declared in conform.h.
+ *
+ *   The reference is run once per board, and its hash, population,
+ *   births and deaths at the end of every chunk are kept, so each
+ *   kernel and thread count only costs a run of the kernel.
+ *******************************************************************/
+
+#define _POSIX_C_SOURCE 200809L // For mkdtemp
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "conform.h"
+#include "domain.h"
+#include "ensemble.h"
+#include "mapped.h"
+#include "random.h"
+#include "reference.h"
+#include "simd.h"
+#include "sparse.h"
+
+#define LARGE_EVERY 16          // One board in this many is large
+#define SMALL_SIZE 300          // Largest side of the other boards
+#define LARGE_WIDTH 4200        // Largest large board: several blocked bands
+#define LARGE_HEIGHT 700
+#define ENSEMBLE_LANES 0x9249249249249249ULL  // Lanes 0, 3, ..., 63 carry the board
+#define SMALL_MAX_CELLS (SMALL_SIZE * SMALL_SIZE)  // Largest board run as an ensemble batch or mapped
+#define READ_ROWS 64            // Rows read back from the sparse, domain and mapped boards at a time
+#define HASH_PRIME 0x100000001b3ULL        // FNV-1a 64-bit prime
+#define HASH_SEED 0xcbf29ce484222325ULL    // FNV-1a 64-bit offset basis
+
+static const int densities[] = { 2, 10, 25, 37, 50, 75, 95 };  // Percent of live cells
+static const char *const isas[] = { "scalar", "sse2", "avx2", "avx512" };  // Tried with the simd kernel
+
+/**
+ * @brief The reference board at the end of one chunk.
+ */
+struct expected {
+    uint64_t hash;
+    long long live;
+    long long births;       // In the last generation of the chunk
+    long long deaths;
+};
+
+/**
+ * @brief Returns a whole number in [0, n).
+ */
+static long long random_below(struct life_xoshiro *rng, long long n) {
+    return (long long)(life_xoshiro_next(rng) % (uint64_t)n);
+}
+
+static uint64_t hash_cells(const uint8_t *cells, long long count) {
+    uint64_t hash = HASH_SEED;
+    for (long long i = 0; i < count; i++) {
+        hash = (hash ^ cells[i]) * HASH_PRIME;
+    }
+    return hash;
+}
+
+static long long chunk_count(const struct life_conform_case *run) {
+    return (run->generations + run->chunk - 1) / run->chunk;
+}
+
+/**
+ * @brief Runs the reference and records the board after each chunk.
+ *
+ * @param expected Output, one entry per chunk.
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int run_reference(const struct life_conform_case *run, struct expected *expected) {
+    long long count = (long long)run->width * run->height;
+    uint8_t *cells = malloc((size_t)count);
+    uint8_t *next = malloc((size_t)count);
+    if (cells == NULL || next == NULL) {
+        free(cells);
+        free(next);
+        return -1;
+    }
+    memcpy(cells, run->cells, (size_t)count);
+
+    long long done = 0;
+    for (long long i = 0; done < run->generations; i++) {
+        long long n = run->generations - done < run->chunk ? run->generations - done : run->chunk;
+        for (long long g = 0; g < n; g++) {
+            life_reference_step(cells, next, run->width, run->height, run->edges, &run->rule,
+                                &expected[i].births, &expected[i].deaths);
+            uint8_t *swap = cells;
+            cells = next;
+            next = swap;
+        }
+        expected[i].hash = hash_cells(cells, count);
+        expected[i].live = 0;
+        for (long long c = 0; c < count; c++) {
+            expected[i].live += cells[c];
+        }
+        done += n;
+    }
+    free(cells);
+    free(next);
+    return 0;
+}
+
+/**
+ * @brief Runs the kernel and compares it with the reference after each chunk.
+ *
+ * @param generation Set to the generation that differs.
+ * @param what Set to what differs.
+ * @return int 1 if the run differs, 0 if it does not, -1 if out of memory.
+ */
+static int run_kernel(const struct life_conform_case *run, struct life_pool *pool, const struct expected *expected,
+                      long long *generation, const char **what) {
+    long long count = (long long)run->width * run->height;
+    struct life_grid *grid = life_grid_create(run->width, run->height, run->edges);
+    uint8_t *cells = malloc((size_t)count);
+    if (grid == NULL || cells == NULL || (run->stats && life_grid_track_stats(grid, 1) != 0)) {
+        life_grid_free(grid);
+        free(cells);
+        return -1;
+    }
+    life_grid_pack(grid, run->cells);
+    if (run->isa != NULL) {
+        life_simd_select(run->isa);
+    }
+    grid->kernel = run->kernel;
+    grid->rule = run->rule;
+    grid->pool = pool;
+
+    int status = 0;
+    long long done = 0;
+    for (long long i = 0; done < run->generations && status == 0; i++) {
+        long long n = run->generations - done < run->chunk ? run->generations - done : run->chunk;
+        if (life_grid_step_n(grid, n) != 0) {
+            status = -1;
+            break;
+        }
+        done += n;
+        *generation = done;
+
+        life_grid_unpack(grid, cells);
+        if (hash_cells(cells, count) != expected[i].hash) {
+            *what = "cells";
+            status = 1;
+        } else if (run->stats) {
+            struct life_grid_stats stats;
+            life_grid_stats(grid, &stats);
+            if (stats.live != expected[i].live) {
+                *what = "population";
+                status = 1;
+            } else if (stats.births >= 0 &&
+                       (stats.births != expected[i].births || stats.deaths != expected[i].deaths)) {
+                *what = "births and deaths";
+                status = 1;
+            }
+        }
+    }
+    life_grid_free(grid);
+    free(cells);
+    return status;
+}
+
+/**
+ * @brief Runs the board on the lanes of an ensemble and compares it
+ * with the reference after each chunk.
+ *
+ * Same contract as run_kernel().
+ */
+static int run_ensemble_lanes(const struct life_conform_case *run, const struct expected *expected,
+                              long long *generation, const char **what) {
+    long long count = (long long)run->width * run->height;
+    struct life_ensemble *ensemble = life_ensemble_create(run->width, run->height, run->edges);
+    uint8_t *cells = malloc((size_t)count);
+    if (ensemble == NULL || cells == NULL) {
+        life_ensemble_free(ensemble);
+        free(cells);
+        return -1;
+    }
+    ensemble->rule = run->rule;
+    const size_t stride = (size_t)run->width + 2;
+    for (int x = 0; x < run->height; x++) {
+        for (int y = 0; y < run->width; y++) {
+            ensemble->cells[(x + 1) * stride + y + 1] = run->cells[(size_t)x * run->width + y] ? ENSEMBLE_LANES : 0;
+        }
+    }
+
+    int status = 0;
+    long long done = 0;
+    for (long long i = 0; done < run->generations && status == 0; i++) {
+        long long n = run->generations - done < run->chunk ? run->generations - done : run->chunk;
+        life_ensemble_step_n(ensemble, n);
+        done += n;
+        *generation = done;
+
+        for (int x = 0; x < run->height && status == 0; x++) {
+            for (int y = 0; y < run->width; y++) {
+                uint64_t word = ensemble->cells[(x + 1) * stride + y + 1];
+                if (word != 0 && word != ENSEMBLE_LANES) {
+                    *what = "lanes";
+                    status = 1;
+                    break;
+                }
+                cells[(size_t)x * run->width + y] = word != 0;
+            }
+        }
+        if (status == 0 && hash_cells(cells, count) != expected[i].hash) {
+            *what = "cells";
+            status = 1;
+        }
+    }
+    life_ensemble_free(ensemble);
+    free(cells);
+    return status;
+}
+
+/**
+ * @brief Runs copies of the board as a batch on the pool and compares
+ * their populations with the reference at the end.
+ *
+ * Same contract as run_kernel().
+ */
+static int run_ensemble_batch(const struct life_conform_case *run, struct life_pool *pool,
+                              const struct expected *expected, long long *generation, const char **what) {
+    long long count = (long long)run->width * run->height;
+    // One group more than the pool has threads, the last one partial
+    size_t copies = (size_t)LIFE_ENSEMBLE_BOARDS * (size_t)life_pool_threads(pool) + 1;
+    int (*cells)[2] = malloc((size_t)count * sizeof(*cells));
+    struct life_ensemble_board *boards = malloc(copies * sizeof(*boards));
+    long long *populations = malloc(copies * sizeof(*populations));
+    int status = cells == NULL || boards == NULL || populations == NULL ? -1 : 0;
+
+    struct life_pattern board = { (const int (*)[2])cells, 0, 0, 0 };
+    for (long long c = 0; c < count && status == 0; c++) {
+        if (run->cells[c]) {
+            cells[board.size][0] = (int)(c / run->width);
+            cells[board.size][1] = (int)(c % run->width);
+            board.size++;
+        }
+    }
+    for (size_t k = 0; k < copies && status == 0; k++) {
+        boards[k].patterns = &board;
+        boards[k].pattern_count = 1;
+    }
+    if (status == 0) {
+        status = life_ensemble_run_batch(run->width, run->height, run->edges, &run->rule, boards, copies,
+                                         run->generations, pool, populations);
+    }
+    *generation = run->generations;
+    for (size_t k = 0; k < copies && status == 0; k++) {
+        if (populations[k] != expected[chunk_count(run) - 1].live) {
+            *what = "population";
+            status = 1;
+        }
+    }
+    free(cells);
+    free(boards);
+    free(populations);
+    return status;
+}
+
+/**
+ * @brief A board read back as bit-packed rows: the sparse plane, the
+ * domain or the mapped board.
+ */
+struct row_board {
+    void *board;
+    int (*step_n)(void *board, long long n);
+    void (*read_rows)(void *board, int x, int rows, int words, uint64_t *out);
+    long long (*population)(void *board);
+};
+
+static int sparse_step_n(void *board, long long n) {
+    return life_sparse_step_n(board, n);
+}
+
+static void sparse_read_rows(void *board, int x, int rows, int words, uint64_t *out) {
+    life_sparse_read_rows(board, x, 0, rows, words, out);
+}
+
+static long long sparse_population(void *board) {
+    return life_sparse_population(board);
+}
+
+static int domain_step_n(void *board, long long n) {
+    return life_domain_step_n(board, n);
+}
+
+static void domain_read_rows(void *board, int x, int rows, int words, uint64_t *out) {
+    life_domain_read_rows(board, x, rows, words, out);
+}
+
+static long long domain_population(void *board) {
+    return life_domain_population(board);
+}
+
+static int mapped_step_n(void *board, long long n) {
+    return life_mapped_step_n(board, n);
+}
+
+static void mapped_read_rows(void *board, int x, int rows, int words, uint64_t *out) {
+    life_mapped_read_rows(board, x, rows, words, out);
+}
+
+static long long mapped_population(void *board) {
+    return life_mapped_population(board);
+}
+
+/**
+ * @brief Steps a row board in chunks and compares its cells and
+ * population with the reference after each one.
+ *
+ * Same contract as run_kernel().
+ */
+static int run_rows(const struct life_conform_case *run, const struct row_board *board,
+                    const struct expected *expected, long long *generation, const char **what) {
+    long long count = (long long)run->width * run->height;
+    int words = (run->width + 63) / 64;
+    uint8_t *cells = malloc((size_t)count);
+    uint64_t *rows = malloc((size_t)READ_ROWS * (size_t)words * sizeof(*rows));
+    int status = cells == NULL || rows == NULL ? -1 : 0;
+
+    long long done = 0;
+    for (long long i = 0; done < run->generations && status == 0; i++) {
+        long long n = run->generations - done < run->chunk ? run->generations - done : run->chunk;
+        if (board->step_n(board->board, n) != 0) {
+            status = -1;
+            break;
+        }
+        done += n;
+        *generation = done;
+
+        for (int x = 0; x < run->height; x += READ_ROWS) {
+            int band = run->height - x < READ_ROWS ? run->height - x : READ_ROWS;
+            board->read_rows(board->board, x, band, words, rows);
+            for (int r = 0; r < band; r++) {
+                for (int y = 0; y < run->width; y++) {
+                    cells[(size_t)(x + r) * run->width + y] = (rows[(size_t)r * words + y / 64] >> (y % 64)) & 1;
+                }
+            }
+        }
+        if (hash_cells(cells, count) != expected[i].hash) {
+            *what = "cells";
+            status = 1;
+        } else if (board->population(board->board) != expected[i].live) {
+            *what = "population";
+            status = 1;
+        }
+    }
+    free(cells);
+    free(rows);
+    return status;
+}
+
+/**
+ * @brief Runs the board on an unbounded plane.
+ *
+ * Same contract as run_kernel(); the board must be padded (see
+ * engine_runs()).
+ */
+static int run_sparse(const struct life_conform_case *run, const struct expected *expected,
+                      long long *generation, const char **what) {
+    struct life_sparse *plane = life_sparse_create();
+    int status = plane == NULL ? -1 : 0;
+    for (long long c = 0; c < (long long)run->width * run->height && status == 0; c++) {
+        if (run->cells[c]) {
+            status = life_sparse_set(plane, c / run->width, c % run->width, 1);
+        }
+    }
+    if (status == 0) {
+        life_sparse_set_rule(plane, &run->rule);
+        struct row_board board = { plane, sparse_step_n, sparse_read_rows, sparse_population };
+        status = run_rows(run, &board, expected, generation, what);
+    }
+    if (plane != NULL) {
+        life_sparse_free(plane);
+    }
+    return status;
+}
+
+/**
+ * @brief Fills a worker's band of run_domain() from the board.
+ */
+static int fill_domain(void *arg, struct life_grid *band, int first_row, int rows) {
+    const struct life_conform_case *run = arg;
+    band->rule = run->rule;
+    for (int x = 0; x < rows; x++) {
+        for (int y = 0; y < run->width; y++) {
+            if (run->cells[(size_t)(first_row + x) * run->width + y]) {
+                life_grid_set(band, x + 1, y, 1);
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs the board in one worker process per thread of the run.
+ *
+ * The pools of life_conform_run() are idle while the workers are
+ * forked, and the workers start no threads of their own.
+ *
+ * Same contract as run_kernel().
+ */
+static int run_domain(const struct life_conform_case *run, const struct expected *expected,
+                      long long *generation, const char **what) {
+    struct life_domain_options options = {
+        run->width, run->height, run->edges, run->threads, 1, LIFE_KERNEL_PACKED,
+        run->height < READ_ROWS ? run->height : READ_ROWS, (run->width + 63) / 64
+    };
+    struct life_domain *domain = life_domain_create(&options, fill_domain, (void *)run);
+    if (domain == NULL) {
+        return -1;
+    }
+    struct row_board board = { domain, domain_step_n, domain_read_rows, domain_population };
+    int status = run_rows(run, &board, expected, generation, what);
+    life_domain_free(domain);
+    return status;
+}
+
+/**
+ * @brief Runs the board from a file in a new temporary directory, which
+ * is removed again.
+ *
+ * Same contract as run_kernel(); -1 also if the file cannot be created.
+ */
+static int run_mapped(const struct life_conform_case *run, struct life_pool *pool, const struct expected *expected,
+                      long long *generation, const char **what) {
+    const char *tmp = getenv("TMPDIR");
+    char dir[PATH_MAX], path[PATH_MAX + 8];
+    snprintf(dir, sizeof(dir), "%s/life-conform-XXXXXX", tmp != NULL && tmp[0] != '\0' ? tmp : "/tmp");
+    if (mkdtemp(dir) == NULL) {
+        return -1;
+    }
+    snprintf(path, sizeof(path), "%s/board", dir);
+
+    int status = -1;
+    struct life_mapped *mapped = life_mapped_create(path, run->width, run->height, run->edges);
+    if (mapped != NULL) {
+        for (long long c = 0; c < (long long)run->width * run->height; c++) {
+            if (run->cells[c]) {
+                life_mapped_set_run(mapped, c / run->width, c % run->width, 1);
+            }
+        }
+        mapped->rule = run->rule;
+        mapped->kernel = LIFE_KERNEL_PACKED;
+        mapped->pool = pool;
+        struct row_board board = { mapped, mapped_step_n, mapped_read_rows, mapped_population };
+        status = run_rows(run, &board, expected, generation, what);
+        if (life_mapped_close(mapped) != 0 && status == 0) {
+            status = -1;
+        }
+    }
+    unlink(path);
+    rmdir(dir);
+    return status;
+}
+
+/**
+ * @brief Runs the engine of a run and compares it with the reference.
+ *
+ * Same contract as run_kernel().
+ */
+static int run_engine(const struct life_conform_case *run, struct life_pool *pool,
+                      const struct expected *expected, long long *generation, const char **what) {
+    switch (run->engine) {
+    case LIFE_CONFORM_ENSEMBLE:
+        return pool != NULL ? run_ensemble_batch(run, pool, expected, generation, what)
+                            : run_ensemble_lanes(run, expected, generation, what);
+    case LIFE_CONFORM_SPARSE:
+        return run_sparse(run, expected, generation, what);
+    case LIFE_CONFORM_DOMAIN:
+        return run_domain(run, expected, generation, what);
+    case LIFE_CONFORM_MAPPED:
+        return run_mapped(run, pool, expected, generation, what);
+    default:
+        return run_kernel(run, pool, expected, generation, what);
+    }
+}
+
+/**
+ * @brief Tells whether the engine of a run can run its board.
+ *
+ * The sparse plane needs a clipped board whose live cells are at least
+ * generations cells from every edge: no cell outside the board can
+ * then come alive, and the unbounded plane agrees with the clipped
+ * board. Shrinking may make candidates that no engine runs; they count
+ * as passing.
+ */
+static int engine_runs(const struct life_conform_case *run) {
+    long long cells = (long long)run->width * run->height;
+    switch (run->engine) {
+    case LIFE_CONFORM_ENSEMBLE:
+        return run->threads == 1 || cells <= SMALL_MAX_CELLS;
+    case LIFE_CONFORM_SPARSE:
+        if (run->threads != 1 || run->edges != LIFE_EDGES_CLIP) {
+            return 0;
+        }
+        for (long long c = 0; c < cells; c++) {
+            long long x = c / run->width, y = c % run->width;
+            if (run->cells[c] && (x < run->generations || x >= run->height - run->generations ||
+                                  y < run->generations || y >= run->width - run->generations)) {
+                return 0;
+            }
+        }
+        return 1;
+    case LIFE_CONFORM_DOMAIN:
+        return run->threads <= run->height;
+    case LIFE_CONFORM_MAPPED:
+        return cells <= SMALL_MAX_CELLS;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief Copies a run onto a clipped board with pad dead rows and
+ * columns on each side.
+ *
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int pad_case(const struct life_conform_case *run, int pad, struct life_conform_case *copy) {
+    *copy = *run;
+    copy->width = run->width + 2 * pad;
+    copy->height = run->height + 2 * pad;
+    copy->edges = LIFE_EDGES_CLIP;
+    copy->cells = calloc((size_t)copy->width * (size_t)copy->height, 1);
+    if (copy->cells == NULL) {
+        return -1;
+    }
+    for (int x = 0; x < run->height; x++) {
+        memcpy(copy->cells + (size_t)(x + pad) * copy->width + pad, run->cells + (size_t)x * run->width,
+               (size_t)run->width);
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs the reference and the kernel.
+ *
+ * @return int 1 if the run differs, 0 if it does not, -1 if out of memory.
+ */
+static int check(const struct life_conform_case *run, struct life_pool **pools, long long *generation,
+                 const char **what) {
+    if (!engine_runs(run)) {
+        return 0;
+    }
+    struct expected *expected = malloc((size_t)chunk_count(run) * sizeof(*expected));
+    if (expected == NULL || run_reference(run, expected) != 0) {
+        free(expected);
+        return -1;
+    }
+    int status = run_engine(run, pools[run->threads], expected, generation, what);
+    free(expected);
+    return status;
+}
+
+/**
+ * @brief Replaces the failing run by a candidate if the candidate still fails.
+ *
+ * The candidate's cells are taken over either way.
+ *
+ * @return int 1 if the candidate was kept, 0 if not, -1 if out of memory.
+ */
+static int try_candidate(struct life_conform_case *failure, struct life_conform_case *candidate,
+                         struct life_pool **pools, long long *generation, const char **what) {
+    long long candidate_generation;
+    const char *candidate_what;
+    int status = check(candidate, pools, &candidate_generation, &candidate_what);
+    if (status != 1) {
+        free(candidate->cells);
+        return status;
+    }
+    free(failure->cells);
+    *failure = *candidate;
+    failure->generations = candidate_generation;
+    *generation = candidate_generation;
+    *what = candidate_what;
+    return 1;
+}
+
+/**
+ * @brief Copies a run, cells included.
+ *
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int copy_case(const struct life_conform_case *run, struct life_conform_case *copy) {
+    *copy = *run;
+    size_t count = (size_t)run->width * (size_t)run->height;
+    copy->cells = malloc(count);
+    if (copy->cells == NULL) {
+        return -1;
+    }
+    memcpy(copy->cells, run->cells, count);
+    return 0;
+}
+
+/**
+ * @brief Copies a run with rows [top, top + height) and columns
+ * [left, left + width) of its board.
+ */
+static int crop_case(const struct life_conform_case *run, int top, int left, int height, int width,
+                     struct life_conform_case *copy) {
+    *copy = *run;
+    copy->width = width;
+    copy->height = height;
+    copy->cells = malloc((size_t)width * (size_t)height);
+    if (copy->cells == NULL) {
+        return -1;
+    }
+    for (int x = 0; x < height; x++) {
+        memcpy(copy->cells + (size_t)x * width, run->cells + (size_t)(top + x) * run->width + left, (size_t)width);
+    }
+    return 0;
+}
+
+/**
+ * @brief Tries to remove rows or columns from each side of the board.
+ *
+ * @return int 1 if the board shrank, 0 if not, -1 if out of memory.
+ */
+static int shrink_board(struct life_conform_case *failure, struct life_pool **pools, long long *generation,
+                        const char **what) {
+    int shrunk = 0;
+    for (int side = 0; side < 4; side++) {
+        int vertical = side < 2;
+        for (int cut = (vertical ? failure->height : failure->width) / 2; cut >= 1;) {
+            int length = vertical ? failure->height : failure->width;
+            if (cut >= length) {
+                cut = length / 2;
+                continue;
+            }
+            struct life_conform_case candidate;
+            int top = side == 0 ? cut : 0, left = side == 2 ? cut : 0;
+            int status = vertical ? crop_case(failure, top, 0, length - cut, failure->width, &candidate)
+                                  : crop_case(failure, 0, left, failure->height, length - cut, &candidate);
+            if (status == 0) {
+                status = try_candidate(failure, &candidate, pools, generation, what);
+            }
+            if (status < 0) {
+                return -1;
+            }
+            if (status == 1) {
+                shrunk = 1;
+            } else {
+                cut /= 2;
+            }
+        }
+    }
+    return shrunk;
+}
+
+/**
+ * @brief Tries to kill live cells, in groups that halve in size.
+ *
+ * @return int 1 if cells were killed, 0 if not, -1 if out of memory.
+ */
+static int shrink_cells(struct life_conform_case *failure, struct life_pool **pools, long long *generation,
+                        const char **what) {
+    long long count = (long long)failure->width * failure->height;
+    long long *live = malloc((size_t)count * sizeof(*live));
+    if (live == NULL) {
+        return -1;
+    }
+    long long lives = 0;
+    for (long long c = 0; c < count; c++) {
+        if (failure->cells[c]) {
+            live[lives++] = c;
+        }
+    }
+
+    int shrunk = 0;
+    for (long long group = (lives + 1) / 2; group >= 1; group /= 2) {
+        for (long long first = 0; first < lives;) {
+            long long last = first + group < lives ? first + group : lives;
+            struct life_conform_case candidate;
+            int status = copy_case(failure, &candidate);
+            if (status == 0) {
+                for (long long i = first; i < last; i++) {
+                    candidate.cells[live[i]] = 0;
+                }
+                status = try_candidate(failure, &candidate, pools, generation, what);
+            }
+            if (status < 0) {
+                free(live);
+                return -1;
+            }
+            if (status == 1) {
+                // The cells are dead now; drop them from the list
+                memmove(live + first, live + last, (size_t)(lives - last) * sizeof(*live));
+                lives -= last - first;
+                shrunk = 1;
+            } else {
+                first = last;
+            }
+        }
+    }
+    free(live);
+    return shrunk;
+}
+
+/**
+ * @brief Shrinks a failing run to one that is as small as it can make it.
+ *
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int shrink(struct life_conform_case *failure, struct life_pool **pools, long long *generation,
+                  const char **what) {
+    failure->generations = *generation;
+    for (int simplify = 0; simplify < 3; simplify++) {
+        struct life_conform_case candidate;
+        if (copy_case(failure, &candidate) != 0) {
+            return -1;
+        }
+        candidate.threads = simplify == 0 ? 1 : candidate.threads;
+        candidate.stats = simplify == 1 ? 0 : candidate.stats;
+        candidate.chunk = simplify == 2 ? 1 : candidate.chunk;
+        if (try_candidate(failure, &candidate, pools, generation, what) < 0) {
+            return -1;
+        }
+    }
+
+    int shrunk = 1;
+    while (shrunk) {
+        int board = shrink_board(failure, pools, generation, what);
+        int cells = board < 0 ? -1 : shrink_cells(failure, pools, generation, what);
+        if (board < 0 || cells < 0) {
+            return -1;
+        }
+        shrunk = board || cells;
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns a side length, often next to a multiple of unit.
+ */
+static int random_side(struct life_xoshiro *rng, int unit, int max) {
+    if (random_below(rng, 2) == 0) {
+        int multiples = max / unit;
+        int side = unit * (int)(1 + random_below(rng, multiples)) + (int)random_below(rng, 3) - 1;
+        return side < 1 ? 1 : side;
+    }
+    return 1 + (int)random_below(rng, max);
+}
+
+/**
+ * @brief Draws board number index.
+ *
+ * @param run Filled in; the kernel and thread count are left to the caller.
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int random_case(const struct life_conform_options *options, long long index, struct life_conform_case *run) {
+    struct life_xoshiro rng;
+    life_xoshiro_seed(&rng, options->seed + (uint64_t)index * 0xD1B54A32D192ED03ULL);
+
+    int large = random_below(&rng, LARGE_EVERY) == 0;
+    run->width = random_side(&rng, 64, large ? LARGE_WIDTH : SMALL_SIZE);
+    run->height = random_side(&rng, LIFE_TILE_ROWS, large ? LARGE_HEIGHT : SMALL_SIZE);
+    run->edges = random_below(&rng, 2) == 0 ? LIFE_EDGES_WRAP : LIFE_EDGES_CLIP;
+    run->rule = options->rule;
+    if (options->random_rules && random_below(&rng, 2) == 0) {
+        run->rule.birth = (uint16_t)(life_xoshiro_next(&rng) & 0x1fe);     // Never B0
+        run->rule.survival = (uint16_t)(life_xoshiro_next(&rng) & 0x1ff);
+    }
+    run->stats = (int)random_below(&rng, 2);
+    run->generations = 1 + random_below(&rng, LIFE_CONFORM_MAX_GENERATIONS);
+    long long chunking = random_below(&rng, 3);
+    run->chunk = chunking == 0 ? 1 : chunking == 1 ? run->generations : 1 + random_below(&rng, run->generations);
+
+    size_t count = (size_t)run->width * (size_t)run->height;
+    run->cells = calloc(count, 1);
+    if (run->cells == NULL) {
+        return -1;
+    }
+    int density = densities[random_below(&rng, sizeof(densities) / sizeof(densities[0]))];
+    int top = 0, left = 0, height = run->height, width = run->width;
+    if (random_below(&rng, 2) == 0) {
+        height = 1 + (int)random_below(&rng, run->height);
+        width = 1 + (int)random_below(&rng, run->width);
+        top = (int)random_below(&rng, run->height - height + 1);
+        left = (int)random_below(&rng, run->width - width + 1);
+    }
+    for (int x = top; x < top + height; x++) {
+        for (int y = left; y < left + width; y++) {
+            run->cells[(size_t)x * run->width + y] = random_below(&rng, 100) < density;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief A kernel on one instruction set, or another engine.
+ */
+struct variant {
+    enum life_conform_engine engine;
+    enum life_kernel kernel;
+    const char *isa;
+};
+
+/**
+ * @brief Lists what every board is run through: each kernel, the simd
+ * kernel once per instruction set the CPU supports, then the other
+ * engines.
+ *
+ * @return int Number of variants.
+ */
+static int list_variants(struct variant *variants) {
+    int count = 0;
+    for (int kernel = 0; kernel < LIFE_KERNEL_COUNT; kernel++) {
+        if (kernel != LIFE_KERNEL_SIMD) {
+            variants[count++] = (struct variant){ LIFE_CONFORM_GRID, (enum life_kernel)kernel, NULL };
+            continue;
+        }
+        for (size_t i = 0; i < sizeof(isas) / sizeof(isas[0]); i++) {
+            if (life_simd_select(isas[i]) == 0) {
+                variants[count++] = (struct variant){ LIFE_CONFORM_GRID, LIFE_KERNEL_SIMD, isas[i] };
+            }
+        }
+    }
+    for (int engine = LIFE_CONFORM_GRID + 1; engine < LIFE_CONFORM_ENGINE_COUNT; engine++) {
+        variants[count++] = (struct variant){ (enum life_conform_engine)engine, LIFE_KERNEL_PACKED, NULL };
+    }
+    return count;
+}
+
+int life_conform_run(const struct life_conform_options *options, struct life_conform_result *result) {
+    memset(result, 0, sizeof(*result));
+    struct variant variants[LIFE_KERNEL_COUNT + sizeof(isas) / sizeof(isas[0]) + LIFE_CONFORM_ENGINE_COUNT];
+    const char *isa = life_simd_isa();  // Restored at the end
+    result->variants = list_variants(variants);
+    struct life_pool *pools[LIFE_CONFORM_THREADS + 1] = { NULL };
+    int status = 0;
+    for (int threads = 2; threads <= LIFE_CONFORM_THREADS && status == 0; threads++) {
+        pools[threads] = life_pool_create(threads);
+        status = pools[threads] == NULL ? -1 : 0;
+    }
+
+    for (long long index = 0; index < options->boards && status == 0 && !result->failed; index++) {
+        struct life_conform_case run;
+        if (random_case(options, index, &run) != 0) {
+            status = -1;
+            break;
+        }
+        struct expected *expected = malloc((size_t)chunk_count(&run) * sizeof(*expected));
+        if (expected == NULL || run_reference(&run, expected) != 0) {
+            free(expected);
+            free(run.cells);
+            status = -1;
+            break;
+        }
+
+        for (int v = 0; v < result->variants && status == 0 && !result->failed; v++) {
+            run.engine = variants[v].engine;
+            run.kernel = variants[v].kernel;
+            run.isa = variants[v].isa;
+            // The sparse plane runs a padded copy, against its own reference
+            struct life_conform_case padded = { 0 };
+            struct life_conform_case *board = &run;
+            if (run.engine == LIFE_CONFORM_SPARSE) {
+                if (pad_case(&run, (int)run.generations, &padded) != 0) {
+                    status = -1;
+                    break;
+                }
+                board = &padded;
+            }
+            for (int threads = 1; threads <= LIFE_CONFORM_THREADS && status == 0 && !result->failed; threads++) {
+                board->threads = threads;
+                if (!engine_runs(board)) {
+                    continue;
+                }
+                status = board == &run ? run_engine(&run, pools[threads], expected, &result->generation, &result->what)
+                                       : check(board, pools, &result->generation, &result->what);
+                result->runs++;
+                if (status == 1) {
+                    result->failed = 1;
+                    result->board = index;
+                    status = copy_case(board, &result->failure) != 0 ||
+                             shrink(&result->failure, pools, &result->generation, &result->what) != 0 ? -1 : 0;
+                }
+            }
+            free(padded.cells);
+        }
+        free(expected);
+        free(run.cells);
+        result->boards++;
+    }
+
+    for (int threads = 2; threads <= LIFE_CONFORM_THREADS; threads++) {
+        life_pool_free(pools[threads]);
+    }
+    life_simd_select(isa);
+    return status;
+}
+
+void life_conform_label(const struct life_conform_case *run, char *text, size_t size) {
+    static const char *const engines[LIFE_CONFORM_ENGINE_COUNT] = { "grid", "ensemble", "sparse", "domain", "mapped" };
+    if (run->engine == LIFE_CONFORM_GRID) {
+        snprintf(text, size, "%s%s%s", life_kernel_name(run->kernel), run->isa != NULL ? "/" : "",
+                 run->isa != NULL ? run->isa : "");
+    } else {
+        snprintf(text, size, "%s%s", engines[run->engine],
+                 run->engine == LIFE_CONFORM_ENSEMBLE && run->threads > 1 ? " batch" : "");
+    }
+}
+
+void life_conform_release(struct life_conform_result *result) {
+    free(result->failure.cells);
+    result->failure.cells = NULL;
+}
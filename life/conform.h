@@ -0,0 +1,138 @@
+/*******************************************************************
+ * Conway's Game of Life - Kernel Conformance
+ *
+ * Author: hrosicka
+ * Description:
+ *   Differential testing of the step kernels against the scalar
+ *   reference (reference.h). Random boards are run through every
+ *   kernel with every thread count from 1 to LIFE_CONFORM_THREADS, and
+ *   the hash of the board is compared with the reference after every
+ *   call to life_grid_step_n(). The simd kernel is run once per
+ *   instruction set the CPU supports, and the other engines (see enum
+ *   life_conform_engine) run the same boards.
+ *
+ * How It Works:
+ *   - Board i is drawn from a xoshiro256** generator seeded with the
+ *     seed and i, so a failing board can be run again on its own.
+ *   - Widths and heights are often chosen next to a multiple of 64
+ *     columns or LIFE_TILE_ROWS rows, where the word and tile edges
+ *     are. One board in 16 is wide and tall enough for the blocked
+ *     kernel to cut it into several bands. Cells are alive with one of
+ *     several densities, on the whole board or in a random rectangle
+ *     of it, so that tiles are skipped. Both edge modes are used.
+ *   - Each board is advanced 1 to LIFE_CONFORM_MAX_GENERATIONS
+ *     generations, one at a time, all at once, or in chunks of a random
+ *     size, with the per-tile statistics on or off. With statistics on
+ *     the population, births and deaths are checked as well.
+ *   - The ensemble (ensemble.h) carries the board on every third of
+ *     its 64 lanes, so a cell that leaks into a neighboring lane shows
+ *     up; with more than one thread, life_ensemble_run_batch() runs
+ *     more copies than the threads have groups, and the population of
+ *     each is checked at the end.
+ *   - The unbounded plane (sparse.h) runs a clipped copy of the board
+ *     with as many dead rows and columns around it as generations are
+ *     run, so the edge is never reached and the results agree.
+ *   - The domain (domain.h) runs the board in 1 to
+ *     LIFE_CONFORM_THREADS worker processes, and the memory-mapped board
+ *     (mapped.h) in a temporary file; the mapped board only runs the
+ *     small boards.
+ *   - The first run that differs is shrunk: it is retried with one
+ *     thread, without statistics and one generation per call, then the
+ *     board is cropped from each side and live cells are killed in
+ *     ever smaller groups, keeping every change after which the run
+ *     still differs, until none helps.
+ *******************************************************************/
+
+#ifndef LIFE_CONFORM_H
+#define LIFE_CONFORM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "grid.h"
+
+#define LIFE_CONFORM_THREADS 4              // Thread counts 1 to this are tried
+#define LIFE_CONFORM_MAX_GENERATIONS 40     // Most generations a board is run
+
+/**
+ * @brief Engines a board is run through.
+ */
+enum life_conform_engine {
+    LIFE_CONFORM_GRID,          // life_grid_step_n() with the case's kernel
+    LIFE_CONFORM_ENSEMBLE,      // life_ensemble_step_n(), or life_ensemble_run_batch() with threads
+    LIFE_CONFORM_SPARSE,        // life_sparse_step_n() on a padded copy of the board
+    LIFE_CONFORM_DOMAIN,        // life_domain_step_n(), one worker process per thread
+    LIFE_CONFORM_MAPPED,        // life_mapped_step_n() on a temporary file
+    LIFE_CONFORM_ENGINE_COUNT
+};
+
+/**
+ * @brief Parameters of a conformance run.
+ */
+struct life_conform_options {
+    long long boards;           // Number of random boards
+    uint64_t seed;              // Seed of the first board
+    int random_rules;           // Give half of the boards a random life-like rule
+    struct life_ruleset rule;   // Rule of the other boards
+};
+
+/**
+ * @brief One run of a board through a kernel.
+ */
+struct life_conform_case {
+    int width;                  // Board size
+    int height;
+    enum life_edges edges;
+    struct life_ruleset rule;
+    enum life_conform_engine engine;
+    enum life_kernel kernel;    // Kernel of LIFE_CONFORM_GRID
+    const char *isa;            // Instruction set of the simd kernel, or NULL
+    int threads;                // Threads of the pool, 1 for none
+    int stats;                  // Per-tile statistics on
+    long long generations;      // Generations run
+    long long chunk;            // Generations per call to life_grid_step_n()
+    uint8_t *cells;             // The first generation, width * height bytes in row-major order
+};
+
+/**
+ * @brief Result of a conformance run.
+ */
+struct life_conform_result {
+    long long boards;           // Boards run
+    long long runs;             // Runs of a board through a kernel
+    int variants;               // Kernels, instruction sets and engines each board is run through
+    int failed;                 // Set if a run differed from the reference
+    long long board;            // Number of the failing board
+    struct life_conform_case failure;  // The failing run, shrunk
+    long long generation;       // First checked generation that differs
+    const char *what;           // What differs: "cells", "lanes", "population" or "births and deaths"
+};
+
+/**
+ * @brief Runs boards through the kernels until one differs from the
+ * reference or all have been run.
+ *
+ * @param options The parameters.
+ * @param result Filled in with the result; release it with
+ *               life_conform_release().
+ * @return int 0 on success (whether or not a run differed), -1 if out
+ *             of memory or no temporary file can be created.
+ */
+int life_conform_run(const struct life_conform_options *options, struct life_conform_result *result);
+
+/**
+ * @brief Names what a run went through: "packed", "simd/avx2",
+ * "ensemble batch", "sparse", ...
+ *
+ * @param run The run.
+ * @param text Output buffer.
+ * @param size Size of text.
+ */
+void life_conform_label(const struct life_conform_case *run, char *text, size_t size);
+
+/**
+ * @brief Frees the failing board of a result.
+ */
+void life_conform_release(struct life_conform_result *result);
+
+#endif // LIFE_CONFORM_H
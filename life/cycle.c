@@ -0,0 +1,235 @@
+/*******************************************************************
+ * Conway's Game of Life - Cycle Detection
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the cycle tracker declared in cycle.h.
+ *******************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cycle.h"
+
+/**
+ * @brief 64-bit finalizer of SplitMix64; spreads every input bit.
+ */
+static inline uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Hash contribution of one board word; empty words contribute nothing.
+ */
+static inline uint64_t word_key(size_t index, uint64_t word) {
+    return word == 0 ? 0 : mix(word ^ mix((uint64_t)index + 1));
+}
+
+/**
+ * @brief Ring index of generation g in the history.
+ *
+ * The ring holds the current generation and the LIFE_CYCLE_HISTORY
+ * before it, so periods up to LIFE_CYCLE_HISTORY can be found.
+ */
+static inline size_t slot(long long g) {
+    return (size_t)(g % (LIFE_CYCLE_HISTORY + 1));
+}
+
+static size_t board_words(const struct life_grid *grid) {
+    return (size_t)grid->words * (size_t)grid->height;
+}
+
+/**
+ * @brief Hashes the whole board.
+ */
+static uint64_t hash_board(const struct life_grid *grid) {
+    size_t total = board_words(grid);
+    uint64_t hash = 0;
+    for (size_t i = 0; i < total; i++) {
+        hash ^= word_key(i, grid->cells[i]);
+    }
+    return hash;
+}
+
+/**
+ * @brief Updates the hash after a packed step from the changed tiles.
+ *
+ * The previous generation is still in grid->next, so each changed
+ * word is XORed out with its old value and back in with its new one.
+ */
+static uint64_t rehash_changed(const struct life_grid *grid, uint64_t hash) {
+    const int words = grid->words;
+    for (int tr = 0; tr < grid->tile_rows; tr++) {
+        int row_end = (tr + 1) * LIFE_TILE_ROWS;
+        if (row_end > grid->height) {
+            row_end = grid->height;
+        }
+        for (int tc = 0; tc < words; tc++) {
+            if (!grid->changed[(size_t)tr * words + tc]) {
+                continue;
+            }
+            for (int x = tr * LIFE_TILE_ROWS; x < row_end; x++) {
+                size_t i = (size_t)x * words + tc;
+                hash ^= word_key(i, grid->next[i]) ^ word_key(i, grid->cells[i]);
+            }
+        }
+    }
+    return hash;
+}
+
+void life_cycle_init(struct life_cycle *cycle, const struct life_grid *grid, long long generation) {
+    memset(cycle, 0, sizeof(*cycle));
+    cycle->hash = hash_board(grid);
+    cycle->generation = generation;
+    cycle->history[slot(generation)] = cycle->hash;
+    cycle->saved_hash = cycle->hash;
+    cycle->saved_power = 1;
+}
+
+void life_cycle_release(struct life_cycle *cycle) {
+    free(cycle->states);
+    free(cycle->state_hashes);
+    cycle->states = NULL;
+    cycle->state_hashes = NULL;
+}
+
+/**
+ * @brief Drops a candidate cycle that turned out to be a hash collision.
+ */
+static void reject_candidate(struct life_cycle *cycle) {
+    life_cycle_release(cycle);
+    cycle->period = 0;
+}
+
+/**
+ * @brief Copies the current board into recorded state k.
+ */
+static void record_state(struct life_cycle *cycle, const struct life_grid *grid, long long k) {
+    size_t total = board_words(grid);
+    memcpy(cycle->states + (size_t)k * total, grid->cells, total * sizeof(uint64_t));
+    cycle->state_hashes[k] = cycle->hash;
+}
+
+/**
+ * @brief Returns the period the current hash repeats, or 0.
+ *
+ * Checks the remembered generations first, then Brent's saved hash.
+ */
+static long long find_period(const struct life_cycle *cycle) {
+    long long g = cycle->generation;
+    for (long long p = 1; p <= cycle->remembered; p++) {
+        if (cycle->history[slot(g - p)] == cycle->hash) {
+            return p;
+        }
+    }
+    return cycle->saved_hash == cycle->hash ? cycle->saved_age : 0;
+}
+
+/**
+ * @brief Looks for a repeated hash and starts recording a candidate cycle.
+ */
+static void search(struct life_cycle *cycle, const struct life_grid *grid) {
+    long long g = cycle->generation;
+    long long p = find_period(cycle);
+    if (p != 0) {
+        size_t total = board_words(grid);
+        cycle->states = malloc((size_t)p * total * sizeof(uint64_t));
+        cycle->state_hashes = malloc((size_t)p * sizeof(uint64_t));
+        if (cycle->states == NULL || cycle->state_hashes == NULL) {
+            life_cycle_release(cycle);
+            cycle->disabled = 1;
+            return;
+        }
+        cycle->period = p;
+        cycle->start = g;
+        record_state(cycle, grid, 0);
+    }
+}
+
+/**
+ * @brief Computes one generation and updates the hash, history and candidate.
+ */
+static int step_one(struct life_cycle *cycle, struct life_grid *grid) {
+    // Only a tiled step from a board the engine already knows marks the changed tiles
+    int full = grid->all_active || grid->kernel == LIFE_KERNEL_SIMD;
+    if (life_grid_step_n(grid, 1) != 0) {
+        return -1;
+    }
+    cycle->hash = full ? hash_board(grid) : rehash_changed(grid, cycle->hash);
+    cycle->generation++;
+    long long g = cycle->generation;
+    cycle->history[slot(g)] = cycle->hash;
+    if (cycle->remembered < LIFE_CYCLE_HISTORY) {
+        cycle->remembered++;
+    }
+    cycle->saved_age++;
+
+    if (cycle->disabled) {
+        return 0;
+    }
+    if (cycle->period == 0) {
+        search(cycle, grid);
+        if (cycle->period == 0 && cycle->saved_age >= cycle->saved_power) {
+            cycle->saved_hash = cycle->hash;
+            cycle->saved_power *= 2;
+            cycle->saved_age = 0;
+        }
+        return 0;
+    }
+
+    // Recording a candidate: state k must repeat the hash of generation start - period + k
+    long long k = g - cycle->start;
+    if (k < cycle->period) {
+        if (cycle->period <= LIFE_CYCLE_HISTORY && cycle->hash != cycle->history[slot(g - cycle->period)]) {
+            reject_candidate(cycle);
+            search(cycle, grid);
+            return 0;
+        }
+        record_state(cycle, grid, k);
+        return 0;
+    }
+    size_t total = board_words(grid);
+    if (cycle->hash == cycle->state_hashes[0] &&
+        memcmp(grid->cells, cycle->states, total * sizeof(uint64_t)) == 0) {
+        cycle->confirmed = 1;
+    } else {
+        reject_candidate(cycle);
+        search(cycle, grid);
+    }
+    return 0;
+}
+
+/**
+ * @brief Puts the board at a generation of the confirmed cycle.
+ */
+static void seek(struct life_cycle *cycle, struct life_grid *grid, long long target) {
+    long long from = (cycle->generation - cycle->start) % cycle->period;
+    long long to = (target - cycle->start) % cycle->period;
+    cycle->generation = target;
+    if (from == to) {
+        return;  // The board already holds this state
+    }
+    size_t total = board_words(grid);
+    memcpy(grid->cells, cycle->states + (size_t)to * total, total * sizeof(uint64_t));
+    cycle->hash = cycle->state_hashes[to];
+    grid->all_active = 1;
+}
+
+int life_cycle_advance(struct life_cycle *cycle, struct life_grid *grid, long long n) {
+    long long target = cycle->generation + n;
+    while (!cycle->confirmed && cycle->generation < target) {
+        if (step_one(cycle, grid) != 0) {
+            return -1;
+        }
+    }
+    if (cycle->confirmed) {
+        seek(cycle, grid, target);
+    }
+    return 0;
+}
+
+long long life_cycle_period(const struct life_cycle *cycle) {
+    return cycle->confirmed ? cycle->period : 0;
+}
@@ -0,0 +1,93 @@
+/*******************************************************************
+ * Conway's Game of Life - Cycle Detection
+ *
+ * Author: hrosicka
+ * Description:
+ *   Finds out when a board starts repeating itself: a still life
+ *   (period 1) or an oscillator such as the blinker (period 2) or
+ *   the pulsar (period 3). From then on there is nothing left to
+ *   compute, so any later generation can be produced without
+ *   stepping.
+ *
+ * How It Works:
+ *   - The board is summarized by a Zobrist-style hash: the XOR of a
+ *     mixed key for every non-zero word. After a generation only the
+ *     tiles the engine marked as changed are rehashed, by XORing the
+ *     old words out and the new words in.
+ *   - The hashes of the last LIFE_CYCLE_HISTORY generations are kept
+ *     in a ring. A repeated hash p generations apart is a candidate
+ *     cycle of period p.
+ *   - Longer periods (a glider circling a torus) are caught by
+ *     Brent's method: the hash is saved at generations a power of two
+ *     apart and compared against every later one, so any period is
+ *     found within a few times its length, in constant memory.
+ *   - The next p generations are recorded. If the board then equals
+ *     the first recorded state word for word, the cycle is confirmed
+ *     (a hash collision cannot produce a false cycle).
+ *   - Once confirmed, generation t is stored state (t - start) mod p,
+ *     and life_cycle_advance() copies it instead of stepping.
+ *******************************************************************/
+
+#ifndef LIFE_CYCLE_H
+#define LIFE_CYCLE_H
+
+#include <stdint.h>
+
+#include "grid.h"
+
+#define LIFE_CYCLE_HISTORY 64   // Generations remembered for short periods
+
+/**
+ * @brief Cycle detection state of one board.
+ */
+struct life_cycle {
+    uint64_t hash;          // Hash of the board at generation
+    long long generation;   // Generation the board is at
+    uint64_t history[LIFE_CYCLE_HISTORY + 1];  // Hashes of the last generations, see slot()
+    int remembered;         // Earlier generations in history (up to LIFE_CYCLE_HISTORY)
+    uint64_t saved_hash;    // Brent's method: hash saved at the last power of two
+    long long saved_power;  // Steps until the next save
+    long long saved_age;    // Steps since the hash was saved
+    long long period;       // Candidate or confirmed period, 0 if none
+    long long start;        // First generation of the recorded cycle
+    int confirmed;          // Set when the cycle has been verified
+    int disabled;           // Set if the states do not fit in memory
+    uint64_t *states;       // period boards of height * words words
+    uint64_t *state_hashes; // Hash of each recorded state
+};
+
+/**
+ * @brief Starts tracking a board.
+ *
+ * @param cycle The state to initialize.
+ * @param grid The board.
+ * @param generation Generation the board is at.
+ */
+void life_cycle_init(struct life_cycle *cycle, const struct life_grid *grid, long long generation);
+
+/**
+ * @brief Frees the states recorded by the tracker.
+ */
+void life_cycle_release(struct life_cycle *cycle);
+
+/**
+ * @brief Advances the board by n generations.
+ *
+ * Steps one generation at a time, with grid->kernel, until a cycle is
+ * confirmed; after that the target generation is copied from the
+ * recorded states, so the cost no longer depends on n. The board
+ * must not be changed other than through this function.
+ *
+ * @param cycle The tracker.
+ * @param grid The board.
+ * @param n Number of generations.
+ * @return int 0 on success, -1 if out of memory.
+ */
+int life_cycle_advance(struct life_cycle *cycle, struct life_grid *grid, long long n);
+
+/**
+ * @brief Returns the period of the board, or 0 if no cycle is confirmed yet.
+ */
+long long life_cycle_period(const struct life_cycle *cycle);
+
+#endif // LIFE_CYCLE_H
@@ -0,0 +1,352 @@
+/*******************************************************************
+ * Conway's Game of Life - Domain-Decomposed Board
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the worker processes declared in domain.h.
+ *******************************************************************/
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+#include "domain.h"
+
+enum command {
+    COMMAND_SYNC,     // Nothing; returns once every worker is ready
+    COMMAND_STEP,     // Step the bands
+    COMMAND_READ,     // Copy a window into the view
+    COMMAND_COUNT,    // Count cells and tiles
+    COMMAND_EXIT      // Leave the worker loop
+};
+
+enum side {
+    SIDE_TOP,         // First row of a band
+    SIDE_BOTTOM       // Last row of a band
+};
+
+/**
+ * @brief Start of the memory shared by the caller and the workers.
+ *
+ * Followed by the halo slots (two generations of two rows per worker),
+ * one row of zeros, and the view.
+ */
+struct shared {
+    pthread_barrier_t command_barrier;  // Workers and caller
+    pthread_barrier_t halo_barrier;     // Workers only
+    enum command command;
+    long long steps;                    // Generations of COMMAND_STEP
+    int read_x;                         // Window of COMMAND_READ
+    int read_rows;
+    int read_words;
+    atomic_int failed;                  // Set by a worker that ran out of memory
+    long long populations[LIFE_DOMAIN_MAX_WORKERS];
+    long long tiles_stepped[LIFE_DOMAIN_MAX_WORKERS];
+    long long tiles_skipped[LIFE_DOMAIN_MAX_WORKERS];
+};
+
+struct life_domain {
+    struct life_domain_options options;
+    int words;                  // 64-bit words per row
+    struct shared *shared;
+    size_t shared_size;
+    uint64_t *slots;            // Halo slots, see slot()
+    uint64_t *zeros;            // Outer halo of a clipped board
+    uint64_t *view;             // Window copied by COMMAND_READ
+    pid_t pids[LIFE_DOMAIN_MAX_WORKERS];
+};
+
+/**
+ * @brief Returns the slot of one row a worker publishes for a generation.
+ */
+static uint64_t *slot(const struct life_domain *domain, int worker, long long generation, enum side side) {
+    size_t index = ((size_t)worker * 2 + (size_t)(generation & 1)) * 2 + side;
+    return domain->slots + index * (size_t)domain->words;
+}
+
+/**
+ * @brief Returns the first row of a worker's band.
+ */
+static int band_start(const struct life_domain *domain, int worker) {
+    return (int)((long long)domain->options.height * worker / domain->options.workers);
+}
+
+/**
+ * @brief Returns the row published by the band above a worker's band,
+ * or the row of zeros at the top of a clipped board.
+ */
+static const uint64_t *row_above(const struct life_domain *domain, int worker, long long generation) {
+    if (worker == 0 && domain->options.edges == LIFE_EDGES_CLIP) {
+        return domain->zeros;
+    }
+    int above = (worker + domain->options.workers - 1) % domain->options.workers;
+    return slot(domain, above, generation, SIDE_BOTTOM);
+}
+
+/**
+ * @brief Returns the row published by the band below a worker's band,
+ * or the row of zeros at the bottom of a clipped board.
+ */
+static const uint64_t *row_below(const struct life_domain *domain, int worker, long long generation) {
+    int last = domain->options.workers - 1;
+    if (worker == last && domain->options.edges == LIFE_EDGES_CLIP) {
+        return domain->zeros;
+    }
+    return slot(domain, worker == last ? 0 : worker + 1, generation, SIDE_TOP);
+}
+
+/**
+ * @brief Steps a worker's band n generations, exchanging halo rows
+ * before each one.
+ *
+ * A worker without a band (its setup failed) still waits at every
+ * barrier, so the other workers do not block.
+ *
+ * @param generation Generations the worker has computed so far; updated.
+ */
+static void step_worker(struct life_domain *domain, int worker, struct life_grid *band,
+                        long long *generation, long long n) {
+    struct shared *shared = domain->shared;
+    const size_t row_size = (size_t)domain->words * sizeof(uint64_t);
+    for (long long i = 0; i < n; i++, (*generation)++) {
+        if (band != NULL) {
+            memcpy(slot(domain, worker, *generation, SIDE_TOP), band->cells + (size_t)band->words, row_size);
+            memcpy(slot(domain, worker, *generation, SIDE_BOTTOM),
+                   band->cells + (size_t)(band->height - 2) * band->words, row_size);
+        }
+        pthread_barrier_wait(&shared->halo_barrier);
+        if (band == NULL) {
+            continue;
+        }
+        life_grid_write_row(band, 0, row_above(domain, worker, *generation));
+        life_grid_write_row(band, band->height - 1, row_below(domain, worker, *generation));
+        if (life_grid_step_n(band, 1) != 0) {
+            atomic_store(&shared->failed, 1);
+        }
+    }
+}
+
+/**
+ * @brief Copies the rows of a worker's band that fall in the window
+ * of COMMAND_READ into the view.
+ */
+static void read_worker(struct life_domain *domain, int worker, const struct life_grid *band) {
+    const struct shared *shared = domain->shared;
+    int first = band_start(domain, worker);
+    int end = band_start(domain, worker + 1);
+    int words = shared->read_words < band->words ? shared->read_words : band->words;
+    for (int x = first; x < end; x++) {
+        if (x < shared->read_x || x >= shared->read_x + shared->read_rows) {
+            continue;
+        }
+        memcpy(domain->view + (size_t)(x - shared->read_x) * shared->read_words,
+               band->cells + (size_t)(x - first + 1) * band->words, (size_t)words * sizeof(uint64_t));
+    }
+}
+
+/**
+ * @brief Counts the live cells of a band, leaving out its halo rows,
+ * which are copies of rows of other bands.
+ */
+static long long band_population(const struct life_grid *band) {
+    long long population = life_grid_population(band);
+    const uint64_t *last = band->cells + (size_t)(band->height - 1) * band->words;
+    for (int w = 0; w < band->words; w++) {
+        population -= __builtin_popcountll(band->cells[w]) + __builtin_popcountll(last[w]);
+    }
+    return population;
+}
+
+/**
+ * @brief Main function of a worker process: sets up its band, then
+ * carries out commands until COMMAND_EXIT.
+ */
+static void run_worker(struct life_domain *domain, int worker, life_domain_fill fill, void *arg) {
+    struct shared *shared = domain->shared;
+    int first = band_start(domain, worker);
+    int rows = band_start(domain, worker + 1) - first;
+
+    struct life_grid *band = life_grid_create(domain->options.width, rows + 2, domain->options.edges);
+    if (band != NULL) {
+        band->kernel = domain->options.kernel;
+        band->pool = domain->options.threads > 1 ? life_pool_create(domain->options.threads) : NULL;
+        if ((domain->options.threads > 1 && band->pool == NULL) || fill(arg, band, first, rows) != 0) {
+            life_pool_free(band->pool);
+            life_grid_free(band);
+            band = NULL;
+        }
+    }
+    if (band == NULL) {
+        atomic_store(&shared->failed, 1);
+    }
+
+    long long generation = 0;
+    for (;;) {
+        pthread_barrier_wait(&shared->command_barrier);
+        if (shared->command == COMMAND_EXIT) {
+            break;
+        }
+        if (shared->command == COMMAND_STEP) {
+            step_worker(domain, worker, band, &generation, shared->steps);
+        } else if (band != NULL && shared->command == COMMAND_READ) {
+            read_worker(domain, worker, band);
+        } else if (band != NULL && shared->command == COMMAND_COUNT) {
+            shared->populations[worker] = band_population(band);
+            shared->tiles_stepped[worker] = band->tiles_stepped;
+            shared->tiles_skipped[worker] = band->tiles_skipped;
+        }
+        pthread_barrier_wait(&shared->command_barrier);
+    }
+
+    if (band != NULL) {
+        life_pool_free(band->pool);
+        life_grid_free(band);
+    }
+}
+
+/**
+ * @brief Has every worker carry out one command and waits until they are done.
+ */
+static void run_command(struct life_domain *domain, enum command command) {
+    domain->shared->command = command;
+    pthread_barrier_wait(&domain->shared->command_barrier);
+    if (command != COMMAND_EXIT) {
+        pthread_barrier_wait(&domain->shared->command_barrier);
+    }
+}
+
+/**
+ * @brief Kills the workers started so far and releases everything.
+ */
+static void abandon(struct life_domain *domain, int started) {
+    for (int i = 0; i < started; i++) {
+        kill(domain->pids[i], SIGKILL);
+        waitpid(domain->pids[i], NULL, 0);
+    }
+    pthread_barrier_destroy(&domain->shared->command_barrier);
+    pthread_barrier_destroy(&domain->shared->halo_barrier);
+    munmap(domain->shared, domain->shared_size);
+    free(domain);
+}
+
+struct life_domain *life_domain_create(const struct life_domain_options *options,
+                                       life_domain_fill fill, void *arg) {
+    if (options->width <= 0 || options->height <= 0 || options->workers <= 0 ||
+        options->workers > LIFE_DOMAIN_MAX_WORKERS || options->workers > options->height) {
+        return NULL;
+    }
+    struct life_domain *domain = calloc(1, sizeof(*domain));
+    if (domain == NULL) {
+        return NULL;
+    }
+    domain->options = *options;
+    domain->words = (options->width + 63) / 64;
+
+    // Halo slots and the row of zeros, then the view
+    size_t header = (sizeof(struct shared) + 63) & ~(size_t)63;
+    size_t slot_words = ((size_t)options->workers * 4 + 1) * (size_t)domain->words;
+    size_t view_words = (size_t)options->view_rows * (size_t)options->view_words;
+    domain->shared_size = header + (slot_words + view_words) * sizeof(uint64_t);
+    void *memory = mmap(NULL, domain->shared_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        free(domain);
+        return NULL;
+    }
+    domain->shared = memory;
+    domain->slots = (uint64_t *)((char *)memory + header);
+    domain->zeros = domain->slots + slot_words - (size_t)domain->words;
+    domain->view = domain->slots + slot_words;
+    atomic_init(&domain->shared->failed, 0);
+
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&domain->shared->command_barrier, &attr, (unsigned)options->workers + 1);
+    pthread_barrier_init(&domain->shared->halo_barrier, &attr, (unsigned)options->workers);
+    pthread_barrierattr_destroy(&attr);
+
+    fflush(NULL);
+    for (int i = 0; i < options->workers; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            abandon(domain, i);
+            return NULL;
+        }
+        if (pid == 0) {
+#ifdef __linux__
+            // Do not outlive a caller that dies without life_domain_free()
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+            run_worker(domain, i, fill, arg);
+            _exit(0);
+        }
+        domain->pids[i] = pid;
+    }
+
+    run_command(domain, COMMAND_SYNC);
+    if (atomic_load(&domain->shared->failed)) {
+        life_domain_free(domain);
+        return NULL;
+    }
+    return domain;
+}
+
+void life_domain_free(struct life_domain *domain) {
+    if (domain == NULL) {
+        return;
+    }
+    run_command(domain, COMMAND_EXIT);
+    for (int i = 0; i < domain->options.workers; i++) {
+        waitpid(domain->pids[i], NULL, 0);
+    }
+    pthread_barrier_destroy(&domain->shared->command_barrier);
+    pthread_barrier_destroy(&domain->shared->halo_barrier);
+    munmap(domain->shared, domain->shared_size);
+    free(domain);
+}
+
+int life_domain_step_n(struct life_domain *domain, long long n) {
+    domain->shared->steps = n;
+    run_command(domain, COMMAND_STEP);
+    return atomic_load(&domain->shared->failed) ? -1 : 0;
+}
+
+void life_domain_read_rows(struct life_domain *domain, int x, int rows, int words, uint64_t *out) {
+    struct shared *shared = domain->shared;
+    size_t size = (size_t)rows * (size_t)words * sizeof(uint64_t);
+    // Rows outside the board, and words past its last column, read as dead
+    memset(domain->view, 0, size);
+    shared->read_x = x;
+    shared->read_rows = rows;
+    shared->read_words = words;
+    run_command(domain, COMMAND_READ);
+    memcpy(out, domain->view, size);
+}
+
+long long life_domain_population(struct life_domain *domain) {
+    run_command(domain, COMMAND_COUNT);
+    long long population = 0;
+    for (int i = 0; i < domain->options.workers; i++) {
+        population += domain->shared->populations[i];
+    }
+    return population;
+}
+
+double life_domain_skip_ratio(struct life_domain *domain) {
+    run_command(domain, COMMAND_COUNT);
+    long long stepped = 0, skipped = 0;
+    for (int i = 0; i < domain->options.workers; i++) {
+        stepped += domain->shared->tiles_stepped[i];
+        skipped += domain->shared->tiles_skipped[i];
+    }
+    return stepped + skipped == 0 ? 0.0 : (double)skipped / (double)(stepped + skipped);
+}
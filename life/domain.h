@@ -0,0 +1,128 @@
+/*******************************************************************
+ * Conway's Game of Life - Domain-Decomposed Board
+ *
+ * Author: hrosicka
+ * Description:
+ *   Runs one fixed board in several worker processes, so that a board
+ *   too large for the memory of one process can still be simulated.
+ *   The board is cut into bands of whole rows, one per worker; no
+ *   process ever holds the whole board.
+ *
+ * How It Works:
+ *   - Each worker keeps its band in a life_grid of its own with one
+ *     extra row above and below it: the halo rows.
+ *   - Before every generation, each worker publishes its first and
+ *     last row in memory shared by all the workers, waits for the
+ *     others at a process-shared barrier, and copies the rows of its
+ *     neighbors into its halo rows with life_grid_write_row(). On a
+ *     torus the first and last bands are neighbors; on a clipped
+ *     board their outer halo rows stay dead.
+ *   - The rows are published in two sets of slots, one for even and
+ *     one for odd generations, so one barrier per generation is
+ *     enough: no worker can overwrite a set before every other worker
+ *     has read it.
+ *   - Every band then steps one generation with the usual kernels and
+ *     tile skipping. Columns never cross a band, so each worker handles
+ *     the left and right edges itself, and the result is identical to
+ *     the same board run in a single process.
+ *   - The calling process only sends commands (step, read a window,
+ *     count cells) through the shared memory and waits for the workers
+ *     to finish them.
+ *
+ * Coordinates follow the rest of the repository: x is the row index
+ * and y is the column index.
+ *******************************************************************/
+
+#ifndef LIFE_DOMAIN_H
+#define LIFE_DOMAIN_H
+
+#include <stdint.h>
+
+#include "grid.h"
+
+#define LIFE_DOMAIN_MAX_WORKERS 256   // Most worker processes of one board
+
+struct life_domain;
+
+/**
+ * @brief Fills a worker's band with its part of the starting board.
+ *
+ * Called in each worker process once it has started.
+ *
+ * @param arg The argument given to life_domain_create().
+ * @param band The worker's board. Row x + 1 of band is row first_row + x
+ *             of the whole board; rows 0 and band->height - 1 are the
+ *             halo rows and need not be filled. Set band->rule here.
+ * @param first_row First row of the band on the whole board.
+ * @param rows Number of rows in the band.
+ * @return int 0 on success, -1 on failure.
+ */
+typedef int (*life_domain_fill)(void *arg, struct life_grid *band, int first_row, int rows);
+
+/**
+ * @brief Parameters of a domain-decomposed board.
+ */
+struct life_domain_options {
+    int width;                  // Number of columns
+    int height;                 // Number of rows
+    enum life_edges edges;      // Edge mode of the whole board
+    int workers;                // Worker processes, at most height
+    int threads;                // Threads per worker (1: none)
+    enum life_kernel kernel;    // Step kernel of every worker
+    int view_rows;              // Most rows one life_domain_read_rows() may read
+    int view_words;             // Most words per row it may read
+};
+
+/**
+ * @brief Starts the worker processes and fills their bands.
+ *
+ * Output buffered in stdio is flushed first, so the workers do not
+ * write it again. Must be called before the calling process starts
+ * any threads.
+ *
+ * @param options The parameters.
+ * @param fill Fills each band.
+ * @param arg Passed to fill.
+ * @return struct life_domain* The board, or NULL if the workers could
+ *         not be started, ran out of memory or fill failed.
+ */
+struct life_domain *life_domain_create(const struct life_domain_options *options,
+                                       life_domain_fill fill, void *arg);
+
+/**
+ * @brief Stops the workers and frees the board.
+ */
+void life_domain_free(struct life_domain *domain);
+
+/**
+ * @brief Advances the board n generations.
+ *
+ * @return int 0 on success, -1 if a worker ran out of memory.
+ */
+int life_domain_step_n(struct life_domain *domain, long long n);
+
+/**
+ * @brief Copies rows of the board into bit-packed rows.
+ *
+ * Word w of output row r holds columns 64 * w to 64 * w + 63 of row
+ * x + r, in the layout of a life_grid row.
+ *
+ * @param domain The board.
+ * @param x First row to copy.
+ * @param rows Number of rows, at most view_rows.
+ * @param words 64-bit words per output row, at most view_words.
+ * @param out Output, rows * words words.
+ */
+void life_domain_read_rows(struct life_domain *domain, int x, int rows, int words, uint64_t *out);
+
+/**
+ * @brief Returns the number of live cells.
+ */
+long long life_domain_population(struct life_domain *domain);
+
+/**
+ * @brief Returns the fraction of tiles the workers skipped so far.
+ */
+double life_domain_skip_ratio(struct life_domain *domain);
+
+#endif // LIFE_DOMAIN_H
@@ -0,0 +1,234 @@
+/*******************************************************************
+ * Conway's Game of Life - Bit-Sliced Ensemble
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the ensemble declared in ensemble.h.
+ *******************************************************************/
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "ensemble.h"
+
+/**
+ * @brief Words per row, ghost columns included.
+ */
+static size_t stride_of(const struct life_ensemble *ensemble) {
+    return (size_t)ensemble->width + 2;
+}
+
+struct life_ensemble *life_ensemble_create(int width, int height, enum life_edges edges) {
+    if (width <= 0 || height <= 0) {
+        return NULL;
+    }
+    size_t board = ((size_t)width + 2) * ((size_t)height + 2) * sizeof(uint64_t);
+
+    struct life_arena arena;
+    size_t total = life_arena_block_size(sizeof(struct life_ensemble)) + 2 * life_arena_block_size(board);
+    if (life_arena_init(&arena, total) != 0) {
+        return NULL;
+    }
+    struct life_ensemble *ensemble = life_arena_alloc(&arena, sizeof(*ensemble));
+    ensemble->width = width;
+    ensemble->height = height;
+    ensemble->edges = edges;
+    ensemble->rule = (struct life_ruleset)LIFE_RULE_CONWAY;
+    ensemble->cells = life_arena_alloc(&arena, board);
+    ensemble->next = life_arena_alloc(&arena, board);
+    ensemble->arena = arena;
+    return ensemble;
+}
+
+void life_ensemble_free(struct life_ensemble *ensemble) {
+    if (ensemble == NULL) {
+        return;
+    }
+    // The ensemble itself lives in its arena, so release a copy
+    struct life_arena arena = ensemble->arena;
+    life_arena_release(&arena);
+}
+
+void life_ensemble_clear(struct life_ensemble *ensemble) {
+    memset(ensemble->cells, 0, stride_of(ensemble) * ((size_t)ensemble->height + 2) * sizeof(uint64_t));
+}
+
+int life_ensemble_get(const struct life_ensemble *ensemble, int board, int x, int y) {
+    if (x < 0 || x >= ensemble->height || y < 0 || y >= ensemble->width) {
+        return 0;
+    }
+    uint64_t word = ensemble->cells[((size_t)x + 1) * stride_of(ensemble) + (size_t)y + 1];
+    return (int)((word >> board) & 1);
+}
+
+void life_ensemble_set(struct life_ensemble *ensemble, int board, int x, int y, int alive) {
+    if (x < 0 || x >= ensemble->height || y < 0 || y >= ensemble->width) {
+        return;
+    }
+    uint64_t *word = &ensemble->cells[((size_t)x + 1) * stride_of(ensemble) + (size_t)y + 1];
+    uint64_t bit = 1ULL << board;
+    if (alive) {
+        *word |= bit;
+    } else {
+        *word &= ~bit;
+    }
+}
+
+void life_ensemble_place(struct life_ensemble *ensemble, int board,
+                         const struct life_pattern *patterns, int count) {
+    for (int p = 0; p < count; p++) {
+        const struct life_pattern *pattern = &patterns[p];
+        for (int i = 0; i < pattern->size; i++) {
+            life_ensemble_set(ensemble, board, pattern->start_x + pattern->cells[i][0],
+                              pattern->start_y + pattern->cells[i][1], 1);
+        }
+    }
+}
+
+/**
+ * @brief Fills the ghost frame of the current generation.
+ *
+ * Columns first, so that the row copies carry the corners.
+ */
+static void fill_halo(struct life_ensemble *ensemble) {
+    const size_t stride = stride_of(ensemble);
+    const int width = ensemble->width, height = ensemble->height;
+    uint64_t *cells = ensemble->cells;
+    uint64_t *top = cells;
+    uint64_t *bottom = cells + ((size_t)height + 1) * stride;
+
+    if (ensemble->edges == LIFE_EDGES_CLIP) {
+        for (int x = 1; x <= height; x++) {
+            cells[x * stride] = 0;
+            cells[x * stride + width + 1] = 0;
+        }
+        memset(top, 0, stride * sizeof(uint64_t));
+        memset(bottom, 0, stride * sizeof(uint64_t));
+        return;
+    }
+    for (int x = 1; x <= height; x++) {
+        uint64_t *row = cells + x * stride;
+        row[0] = row[width];
+        row[width + 1] = row[1];
+    }
+    memcpy(top, cells + (size_t)height * stride, stride * sizeof(uint64_t));
+    memcpy(bottom, cells + stride, stride * sizeof(uint64_t));
+}
+
+/**
+ * @brief Computes the next generation of every board.
+ *
+ * Always inlined, so that B3/S23 (rules == NULL) gets its own copy
+ * of the loop built on life_rule().
+ *
+ * @param rules The rule, or NULL for B3/S23.
+ */
+static inline __attribute__((always_inline)) void step_cells(struct life_ensemble *ensemble,
+                                                             const struct life_ruleset *rules) {
+    const size_t stride = stride_of(ensemble);
+    const int width = ensemble->width;
+
+    for (int x = 1; x <= ensemble->height; x++) {
+        const uint64_t *up = ensemble->cells + (x - 1) * stride;
+        const uint64_t *mid = up + stride;
+        const uint64_t *down = mid + stride;
+        uint64_t *out = ensemble->next + x * stride;
+        for (int y = 1; y <= width; y++) {
+            out[y] = rules == NULL
+                ? life_rule(up[y - 1], up[y], up[y + 1], mid[y - 1], mid[y], mid[y + 1],
+                            down[y - 1], down[y], down[y + 1])
+                : life_rule_generic(rules, up[y - 1], up[y], up[y + 1], mid[y - 1], mid[y], mid[y + 1],
+                                    down[y - 1], down[y], down[y + 1]);
+        }
+    }
+}
+
+void life_ensemble_step_n(struct life_ensemble *ensemble, long long n) {
+    const int conway = life_rule_is_conway(&ensemble->rule);
+    for (long long i = 0; i < n; i++) {
+        fill_halo(ensemble);
+        if (conway) {
+            step_cells(ensemble, NULL);
+        } else {
+            step_cells(ensemble, &ensemble->rule);
+        }
+        uint64_t *swap = ensemble->cells;
+        ensemble->cells = ensemble->next;
+        ensemble->next = swap;
+    }
+}
+
+void life_ensemble_populations(const struct life_ensemble *ensemble,
+                               long long populations[LIFE_ENSEMBLE_BOARDS]) {
+    const size_t stride = stride_of(ensemble);
+    memset(populations, 0, LIFE_ENSEMBLE_BOARDS * sizeof(long long));
+    for (int x = 1; x <= ensemble->height; x++) {
+        const uint64_t *row = ensemble->cells + x * stride;
+        for (int y = 1; y <= ensemble->width; y++) {
+            for (uint64_t word = row[y]; word != 0; word &= word - 1) {
+                populations[__builtin_ctzll(word)]++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief A batch shared by the threads of life_ensemble_run_batch().
+ */
+struct batch {
+    int width;
+    int height;
+    enum life_edges edges;
+    const struct life_ruleset *rule;
+    const struct life_ensemble_board *boards;
+    size_t count;
+    long long generations;
+    long long *populations;
+    atomic_int failed;
+};
+
+/**
+ * @brief Pool task: runs every count-th group of boards, starting at index.
+ */
+static void run_groups(void *arg, int index, int count) {
+    struct batch *batch = arg;
+    size_t groups = (batch->count + LIFE_ENSEMBLE_BOARDS - 1) / LIFE_ENSEMBLE_BOARDS;
+    if ((size_t)index >= groups) {
+        return;
+    }
+    struct life_ensemble *ensemble = life_ensemble_create(batch->width, batch->height, batch->edges);
+    if (ensemble == NULL) {
+        atomic_store(&batch->failed, 1);
+        return;
+    }
+    ensemble->rule = *batch->rule;
+
+    for (size_t group = (size_t)index; group < groups; group += (size_t)count) {
+        size_t first = group * LIFE_ENSEMBLE_BOARDS;
+        size_t size = batch->count - first < LIFE_ENSEMBLE_BOARDS ? batch->count - first : LIFE_ENSEMBLE_BOARDS;
+        life_ensemble_clear(ensemble);
+        for (size_t k = 0; k < size; k++) {
+            life_ensemble_place(ensemble, (int)k, batch->boards[first + k].patterns,
+                                batch->boards[first + k].pattern_count);
+        }
+        life_ensemble_step_n(ensemble, batch->generations);
+
+        long long populations[LIFE_ENSEMBLE_BOARDS];
+        life_ensemble_populations(ensemble, populations);
+        memcpy(batch->populations + first, populations, size * sizeof(long long));
+    }
+    life_ensemble_free(ensemble);
+}
+
+int life_ensemble_run_batch(int width, int height, enum life_edges edges, const struct life_ruleset *rule,
+                            const struct life_ensemble_board *boards, size_t count, long long generations,
+                            struct life_pool *pool, long long *populations) {
+    struct batch batch = { width, height, edges, rule, boards, count, generations, populations, 0 };
+    atomic_init(&batch.failed, 0);
+    if (pool != NULL) {
+        life_pool_run(pool, run_groups, &batch);
+    } else {
+        run_groups(&batch, 0, 1);
+    }
+    return atomic_load(&batch.failed) ? -1 : 0;
+}
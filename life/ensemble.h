@@ -0,0 +1,153 @@
+/*******************************************************************
+ * Conway's Game of Life - Bit-Sliced Ensemble
+ *
+ * Author: hrosicka
+ * Description:
+ *   Simulates LIFE_ENSEMBLE_BOARDS independent boards of the same
+ *   size at once. Every cell is one 64-bit word, and bit k of the
+ *   word is that cell on board k. The bitwise rule of rule.h works
+ *   lane by lane, so one evaluation per cell advances all 64 boards
+ *   together, at the cost of a single board of the same size.
+ *
+ *   This suits parameter sweeps over small boards (the 15 x 7 blinker
+ *   or the 30 x 15 toad): thousands of runs no longer each pay the
+ *   setup and loop overhead of a whole program. The ensemble is 64
+ *   boards wide, the width of a cell word; more boards are run as more
+ *   ensembles (life_ensemble_run_batch()).
+ *
+ *   The board is stored with a one-cell ghost frame, filled before
+ *   each generation as in life_simd_fill_halo(): a copy of the
+ *   opposite edge on a torus, zeros on a clipped board.
+ *
+ * Coordinates follow the rest of the repository: x is the row index
+ * and y is the column index.
+ *******************************************************************/
+
+#ifndef LIFE_ENSEMBLE_H
+#define LIFE_ENSEMBLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "grid.h"
+#include "pool.h"
+#include "rule.h"
+
+#define LIFE_ENSEMBLE_BOARDS 64   // Boards per ensemble (bits per cell word)
+
+/**
+ * @brief LIFE_ENSEMBLE_BOARDS boards of equal size and edge mode.
+ *
+ * Cell (x, y) is word (x + 1) * (width + 2) + (y + 1) of cells.
+ * rule may be changed between calls to life_ensemble_step_n().
+ */
+struct life_ensemble {
+    int width;                  // Number of columns
+    int height;                 // Number of rows
+    enum life_edges edges;      // How the board edges behave
+    struct life_ruleset rule;   // Rule of every board (B3/S23 by default)
+    uint64_t *cells;            // Current generation, ghost frame included
+    uint64_t *next;             // Scratch buffer for the next generation
+    struct life_arena arena;    // Holds the ensemble and both buffers
+};
+
+/**
+ * @brief One board of a batch: the pattern tables placed on it.
+ */
+struct life_ensemble_board {
+    const struct life_pattern *patterns;
+    int pattern_count;
+};
+
+/**
+ * @brief Allocates an ensemble of empty boards.
+ *
+ * @param width Number of columns.
+ * @param height Number of rows.
+ * @param edges Edge mode of every board.
+ * @return struct life_ensemble* The ensemble, or NULL if out of memory.
+ */
+struct life_ensemble *life_ensemble_create(int width, int height, enum life_edges edges);
+
+/**
+ * @brief Releases an ensemble created by life_ensemble_create().
+ *
+ * @param ensemble The ensemble to free (may be NULL).
+ */
+void life_ensemble_free(struct life_ensemble *ensemble);
+
+/**
+ * @brief Kills every cell of every board.
+ */
+void life_ensemble_clear(struct life_ensemble *ensemble);
+
+/**
+ * @brief Returns the state of a cell of one board.
+ *
+ * @return int 1 if the cell is alive, 0 if it is dead or off the board.
+ */
+int life_ensemble_get(const struct life_ensemble *ensemble, int board, int x, int y);
+
+/**
+ * @brief Sets the state of a cell of one board.
+ *
+ * Coordinates outside the board are ignored.
+ *
+ * @param ensemble The ensemble.
+ * @param board Board index, 0 to LIFE_ENSEMBLE_BOARDS - 1.
+ * @param x The row index of the cell.
+ * @param y The column index of the cell.
+ * @param alive 1 to make the cell alive, 0 to kill it.
+ */
+void life_ensemble_set(struct life_ensemble *ensemble, int board, int x, int y, int alive);
+
+/**
+ * @brief Places pattern tables on one board.
+ *
+ * Cells that fall outside the board are ignored.
+ *
+ * @param ensemble The ensemble.
+ * @param board Board index.
+ * @param patterns The tables and their positions.
+ * @param count Number of tables.
+ */
+void life_ensemble_place(struct life_ensemble *ensemble, int board,
+                         const struct life_pattern *patterns, int count);
+
+/**
+ * @brief Advances every board by n generations.
+ */
+void life_ensemble_step_n(struct life_ensemble *ensemble, long long n);
+
+/**
+ * @brief Counts the live cells of every board.
+ *
+ * @param ensemble The ensemble.
+ * @param populations Output, one count per board.
+ */
+void life_ensemble_populations(const struct life_ensemble *ensemble,
+                               long long populations[LIFE_ENSEMBLE_BOARDS]);
+
+/**
+ * @brief Runs many boards and reports their populations.
+ *
+ * The boards are simulated LIFE_ENSEMBLE_BOARDS at a time. With a
+ * pool, each thread takes its own groups of boards.
+ *
+ * @param width Number of columns of every board.
+ * @param height Number of rows of every board.
+ * @param edges Edge mode of every board.
+ * @param rule The rule.
+ * @param boards Starting patterns of each board.
+ * @param count Number of boards.
+ * @param generations Generations to simulate.
+ * @param pool Worker threads, or NULL.
+ * @param populations Output, the population of each board after the
+ *                    last generation.
+ * @return int 0 on success, -1 if out of memory.
+ */
+int life_ensemble_run_batch(int width, int height, enum life_edges edges, const struct life_ruleset *rule,
+                            const struct life_ensemble_board *boards, size_t count, long long generations,
+                            struct life_pool *pool, long long *populations);
+
+#endif // LIFE_ENSEMBLE_H
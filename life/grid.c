@@ -0,0 +1,1203 @@
+/*******************************************************************
+ * Conway's Game of Life - Bit-Packed Grid Engine
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the bit-packed board declared in grid.h.
+ *
+ * Step Kernel:
+ *   For every 64-bit word the eight neighbor rows (north-west, north,
+ *   north-east, west, east, south-west, south, south-east) are built
+ *   with shifts and handed to life_rule() (rule.h), which applies
+ *   Conway's rules to 64 cells at once. Other rules go through
+ *   life_rule_generic(); the common ones get their own copy of the
+ *   kernel with the rule folded in at compile time.
+ *******************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "grid.h"
+#include "lut.h"
+#include "rule.h"
+#include "simd.h"
+
+/**
+ * @brief Mask of the valid column bits in the last word of a row.
+ */
+static uint64_t last_word_mask(const struct life_grid *grid) {
+    int used = grid->width % 64;
+    return used == 0 ? ~0ULL : (1ULL << used) - 1;
+}
+
+struct life_grid *life_grid_create(int width, int height, enum life_edges edges) {
+    if (width <= 0 || height <= 0) {
+        return NULL;
+    }
+
+    int words = (width + 63) / 64;
+    int tile_rows = (height + LIFE_TILE_ROWS - 1) / LIFE_TILE_ROWS;
+    // Each buffer has a ghost row above and below the board
+    size_t board = (size_t)words * ((size_t)height + 2) * sizeof(uint64_t);
+    size_t tiles = (size_t)tile_rows * (size_t)words;
+
+    // Everything the board needs comes from one arena
+    struct life_arena arena;
+    size_t total = life_arena_block_size(sizeof(struct life_grid)) +
+                   2 * life_arena_block_size(board) +
+                   2 * life_arena_block_size(tiles) +
+                   life_arena_block_size((size_t)words * sizeof(uint64_t)) +
+                   life_arena_block_size((size_t)tile_rows);
+    if (life_arena_init(&arena, total) != 0) {
+        return NULL;
+    }
+
+    struct life_grid *grid = life_arena_alloc(&arena, sizeof(*grid));
+    grid->width = width;
+    grid->height = height;
+    grid->words = words;
+    grid->edges = edges;
+    grid->cells = (uint64_t *)life_arena_alloc(&arena, board) + words;
+    grid->next = (uint64_t *)life_arena_alloc(&arena, board) + words;
+    grid->tile_rows = tile_rows;
+    grid->active = life_arena_alloc(&arena, tiles);
+    grid->changed = life_arena_alloc(&arena, tiles);
+    grid->dead_row = life_arena_alloc(&arena, (size_t)words * sizeof(uint64_t));
+    // A blocked band has at least LIFE_TILE_ROWS rows
+    grid->band_computed = life_arena_alloc(&arena, (size_t)tile_rows);
+    grid->all_active = 1;
+    grid->kernel = LIFE_KERNEL_PACKED;
+    grid->rule = (struct life_ruleset)LIFE_RULE_CONWAY;
+    grid->arena = arena;
+    return grid;
+}
+
+void life_grid_free(struct life_grid *grid) {
+    if (grid == NULL) {
+        return;
+    }
+    life_arena_release(&grid->byte_arena);
+    life_arena_release(&grid->scratch_arena);
+    free(grid->lut);
+    free(grid->tile_stats);
+
+    // The grid itself lives in its arena, so release a copy
+    struct life_arena arena = grid->arena;
+    life_arena_release(&arena);
+}
+
+void life_grid_clear(struct life_grid *grid) {
+    memset(grid->cells, 0, (size_t)grid->words * (size_t)grid->height * sizeof(uint64_t));
+    grid->all_active = 1;
+}
+
+int life_grid_get(const struct life_grid *grid, int x, int y) {
+    if (x < 0 || x >= grid->height || y < 0 || y >= grid->width) {
+        return 0;
+    }
+    const uint64_t *row = grid->cells + (size_t)x * grid->words;
+    return (int)((row[y / 64] >> (y % 64)) & 1);
+}
+
+void life_grid_set(struct life_grid *grid, int x, int y, int alive) {
+    if (x < 0 || x >= grid->height || y < 0 || y >= grid->width) {
+        return;
+    }
+    uint64_t *row = grid->cells + (size_t)x * grid->words;
+    uint64_t bit = 1ULL << (y % 64);
+    if (alive) {
+        row[y / 64] |= bit;
+    } else {
+        row[y / 64] &= ~bit;
+    }
+    // The neighborhood of this cell has to be recomputed
+    grid->all_active = 1;
+}
+
+void life_grid_set_run(struct life_grid *grid, long long x, long long y, long long length) {
+    long long end = y + length;
+    if (x < 0 || x >= grid->height || end <= 0 || y >= grid->width || length <= 0) {
+        return;
+    }
+    if (y < 0) {
+        y = 0;
+    }
+    if (end > grid->width) {
+        end = grid->width;
+    }
+    uint64_t *row = grid->cells + (size_t)x * grid->words;
+    int first = (int)(y / 64), last = (int)((end - 1) / 64);
+    uint64_t head = ~0ULL << (y % 64);
+    uint64_t tail = ~0ULL >> (63 - (end - 1) % 64);
+    if (first == last) {
+        row[first] |= head & tail;
+    } else {
+        row[first] |= head;
+        for (int w = first + 1; w < last; w++) {
+            row[w] = ~0ULL;
+        }
+        row[last] |= tail;
+    }
+    grid->all_active = 1;
+}
+
+/**
+ * @brief Marks the tiles whose neighborhood includes word w of row x.
+ */
+static void activate_around(struct life_grid *grid, int x, int w) {
+    const int words = grid->words;
+    const int wrap = grid->edges == LIFE_EDGES_WRAP;
+    for (int dx = -1; dx <= 1; dx++) {
+        int row = x + dx;
+        if (row < 0 || row >= grid->height) {
+            if (!wrap) {
+                continue;
+            }
+            row = (row + grid->height) % grid->height;
+        }
+        int tile_row = row / LIFE_TILE_ROWS;
+        for (int dw = -1; dw <= 1; dw++) {
+            int c = w + dw;
+            if (c < 0 || c >= words) {
+                if (!wrap) {
+                    continue;
+                }
+                c = (c + words) % words;
+            }
+            grid->active[(size_t)tile_row * words + c] = 1;
+        }
+    }
+}
+
+void life_grid_write_row(struct life_grid *grid, int x, const uint64_t *words) {
+    if (x < 0 || x >= grid->height) {
+        return;
+    }
+    uint64_t *row = grid->cells + (size_t)x * grid->words;
+    for (int w = 0; w < grid->words; w++) {
+        uint64_t word = w == grid->words - 1 ? words[w] & last_word_mask(grid) : words[w];
+        if (row[w] != word) {
+            row[w] = word;
+            activate_around(grid, x, w);
+        }
+    }
+    if (grid->tile_stats != NULL) {
+        // The tile records only follow the changes made by the kernels
+        grid->all_active = 1;
+    }
+}
+
+/**
+ * @brief Expands the board to bytes, stride bytes per row.
+ */
+static void unpack_rows(const struct life_grid *grid, uint8_t *bytes, size_t stride) {
+    for (int x = 0; x < grid->height; x++) {
+        const uint64_t *row = grid->cells + (size_t)x * grid->words;
+        uint8_t *out = bytes + (size_t)x * stride;
+        for (int y = 0; y < grid->width; y++) {
+            out[y] = (uint8_t)((row[y / 64] >> (y % 64)) & 1);
+        }
+    }
+}
+
+/**
+ * @brief Packs a board of bytes, stride bytes per row, into cells
+ * (grid->cells or grid->next).
+ */
+static void pack_rows(const struct life_grid *grid, uint64_t *cells, const uint8_t *bytes, size_t stride) {
+    for (int x = 0; x < grid->height; x++) {
+        uint64_t *row = cells + (size_t)x * grid->words;
+        const uint8_t *in = bytes + (size_t)x * stride;
+        memset(row, 0, (size_t)grid->words * sizeof(uint64_t));
+        for (int y = 0; y < grid->width; y++) {
+            row[y / 64] |= (uint64_t)(in[y] != 0) << (y % 64);
+        }
+    }
+}
+
+void life_grid_unpack(const struct life_grid *grid, uint8_t *bytes) {
+    unpack_rows(grid, bytes, (size_t)grid->width);
+}
+
+void life_grid_pack(struct life_grid *grid, const uint8_t *bytes) {
+    pack_rows(grid, grid->cells, bytes, (size_t)grid->width);
+    grid->all_active = 1;
+}
+
+void life_grid_place_pattern(struct life_grid *grid, const int pattern[][2], int size, int start_x, int start_y) {
+    for (int i = 0; i < size; i++) {
+        life_grid_set(grid, start_x + pattern[i][0], start_y + pattern[i][1], 1);
+    }
+}
+
+long long life_grid_population(const struct life_grid *grid) {
+    size_t count = (size_t)grid->words * (size_t)grid->height;
+    long long total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += __builtin_popcountll(grid->cells[i]);
+    }
+    return total;
+}
+
+/**
+ * @brief Fills the ghost rows of the current generation.
+ *
+ * On a torus the row above the board is a copy of the last row and
+ * the row below it a copy of the first; on a clipped board both are
+ * dead.
+ */
+static void fill_halo(struct life_grid *grid) {
+    const size_t row_bytes = (size_t)grid->words * sizeof(uint64_t);
+    uint64_t *above = grid->cells - grid->words;
+    uint64_t *below = grid->cells + (size_t)grid->height * grid->words;
+
+    if (grid->edges == LIFE_EDGES_WRAP) {
+        memcpy(above, below - grid->words, row_bytes);
+        memcpy(below, grid->cells, row_bytes);
+    } else {
+        memset(above, 0, row_bytes);
+        memset(below, 0, row_bytes);
+    }
+}
+
+/**
+ * @brief Shifts a row so that each cell sees its west neighbor.
+ *
+ * @param row The source row.
+ * @param w The word to produce.
+ * @param carry_in Bit shifted into column 0 of the row.
+ */
+static inline uint64_t west_of(const uint64_t *row, int w, uint64_t carry_in) {
+    return (row[w] << 1) | (w > 0 ? row[w - 1] >> 63 : carry_in);
+}
+
+/**
+ * @brief Shifts a row so that each cell sees its east neighbor.
+ *
+ * @param row The source row.
+ * @param w The word to produce.
+ * @param words Words per row.
+ * @param carry_in Bit shifted into the last column, already positioned.
+ */
+static inline uint64_t east_of(const uint64_t *row, int w, int words, uint64_t carry_in) {
+    return (row[w] >> 1) | (w + 1 < words ? row[w + 1] << 63 : carry_in);
+}
+
+/**
+ * @brief Recounts the record of a tile from its words in the previous
+ * and the new generation.
+ *
+ * @param tile The record.
+ * @param before The tile's word in its first row, previous generation.
+ * @param after The same word in the new generation.
+ * @param words Words per row.
+ * @param rows Rows of the tile.
+ */
+static void summarize_tile(struct life_tile_stats *tile, const uint64_t *before, const uint64_t *after,
+                           int words, int rows) {
+    *tile = (struct life_tile_stats){ .first_row = LIFE_TILE_ROWS };
+    for (int row = 0; row < rows; row++) {
+        uint64_t old = before[(size_t)row * words], cells = after[(size_t)row * words];
+        if (cells != old) {
+            tile->births += (uint16_t)__builtin_popcountll(cells & ~old);
+            tile->deaths += (uint16_t)__builtin_popcountll(old & ~cells);
+        }
+        if (cells != 0) {
+            tile->live += (uint16_t)__builtin_popcountll(cells);
+            tile->columns |= cells;
+            tile->first_row = tile->first_row == LIFE_TILE_ROWS ? (uint8_t)row : tile->first_row;
+            tile->last_row = (uint8_t)row;
+        }
+    }
+}
+
+/**
+ * @brief Brings the records of the active tiles of one tile row up to
+ * date, right after the row was computed.
+ *
+ * Only tiles that changed are recounted, while both generations are
+ * still in cache; an unchanged tile keeps its record, with no births
+ * or deaths. When the board was changed from outside
+ * (grid->all_active) every record is rebuilt.
+ *
+ * @param diff Changed cells of each tile.
+ */
+static void finish_tiles(const struct life_grid *grid, int tile_row, const uint8_t *active, const uint64_t *diff) {
+    const int words = grid->words;
+    int first_row = tile_row * LIFE_TILE_ROWS;
+    int rows = grid->height - first_row < LIFE_TILE_ROWS ? grid->height - first_row : LIFE_TILE_ROWS;
+    size_t offset = (size_t)first_row * words;
+    struct life_tile_stats *tiles = grid->tile_stats + (size_t)tile_row * words;
+    for (int w = 0; w < words; w++) {
+        if (!active[w]) {
+            continue;
+        }
+        if (diff[w] != 0 || grid->all_active) {
+            summarize_tile(&tiles[w], grid->cells + offset + w, grid->next + offset + w, words, rows);
+        } else {
+            tiles[w].births = 0;
+            tiles[w].deaths = 0;
+        }
+    }
+}
+
+/**
+ * @brief Computes the active tiles of tile rows [first, last).
+ *
+ * The ghost rows must have been filled with fill_halo(). Words of
+ * inactive tiles are left untouched: their neighborhood did
+ * not change in the last generation, so the scratch buffer already
+ * holds their next state (see mark_active_tiles()). For every tile
+ * that is computed, records whether any of its cells changed.
+ *
+ * Always inlined, so that each caller gets a kernel specialized for
+ * its rules argument.
+ *
+ * @param diff Scratch of grid->words words owned by the calling thread.
+ * @param rules The rule, or NULL for life_rule() (B3/S23).
+ */
+static inline __attribute__((always_inline)) void step_tiles(struct life_grid *grid, int first, int last,
+                                                             uint64_t *diff, const struct life_ruleset *rules) {
+    const int words = grid->words;
+    const int wrap = grid->edges == LIFE_EDGES_WRAP;
+    const int last_bit = (grid->width - 1) % 64;
+    const uint64_t mask = last_word_mask(grid);
+
+    // diff: cells that changed in each tile of the current tile row
+
+    for (int tile_row = first; tile_row < last; tile_row++) {
+        const uint8_t *active = grid->active + (size_t)tile_row * words;
+        uint8_t *changed = grid->changed + (size_t)tile_row * words;
+        int row_end = (tile_row + 1) * LIFE_TILE_ROWS;
+        if (row_end > grid->height) {
+            row_end = grid->height;
+        }
+        memset(diff, 0, (size_t)words * sizeof(uint64_t));
+
+        for (int x = tile_row * LIFE_TILE_ROWS; x < row_end; x++) {
+            // Rows x - 1 and x + 1 exist even at the edges (ghost rows)
+            const uint64_t *rows[3] = {
+                grid->cells + ((ptrdiff_t)x - 1) * words,
+                grid->cells + (ptrdiff_t)x * words,
+                grid->cells + ((ptrdiff_t)x + 1) * words
+            };
+            uint64_t *out = grid->next + (size_t)x * words;
+
+            // Bits carried around the left and right edges of each row
+            uint64_t west_in[3], east_in[3];
+            for (int k = 0; k < 3; k++) {
+                west_in[k] = wrap ? (rows[k][words - 1] >> last_bit) & 1 : 0;
+                east_in[k] = wrap ? (rows[k][0] & 1) << last_bit : 0;
+            }
+
+            for (int w = 0; w < words; w++) {
+                if (!active[w]) {
+                    continue;
+                }
+                uint64_t nw = west_of(rows[0], w, west_in[0]), ne = east_of(rows[0], w, words, east_in[0]);
+                uint64_t west = west_of(rows[1], w, west_in[1]), east = east_of(rows[1], w, words, east_in[1]);
+                uint64_t sw = west_of(rows[2], w, west_in[2]), se = east_of(rows[2], w, words, east_in[2]);
+                uint64_t next = rules == NULL
+                    ? life_rule(nw, rows[0][w], ne, west, rows[1][w], east, sw, rows[2][w], se)
+                    : life_rule_generic(rules, nw, rows[0][w], ne, west, rows[1][w], east, sw, rows[2][w], se);
+                out[w] = next;
+                diff[w] |= next ^ rows[1][w];
+            }
+            out[words - 1] &= mask;
+        }
+
+        // Bits past the last column are masked in out but not in diff
+        diff[words - 1] &= mask;
+        for (int w = 0; w < words; w++) {
+            changed[w] = diff[w] != 0;
+        }
+        if (grid->tile_stats != NULL) {
+            finish_tiles(grid, tile_row, active, diff);
+        }
+    }
+}
+
+/**
+ * @brief Computes the active tiles of tile rows [first, last) with the
+ * block lookup table.
+ *
+ * Same contract as step_tiles(). Rows are computed in pairs; a tile
+ * has an even number of rows, so a pair never straddles two tiles.
+ * On a board with an odd height the last row is paired with
+ * grid->dead_row below the ghost row, and only its own result is kept.
+ *
+ * @param diff Scratch of grid->words words owned by the calling thread.
+ */
+static void step_tiles_lut(struct life_grid *grid, int first, int last, uint64_t *diff) {
+    const int words = grid->words;
+    const int wrap = grid->edges == LIFE_EDGES_WRAP;
+    const int last_bit = (grid->width - 1) % 64;
+    const uint64_t mask = last_word_mask(grid);
+    const uint8_t *table = grid->lut != NULL ? grid->lut : life_lut_table();
+
+    // diff: changed cells of each tile of the current tile row
+
+    for (int tile_row = first; tile_row < last; tile_row++) {
+        const uint8_t *active = grid->active + (size_t)tile_row * words;
+        uint8_t *changed = grid->changed + (size_t)tile_row * words;
+        int row_end = (tile_row + 1) * LIFE_TILE_ROWS;
+        if (row_end > grid->height) {
+            row_end = grid->height;
+        }
+        memset(diff, 0, (size_t)words * sizeof(uint64_t));
+
+        for (int x = tile_row * LIFE_TILE_ROWS; x < row_end; x += 2) {
+            int pair = x + 1 < grid->height;
+            const uint64_t *rows[4] = {
+                grid->cells + ((ptrdiff_t)x - 1) * words,
+                grid->cells + (ptrdiff_t)x * words,
+                grid->cells + ((ptrdiff_t)x + 1) * words,
+                pair ? grid->cells + ((ptrdiff_t)x + 2) * words : grid->dead_row
+            };
+            uint64_t *out[2] = {
+                grid->next + (size_t)x * words,
+                grid->next + ((size_t)x + 1) * words
+            };
+
+            for (int w = 0; w < words; w++) {
+                if (!active[w]) {
+                    continue;
+                }
+                uint64_t west[4], self[4], east_bit[4];
+                for (int k = 0; k < 4; k++) {
+                    self[k] = rows[k][w];
+                    if (wrap && w == words - 1 && last_bit < 63) {
+                        // Column 0 follows the last column; put it just past it
+                        self[k] |= (rows[k][0] & 1) << (last_bit + 1);
+                    }
+                    west[k] = (self[k] << 1) |
+                              (w > 0 ? rows[k][w - 1] >> 63 : wrap ? (rows[k][words - 1] >> last_bit) & 1 : 0);
+                    east_bit[k] = w + 1 < words ? rows[k][w + 1] & 1 : wrap ? rows[k][0] & 1 : 0;
+                }
+                uint64_t top, bottom;
+                life_lut_step_word(table, west, self, east_bit, &top, &bottom);
+                if (w == words - 1) {
+                    top &= mask;
+                    bottom &= mask;
+                }
+                out[0][w] = top;
+                diff[w] |= top ^ rows[1][w];
+                if (pair) {
+                    out[1][w] = bottom;
+                    diff[w] |= bottom ^ rows[2][w];
+                }
+            }
+        }
+
+        for (int w = 0; w < words; w++) {
+            changed[w] = diff[w] != 0;
+        }
+        if (grid->tile_stats != NULL) {
+            finish_tiles(grid, tile_row, active, diff);
+        }
+    }
+}
+
+/**
+ * @brief Chooses the tiles to compute in the next generation.
+ *
+ * A tile is active if it or one of its eight neighbor tiles changed in
+ * the generation just computed. Every other tile sees exactly the same
+ * neighborhood as one generation earlier, so its next state equals
+ * its current one; since the buffers are swapped rather than copied,
+ * that state is also what the scratch buffer already holds for it.
+ */
+static void mark_active_tiles(struct life_grid *grid) {
+    const int words = grid->words;
+    const int wrap = grid->edges == LIFE_EDGES_WRAP;
+
+    for (int tr = 0; tr < grid->tile_rows; tr++) {
+        for (int tc = 0; tc < words; tc++) {
+            uint8_t active = 0;
+            for (int dr = -1; dr <= 1 && !active; dr++) {
+                for (int dc = -1; dc <= 1 && !active; dc++) {
+                    int r = tr + dr, c = tc + dc;
+                    if (r < 0 || r >= grid->tile_rows || c < 0 || c >= words) {
+                        if (!wrap) {
+                            continue;
+                        }
+                        r = (r + grid->tile_rows) % grid->tile_rows;
+                        c = (c + words) % words;
+                    }
+                    active = grid->changed[(size_t)r * words + c];
+                }
+            }
+            grid->active[(size_t)tr * words + tc] = active;
+        }
+    }
+}
+
+/**
+ * @brief Updates the tile counters before a generation is computed.
+ */
+static void count_tiles(struct life_grid *grid) {
+    size_t tiles = (size_t)grid->tile_rows * grid->words;
+    if (grid->all_active) {
+        memset(grid->active, 1, tiles);
+    }
+    long long active = 0;
+    for (size_t i = 0; i < tiles; i++) {
+        active += grid->active[i];
+    }
+    grid->tiles_stepped += active;
+    grid->tiles_skipped += (long long)tiles - active;
+}
+
+/**
+ * @brief Makes the freshly computed generation the current one.
+ */
+static void swap_buffers(struct life_grid *grid) {
+    uint64_t *swap = grid->cells;
+    grid->cells = grid->next;
+    grid->next = swap;
+    mark_active_tiles(grid);
+}
+
+/**
+ * @brief Rules with a specialized copy of the packed kernel.
+ */
+static const struct life_ruleset highlife = { (1u << 3) | (1u << 6), (1u << 2) | (1u << 3) };
+static const struct life_ruleset seeds = { 1u << 2, 0 };
+static const struct life_ruleset day_and_night = {
+    (1u << 3) | (1u << 6) | (1u << 7) | (1u << 8),
+    (1u << 3) | (1u << 4) | (1u << 6) | (1u << 7) | (1u << 8)
+};
+
+static int same_rule(const struct life_ruleset *a, const struct life_ruleset *b) {
+    return a->birth == b->birth && a->survival == b->survival;
+}
+
+/**
+ * @brief Runs the packed kernel specialized for grid->rule, if there is one.
+ */
+static void step_tiles_dispatch(struct life_grid *grid, int first, int last, uint64_t *diff) {
+    const struct life_ruleset *rule = &grid->rule;
+    if (life_rule_is_conway(rule)) {
+        step_tiles(grid, first, last, diff, NULL);
+    } else if (same_rule(rule, &highlife)) {
+        step_tiles(grid, first, last, diff, &highlife);
+    } else if (same_rule(rule, &seeds)) {
+        step_tiles(grid, first, last, diff, &seeds);
+    } else if (same_rule(rule, &day_and_night)) {
+        step_tiles(grid, first, last, diff, &day_and_night);
+    } else {
+        step_tiles(grid, first, last, diff, rule);
+    }
+}
+
+/**
+ * @brief Makes grid->scratch hold at least words words for each thread
+ * of grid->pool.
+ *
+ * The scratch is kept from one generation to the next and only grows,
+ * so the step kernels allocate nothing once it fits.
+ */
+static int reserve_scratch(struct life_grid *grid, size_t words) {
+    int threads = grid->pool != NULL ? life_pool_threads(grid->pool) : 1;
+    if (grid->scratch != NULL && threads <= grid->scratch_threads && words <= grid->scratch_words) {
+        return 0;
+    }
+    if (threads < grid->scratch_threads) {
+        threads = grid->scratch_threads;
+    }
+    if (words < grid->scratch_words) {
+        words = grid->scratch_words;
+    }
+
+    life_arena_release(&grid->scratch_arena);
+    grid->scratch = NULL;
+    grid->scratch_words = 0;
+    grid->scratch_threads = 0;
+    size_t size = (size_t)threads * words * sizeof(uint64_t);
+    if (life_arena_init(&grid->scratch_arena, life_arena_block_size(size)) != 0) {
+        return -1;
+    }
+    grid->scratch = life_arena_alloc(&grid->scratch_arena, size);
+    grid->scratch_words = words;
+    grid->scratch_threads = threads;
+    return 0;
+}
+
+/**
+ * @brief Pool task: computes the band of tile rows owned by one thread.
+ */
+static void step_band(void *arg, int index, int count) {
+    struct life_grid *grid = arg;
+    int first = (int)((long long)grid->tile_rows * index / count);
+    int last = (int)((long long)grid->tile_rows * (index + 1) / count);
+    uint64_t *diff = grid->scratch + (size_t)index * grid->scratch_words;
+    if (grid->kernel == LIFE_KERNEL_LUT) {
+        step_tiles_lut(grid, first, last, diff);
+    } else {
+        step_tiles_dispatch(grid, first, last, diff);
+    }
+}
+
+/**
+ * @brief Makes grid->lut match grid->rule.
+ *
+ * B3/S23 uses the shared table (grid->lut is NULL); any other rule
+ * gets a table of its own, rebuilt when the rule changes.
+ */
+static int prepare_lut(struct life_grid *grid) {
+    if (life_rule_is_conway(&grid->rule)) {
+        free(grid->lut);
+        grid->lut = NULL;
+        return 0;
+    }
+    if (grid->lut != NULL && same_rule(&grid->lut_rule, &grid->rule)) {
+        return 0;
+    }
+    if (grid->lut == NULL) {
+        grid->lut = malloc(LIFE_LUT_SIZE);
+        if (grid->lut == NULL) {
+            return -1;
+        }
+    }
+    life_lut_build(grid->lut, &grid->rule);
+    grid->lut_rule = grid->rule;
+    return 0;
+}
+
+/**
+ * @brief Advances the packed board by one generation with the packed
+ * or the lookup table kernel.
+ */
+static int step_packed(struct life_grid *grid) {
+    if (grid->kernel == LIFE_KERNEL_LUT && prepare_lut(grid) != 0) {
+        return -1;
+    }
+    if (reserve_scratch(grid, (size_t)grid->words) != 0) {
+        return -1;
+    }
+    count_tiles(grid);
+    fill_halo(grid);
+    if (grid->pool != NULL) {
+        life_pool_run(grid->pool, step_band, grid);
+    } else {
+        step_band(grid, 0, 1);
+    }
+    swap_buffers(grid);
+    grid->all_active = 0;
+    return 0;
+}
+
+/**
+ * @brief Rebuilds the record and changed flag of every tile from the
+ * previous generation, held in grid->next.
+ *
+ * Used after the byte-per-cell kernel, which has no tiles of its own.
+ * The flags let the next packed generation skip tiles again, as next
+ * already holds the previous state of every unchanged tile.
+ */
+static void measure_tiles(struct life_grid *grid) {
+    const int words = grid->words;
+    for (int tile_row = 0; tile_row < grid->tile_rows; tile_row++) {
+        int row_end = (tile_row + 1) * LIFE_TILE_ROWS;
+        if (row_end > grid->height) {
+            row_end = grid->height;
+        }
+        for (int w = 0; w < words; w++) {
+            struct life_tile_stats *tile = &grid->tile_stats[(size_t)tile_row * words + w];
+            size_t offset = (size_t)tile_row * LIFE_TILE_ROWS * words + w;
+            summarize_tile(tile, grid->next + offset, grid->cells + offset, words,
+                           row_end - tile_row * LIFE_TILE_ROWS);
+            grid->changed[(size_t)tile_row * words + w] = tile->births != 0 || tile->deaths != 0;
+        }
+    }
+    mark_active_tiles(grid);
+    grid->all_active = 0;
+}
+
+/**
+ * @brief Arguments of one byte-per-cell generation shared by the threads.
+ */
+struct byte_step {
+    const struct life_grid *grid;
+    uint8_t *next;
+    const uint8_t *cells;
+};
+
+/**
+ * @brief Pool task: computes the byte rows owned by one thread.
+ */
+static void step_byte_band(void *arg, int index, int count) {
+    const struct byte_step *step = arg;
+    const struct life_grid *grid = step->grid;
+    int first = (int)((long long)grid->height * index / count);
+    int last = (int)((long long)grid->height * (index + 1) / count);
+    life_simd_step_halo(step->next, step->cells, grid->width, first, last, &grid->rule);
+}
+
+/**
+ * @brief Advances the board n generations with the byte-per-cell kernel.
+ *
+ * The board is expanded to halo-padded bytes once, stepped n times,
+ * and packed again, so the conversion is paid once per batch. Each
+ * generation refills the ghost border and then runs the edge-free
+ * kernel over the whole board.
+ */
+static int step_n_simd(struct life_grid *grid, long long n) {
+    size_t stride = (size_t)grid->width + 2;
+    size_t size = stride * ((size_t)grid->height + 2);
+    if (grid->bytes[0] == NULL) {
+        if (life_arena_init(&grid->byte_arena, 2 * life_arena_block_size(size)) != 0) {
+            return -1;
+        }
+        grid->bytes[0] = life_arena_alloc(&grid->byte_arena, size);
+        grid->bytes[1] = life_arena_alloc(&grid->byte_arena, size);
+    }
+
+    // Byte offset of cell (0, 0) inside the border
+    size_t origin = stride + 1;
+    unpack_rows(grid, grid->bytes[0] + origin, stride);
+    int current = 0;
+    for (long long i = 0; i < n; i++) {
+        life_simd_fill_halo(grid->bytes[current], grid->width, grid->height, grid->edges);
+        struct byte_step step = { grid, grid->bytes[1 - current], grid->bytes[current] };
+        if (grid->pool != NULL) {
+            life_pool_run(grid->pool, step_byte_band, &step);
+        } else {
+            step_byte_band(&step, 0, 1);
+        }
+        current = 1 - current;
+    }
+    pack_rows(grid, grid->cells, grid->bytes[current] + origin, stride);
+    grid->all_active = 1;
+    if (grid->tile_stats != NULL) {
+        pack_rows(grid, grid->next, grid->bytes[1 - current] + origin, stride);
+        measure_tiles(grid);
+    }
+    return 0;
+}
+
+/**
+ * @brief Computes rows [first, last) of a blocked band buffer from the
+ * previous generation in src.
+ *
+ * Both buffers hold full board rows, grid->words words each, with no
+ * ghost rows: the caller only asks for rows whose neighbors are in
+ * the buffer. Always inlined, so that each caller gets a kernel
+ * specialized for its rules argument.
+ *
+ * @param rules The rule, or NULL for life_rule() (B3/S23).
+ */
+static inline __attribute__((always_inline)) void step_block_rows(const struct life_grid *grid, uint64_t *dst,
+                                                                  const uint64_t *src, int first, int last,
+                                                                  const struct life_ruleset *rules) {
+    const int words = grid->words;
+    const int wrap = grid->edges == LIFE_EDGES_WRAP;
+    const int last_bit = (grid->width - 1) % 64;
+    const uint64_t mask = last_word_mask(grid);
+
+    for (int x = first; x < last; x++) {
+        const uint64_t *rows[3] = {
+            src + ((size_t)x - 1) * words,
+            src + (size_t)x * words,
+            src + ((size_t)x + 1) * words
+        };
+        uint64_t *out = dst + (size_t)x * words;
+
+        uint64_t west_in[3], east_in[3];
+        for (int k = 0; k < 3; k++) {
+            west_in[k] = wrap ? (rows[k][words - 1] >> last_bit) & 1 : 0;
+            east_in[k] = wrap ? (rows[k][0] & 1) << last_bit : 0;
+        }
+
+        for (int w = 0; w < words; w++) {
+            uint64_t nw = west_of(rows[0], w, west_in[0]), ne = east_of(rows[0], w, words, east_in[0]);
+            uint64_t west = west_of(rows[1], w, west_in[1]), east = east_of(rows[1], w, words, east_in[1]);
+            uint64_t sw = west_of(rows[2], w, west_in[2]), se = east_of(rows[2], w, words, east_in[2]);
+            out[w] = rules == NULL
+                ? life_rule(nw, rows[0][w], ne, west, rows[1][w], east, sw, rows[2][w], se)
+                : life_rule_generic(rules, nw, rows[0][w], ne, west, rows[1][w], east, sw, rows[2][w], se);
+        }
+        out[words - 1] &= mask;
+    }
+}
+
+/**
+ * @brief Runs step_block_rows() specialized for grid->rule, if there is one.
+ */
+static void step_block_rows_dispatch(const struct life_grid *grid, uint64_t *dst, const uint64_t *src,
+                                     int first, int last) {
+    const struct life_ruleset *rule = &grid->rule;
+    if (life_rule_is_conway(rule)) {
+        step_block_rows(grid, dst, src, first, last, NULL);
+    } else if (same_rule(rule, &highlife)) {
+        step_block_rows(grid, dst, src, first, last, &highlife);
+    } else if (same_rule(rule, &seeds)) {
+        step_block_rows(grid, dst, src, first, last, &seeds);
+    } else if (same_rule(rule, &day_and_night)) {
+        step_block_rows(grid, dst, src, first, last, &day_and_night);
+    } else {
+        step_block_rows(grid, dst, src, first, last, rule);
+    }
+}
+
+/**
+ * @brief One temporally blocked pass, shared by the threads.
+ */
+struct block_pass {
+    struct life_grid *grid;
+    int generations;        // Generations of the pass, k
+    int band_rows;          // Rows per band, a multiple of LIFE_TILE_ROWS
+    int bands;
+    size_t scratch_words;   // Words of scratch per thread
+    uint64_t *scratch;      // Two band buffers per thread (grid->scratch)
+    uint8_t *computed;      // Per band: it was computed, not skipped (grid->band_computed)
+};
+
+/**
+ * @brief Returns the rows [first, last) of a band.
+ */
+static void band_range(const struct block_pass *pass, int band, int *first, int *last) {
+    *first = band * pass->band_rows;
+    *last = *first + pass->band_rows < pass->grid->height ? *first + pass->band_rows : pass->grid->height;
+}
+
+/**
+ * @brief Tells whether no row within k rows of [first, last) lies in
+ * an active tile.
+ *
+ * Every cell outside the active tiles keeps its state in the next
+ * generation, and a change travels at most one row per generation, so
+ * such a band cannot change in the next k generations.
+ */
+static int band_is_stable(const struct life_grid *grid, int first, int last, int k) {
+    const int words = grid->words;
+    int checked = -1;
+    for (long long x = (long long)first - k; x < (long long)last + k; x++) {
+        long long row = x;
+        if (row < 0 || row >= grid->height) {
+            if (grid->edges != LIFE_EDGES_WRAP) {
+                continue;
+            }
+            row = (row % grid->height + grid->height) % grid->height;
+        }
+        int tile_row = (int)(row / LIFE_TILE_ROWS);
+        if (tile_row == checked) {
+            continue;
+        }
+        checked = tile_row;
+        const uint8_t *active = grid->active + (size_t)tile_row * words;
+        for (int w = 0; w < words; w++) {
+            if (active[w]) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Advances one band k generations and writes it to grid->next.
+ *
+ * Local row i of the band buffers is row first - k + i of the board.
+ * After generation g only rows [g, local - g) are still exact, so each
+ * generation computes one row less at each end; after k generations
+ * the band itself is left. On a clipped board, rows past the edges
+ * stay dead and are never computed.
+ *
+ * The changed flags, and the tile records if statistics are on, come
+ * from the last two generations, which are both still in the buffers.
+ */
+static void step_block_band(struct block_pass *pass, int band, uint64_t *scratch) {
+    struct life_grid *grid = pass->grid;
+    const int words = grid->words, k = pass->generations;
+    const size_t row_bytes = (size_t)words * sizeof(uint64_t);
+    int first, last;
+    band_range(pass, band, &first, &last);
+    int local = last - first + 2 * k;
+    int first_tile = first / LIFE_TILE_ROWS, last_tile = (last + LIFE_TILE_ROWS - 1) / LIFE_TILE_ROWS;
+
+    if (!grid->all_active && band_is_stable(grid, first, last, k)) {
+        // Unchanged, and grid->next already holds the band (see mark_active_tiles())
+        memset(grid->changed + (size_t)first_tile * words, 0, (size_t)(last_tile - first_tile) * words);
+        if (grid->tile_stats != NULL) {
+            for (size_t t = (size_t)first_tile * words; t < (size_t)last_tile * words; t++) {
+                grid->tile_stats[t].births = 0;
+                grid->tile_stats[t].deaths = 0;
+            }
+        }
+        pass->computed[band] = 0;
+        return;
+    }
+
+    uint64_t *buffers[2] = { scratch, scratch + (size_t)local * words };
+    for (int i = 0; i < local; i++) {
+        long long row = (long long)first - k + i;
+        if (row < 0 || row >= grid->height) {
+            if (grid->edges != LIFE_EDGES_WRAP) {
+                memset(buffers[0] + (size_t)i * words, 0, row_bytes);
+                memset(buffers[1] + (size_t)i * words, 0, row_bytes);
+                continue;
+            }
+            row = (row % grid->height + grid->height) % grid->height;
+        }
+        memcpy(buffers[0] + (size_t)i * words, grid->cells + (size_t)row * words, row_bytes);
+    }
+
+    // Local rows that lie on the board
+    int on_first = 0, on_last = local;
+    if (grid->edges != LIFE_EDGES_WRAP) {
+        on_first = k - first > 0 ? k - first : 0;
+        on_last = grid->height - first + k < local ? grid->height - first + k : local;
+    }
+    int current = 0;
+    for (int g = 1; g <= k; g++) {
+        int from = g > on_first ? g : on_first;
+        int to = local - g < on_last ? local - g : on_last;
+        step_block_rows_dispatch(grid, buffers[1 - current], buffers[current], from, to);
+        current = 1 - current;
+    }
+    const uint64_t *after = buffers[current] + (size_t)k * words;
+    const uint64_t *before = buffers[1 - current] + (size_t)k * words;
+    memcpy(grid->next + (size_t)first * words, after, (size_t)(last - first) * row_bytes);
+
+    for (int tile_row = first_tile; tile_row < last_tile; tile_row++) {
+        int tile_first = tile_row * LIFE_TILE_ROWS - first;
+        int rows = last - first - tile_first < LIFE_TILE_ROWS ? last - first - tile_first : LIFE_TILE_ROWS;
+        for (int w = 0; w < words; w++) {
+            size_t offset = (size_t)tile_first * words + w;
+            uint64_t diff = 0;
+            for (int x = 0; x < rows; x++) {
+                diff |= after[offset + (size_t)x * words] ^ before[offset + (size_t)x * words];
+            }
+            grid->changed[(size_t)tile_row * words + w] = diff != 0;
+            if (grid->tile_stats != NULL) {
+                // Tiles may have changed earlier in the pass, so every record is rebuilt
+                summarize_tile(&grid->tile_stats[(size_t)tile_row * words + w], before + offset,
+                               after + offset, words, rows);
+            }
+        }
+    }
+    pass->computed[band] = 1;
+}
+
+/**
+ * @brief Pool task: advances the bands owned by one thread.
+ */
+static void step_block_bands(void *arg, int index, int count) {
+    struct block_pass *pass = arg;
+    int first = (int)((long long)pass->bands * index / count);
+    int last = (int)((long long)pass->bands * (index + 1) / count);
+    uint64_t *scratch = pass->scratch + (size_t)index * pass->scratch_words;
+    for (int band = first; band < last; band++) {
+        step_block_band(pass, band, scratch);
+    }
+}
+
+/**
+ * @brief Pool task: copies the inactive tiles of the computed bands
+ * owned by one thread into the scratch buffer.
+ *
+ * After a pass of more than one generation the scratch buffer holds
+ * the board from before the pass, not the previous generation, so the
+ * promise of mark_active_tiles() (an inactive tile's next state is
+ * already in the scratch buffer) has to be restored by hand. Active
+ * tiles are computed anyway.
+ */
+static void settle_block_bands(void *arg, int index, int count) {
+    struct block_pass *pass = arg;
+    struct life_grid *grid = pass->grid;
+    const int words = grid->words;
+    int first = (int)((long long)pass->bands * index / count);
+    int last = (int)((long long)pass->bands * (index + 1) / count);
+    for (int band = first; band < last; band++) {
+        if (!pass->computed[band]) {
+            continue;
+        }
+        int first_row, last_row;
+        band_range(pass, band, &first_row, &last_row);
+        for (int x = first_row; x < last_row; x++) {
+            const uint8_t *active = grid->active + (size_t)(x / LIFE_TILE_ROWS) * words;
+            const uint64_t *row = grid->cells + (size_t)x * words;
+            uint64_t *out = grid->next + (size_t)x * words;
+            for (int w = 0; w < words; w++) {
+                if (!active[w]) {
+                    out[w] = row[w];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Advances the board n generations with the blocked kernel,
+ * LIFE_TIME_BLOCK generations per pass (see life_grid_step_n()).
+ */
+static int step_n_blocked(struct life_grid *grid, long long n) {
+    const size_t row_bytes = (size_t)grid->words * sizeof(uint64_t);
+    long long band_rows = (long long)(LIFE_BLOCK_BYTES / (2 * row_bytes)) - 2 * LIFE_TIME_BLOCK;
+    band_rows -= band_rows % LIFE_TILE_ROWS;
+    if (band_rows < LIFE_TILE_ROWS) {
+        band_rows = LIFE_TILE_ROWS;
+    }
+    if (band_rows > (long long)grid->tile_rows * LIFE_TILE_ROWS) {
+        band_rows = (long long)grid->tile_rows * LIFE_TILE_ROWS;
+    }
+
+    int bands = (int)((grid->height + band_rows - 1) / band_rows);
+    size_t scratch_words = 2 * ((size_t)band_rows + 2 * LIFE_TIME_BLOCK) * (size_t)grid->words;
+    if (reserve_scratch(grid, scratch_words) != 0) {
+        return -1;
+    }
+    struct block_pass pass = {
+        grid, 0, (int)band_rows, bands, grid->scratch_words, grid->scratch, grid->band_computed
+    };
+
+    const long long tiles = (long long)grid->tile_rows * grid->words;
+    for (long long done = 0; done < n; done += pass.generations) {
+        pass.generations = n - done < LIFE_TIME_BLOCK ? (int)(n - done) : LIFE_TIME_BLOCK;
+        if (grid->pool != NULL) {
+            life_pool_run(grid->pool, step_block_bands, &pass);
+        } else {
+            step_block_bands(&pass, 0, 1);
+        }
+
+        long long stepped = 0;
+        for (int band = 0; band < pass.bands; band++) {
+            if (pass.computed[band]) {
+                int first, last;
+                band_range(&pass, band, &first, &last);
+                int tile_rows = (last + LIFE_TILE_ROWS - 1) / LIFE_TILE_ROWS - first / LIFE_TILE_ROWS;
+                stepped += (long long)tile_rows * grid->words;
+            }
+        }
+        grid->tiles_stepped += stepped * pass.generations;
+        grid->tiles_skipped += (tiles - stepped) * pass.generations;
+
+        swap_buffers(grid);
+        if (pass.generations > 1) {
+            if (grid->pool != NULL) {
+                life_pool_run(grid->pool, settle_block_bands, &pass);
+            } else {
+                settle_block_bands(&pass, 0, 1);
+            }
+        }
+        grid->all_active = 0;
+    }
+    return 0;
+}
+
+int life_grid_step_n(struct life_grid *grid, long long n) {
+    if (grid->kernel == LIFE_KERNEL_SIMD && n > 0) {
+        return step_n_simd(grid, n);
+    }
+    if (grid->kernel == LIFE_KERNEL_BLOCKED && n > 0) {
+        return step_n_blocked(grid, n);
+    }
+    for (long long i = 0; i < n; i++) {
+        if (step_packed(grid) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int life_grid_step(struct life_grid *grid) {
+    return life_grid_step_n(grid, 1);
+}
+
+int life_grid_track_stats(struct life_grid *grid, int enable) {
+    if (!enable) {
+        free(grid->tile_stats);
+        grid->tile_stats = NULL;
+        return 0;
+    }
+    if (grid->tile_stats == NULL) {
+        grid->tile_stats = malloc((size_t)grid->tile_rows * grid->words * sizeof(struct life_tile_stats));
+        if (grid->tile_stats == NULL) {
+            return -1;
+        }
+        // Every tile gets a record in the next generation
+        grid->all_active = 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Widens the bounding box of stats to take in a block of cells.
+ */
+static void extend_box(struct life_grid_stats *stats, int min_x, int min_y, int max_x, int max_y) {
+    if (stats->min_x < 0) {
+        stats->min_x = min_x;
+        stats->min_y = min_y;
+        stats->max_x = max_x;
+        stats->max_y = max_y;
+        return;
+    }
+    stats->min_x = min_x < stats->min_x ? min_x : stats->min_x;
+    stats->min_y = min_y < stats->min_y ? min_y : stats->min_y;
+    stats->max_x = max_x > stats->max_x ? max_x : stats->max_x;
+    stats->max_y = max_y > stats->max_y ? max_y : stats->max_y;
+}
+
+void life_grid_stats(const struct life_grid *grid, struct life_grid_stats *stats) {
+    *stats = (struct life_grid_stats){ 0, -1, -1, -1, -1, -1, -1 };
+    const int words = grid->words;
+
+    if (grid->tile_stats == NULL || grid->all_active) {
+        // No records for this board: scan it
+        for (int x = 0; x < grid->height; x++) {
+            const uint64_t *row = grid->cells + (size_t)x * words;
+            for (int w = 0; w < words; w++) {
+                if (row[w] != 0) {
+                    stats->live += __builtin_popcountll(row[w]);
+                    extend_box(stats, x, w * 64 + __builtin_ctzll(row[w]),
+                               x, w * 64 + 63 - __builtin_clzll(row[w]));
+                }
+            }
+        }
+        return;
+    }
+
+    stats->births = 0;
+    stats->deaths = 0;
+    for (int tile_row = 0; tile_row < grid->tile_rows; tile_row++) {
+        const struct life_tile_stats *tiles = grid->tile_stats + (size_t)tile_row * words;
+        for (int w = 0; w < words; w++) {
+            const struct life_tile_stats *tile = &tiles[w];
+            stats->births += tile->births;
+            stats->deaths += tile->deaths;
+            if (tile->live != 0) {
+                stats->live += tile->live;
+                int base = tile_row * LIFE_TILE_ROWS;
+                extend_box(stats, base + tile->first_row, w * 64 + __builtin_ctzll(tile->columns),
+                           base + tile->last_row, w * 64 + 63 - __builtin_clzll(tile->columns));
+            }
+        }
+    }
+}
+
+double life_grid_skip_ratio(const struct life_grid *grid) {
+    long long total = grid->tiles_stepped + grid->tiles_skipped;
+    return total > 0 ? (double)grid->tiles_skipped / (double)total : 0.0;
+}
+
+static const char *const kernel_names[] = {
+    [LIFE_KERNEL_PACKED] = "packed",
+    [LIFE_KERNEL_SIMD] = "simd",
+    [LIFE_KERNEL_LUT] = "lut",
+    [LIFE_KERNEL_BLOCKED] = "blocked",
+};
+
+const char *life_kernel_name(enum life_kernel kernel) {
+    return kernel_names[kernel];
+}
+
+int life_kernel_parse(const char *name, enum life_kernel *kernel) {
+    for (int k = 0; k < LIFE_KERNEL_COUNT; k++) {
+        if (strcmp(name, kernel_names[k]) == 0) {
+            *kernel = (enum life_kernel)k;
+            return 0;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,340 @@
+/*******************************************************************
+ * Conway's Game of Life - Bit-Packed Grid Engine
+ *
+ * Author: hrosicka
+ * Description:
+ *   Stores the board with one bit per cell, 64 cells per 64-bit
+ *   word, and advances it with a bitwise carry-save adder that
+ *   evaluates Conway's rules (or any life-like rule, see rule.h) for
+ *   64 cells at a time.
+ *
+ * Edge Modes:
+ *   - LIFE_EDGES_WRAP: toroidal board, opposite edges are connected
+ *     (as in the glider, blinker and toad programs).
+ *   - LIFE_EDGES_CLIP: cells outside the board are always dead
+ *     (as in the gun, pulsar, beacon and LWSS programs).
+ *
+ * Coordinates follow the rest of the repository: x is the row index
+ * and y is the column index.
+ *******************************************************************/
+
+#ifndef LIFE_GRID_H
+#define LIFE_GRID_H
+
+#include <stdint.h>
+
+#include "arena.h"
+#include "pool.h"
+#include "rule.h"
+
+#define LIFE_TILE_ROWS 16   // Rows per tile; a tile is one 64-column word wide
+#define LIFE_TIME_BLOCK 8   // Generations per pass of the blocked kernel (at most LIFE_TILE_ROWS)
+#define LIFE_BLOCK_BYTES (256 * 1024)  // Cache budget of one blocked band, both generations
+
+enum life_edges {
+    LIFE_EDGES_WRAP,   // Toroidal board
+    LIFE_EDGES_CLIP    // Everything outside the board is dead
+};
+
+enum life_kernel {
+    LIFE_KERNEL_PACKED,   // Bitwise adder, 64 cells per word (default)
+    LIFE_KERNEL_SIMD,     // Byte-per-cell vector kernel (simd.c)
+    LIFE_KERNEL_LUT,      // 4x4 block lookup table, 4 cells per lookup (lut.c)
+    LIFE_KERNEL_BLOCKED,  // Packed adder, LIFE_TIME_BLOCK generations per pass over memory
+    LIFE_KERNEL_COUNT
+};
+
+/**
+ * @brief A pattern table and the position where it is placed.
+ */
+struct life_pattern {
+    const int (*cells)[2];  // {row, column} offsets of the live cells
+    int size;               // Number of cells in the table
+    int start_x;            // Starting row for the pattern
+    int start_y;            // Starting column for the pattern
+};
+
+// Builds a struct life_pattern from a table array and a position
+#define LIFE_PATTERN(table, x, y) { (table), sizeof(table) / sizeof((table)[0]), (x), (y) }
+
+/**
+ * @brief What one tile looked like after the last generation.
+ *
+ * Kept up to date by the step kernels as they go: as soon as a row of
+ * tiles is computed, each tile that changed is recounted from both
+ * generations while they are still in cache. A tile that did not
+ * change, computed or skipped, keeps its record, with no births or
+ * deaths.
+ */
+struct life_tile_stats {
+    uint64_t columns;   // OR of the tile's words: its occupied columns
+    uint16_t live;      // Live cells
+    uint16_t births;    // Cells that came alive
+    uint16_t deaths;    // Cells that died
+    uint8_t first_row;  // First occupied row of the tile, LIFE_TILE_ROWS if empty
+    uint8_t last_row;   // Last occupied row of the tile
+};
+
+/**
+ * @brief Statistics of a board, see life_grid_stats().
+ */
+struct life_grid_stats {
+    long long live;     // Live cells
+    long long births;   // Cells born in the last generation, -1 if unknown
+    long long deaths;   // Cells that died in the last generation, -1 if unknown
+    int min_x;          // Bounding box of the live cells (rows and columns,
+    int min_y;          // inclusive), all -1 on an empty board
+    int max_x;
+    int max_y;
+};
+
+/**
+ * @brief A bit-packed Game of Life board.
+ *
+ * Row x occupies words [x * words, (x + 1) * words) of each buffer.
+ * Bit b of word w in a row holds column w * 64 + b. Bits past the
+ * last column of a row are always zero.
+ *
+ * Both buffers have a ghost row just above row 0 (row -1) and just
+ * below the last row (row height). Before each generation they are
+ * filled with a copy of the opposite edge row on a torus, or with
+ * zeros on a clipped board, so the step kernel reads rows x - 1 and
+ * x + 1 without edge checks.
+ *
+ * The board is also divided into tiles of LIFE_TILE_ROWS rows by one
+ * word. Only tiles whose neighborhood changed in the last generation
+ * are computed; static and empty regions are skipped.
+ *
+ * The board size is chosen at run time. All buffers come from one
+ * cache-line aligned arena that is released by life_grid_free().
+ * kernel, rule and pool may be changed between calls to
+ * life_grid_step_n().
+ */
+struct life_grid {
+    int width;              // Number of columns
+    int height;             // Number of rows
+    int words;              // 64-bit words per row
+    enum life_edges edges;  // How the board edges behave
+    uint64_t *cells;        // Current generation (row 0; ghost rows around it)
+    uint64_t *next;         // Scratch buffer for the next generation
+    int tile_rows;          // Number of tile rows
+    uint8_t *active;        // Per tile: compute it in the next generation
+    uint8_t *changed;       // Per tile: changed in the last generation
+    const uint64_t *dead_row;  // One row of dead cells
+    uint8_t *band_computed;    // Per band of the blocked kernel: computed, not skipped
+    int all_active;         // Set when every tile must be computed
+    long long tiles_stepped;  // Tiles computed so far
+    long long tiles_skipped;  // Tiles skipped so far
+    enum life_kernel kernel;  // Step kernel used by life_grid_step_n()
+    struct life_ruleset rule; // Rule of every kernel (B3/S23 by default)
+    struct life_pool *pool;   // Worker threads, or NULL (not owned)
+    struct life_arena arena;  // Holds the grid and all of its buffers
+    struct life_arena byte_arena;  // Byte-per-cell buffers of the SIMD kernel
+    uint8_t *bytes[2];             // Halo-padded, see life_simd_step_halo()
+    uint8_t *lut;                  // Block table of a rule other than B3/S23, or NULL
+    struct life_ruleset lut_rule;  // Rule lut was built for
+    struct life_tile_stats *tile_stats;  // Per tile, or NULL if statistics are off
+    struct life_arena scratch_arena;     // Per-thread scratch of the step kernels
+    uint64_t *scratch;                   // scratch_words words for each thread
+    size_t scratch_words;                // Words of scratch per thread
+    int scratch_threads;                 // Threads the scratch was sized for
+};
+
+/**
+ * @brief Allocates an empty board.
+ *
+ * @param width Number of columns.
+ * @param height Number of rows.
+ * @param edges Edge mode of the board.
+ * @return struct life_grid* The new board, or NULL if out of memory.
+ */
+struct life_grid *life_grid_create(int width, int height, enum life_edges edges);
+
+/**
+ * @brief Releases a board created by life_grid_create().
+ *
+ * @param grid The board to free (may be NULL).
+ */
+void life_grid_free(struct life_grid *grid);
+
+/**
+ * @brief Kills every cell on the board.
+ *
+ * @param grid The board to clear.
+ */
+void life_grid_clear(struct life_grid *grid);
+
+/**
+ * @brief Returns the state of a single cell.
+ *
+ * @param grid The board.
+ * @param x The row index of the cell.
+ * @param y The column index of the cell.
+ * @return int 1 if the cell is alive, 0 if it is dead or off the board.
+ */
+int life_grid_get(const struct life_grid *grid, int x, int y);
+
+/**
+ * @brief Sets the state of a single cell.
+ *
+ * Coordinates outside the board are ignored.
+ *
+ * @param grid The board.
+ * @param x The row index of the cell.
+ * @param y The column index of the cell.
+ * @param alive 1 to make the cell alive, 0 to kill it.
+ */
+void life_grid_set(struct life_grid *grid, int x, int y, int alive);
+
+/**
+ * @brief Makes a horizontal run of cells alive.
+ *
+ * Sets whole words at a time; the part of the run outside the board
+ * is ignored.
+ *
+ * @param grid The board.
+ * @param x The row index of the run.
+ * @param y The column index of its first cell.
+ * @param length Number of cells in the run.
+ */
+void life_grid_set_run(struct life_grid *grid, long long x, long long y, long long length);
+
+/**
+ * @brief Replaces one row of the board.
+ *
+ * Unlike life_grid_set(), only the tiles around the words that really
+ * changed are computed again in the next generation, so a row rewritten
+ * every generation with mostly the same cells (such as a halo row copied
+ * in from a neighbor, see domain.h) does not wake up the whole board.
+ *
+ * @param grid The board.
+ * @param x Row index; rows outside the board are ignored.
+ * @param words The new row, grid->words words; bits past the last
+ *              column are ignored.
+ */
+void life_grid_write_row(struct life_grid *grid, int x, const uint64_t *words);
+
+/**
+ * @brief Expands the board into one byte per cell.
+ *
+ * @param grid The board.
+ * @param bytes Output, width * height bytes in row-major order; each
+ *              byte is set to 1 for a live cell and 0 for a dead one.
+ */
+void life_grid_unpack(const struct life_grid *grid, uint8_t *bytes);
+
+/**
+ * @brief Loads the board from one byte per cell.
+ *
+ * @param grid The board.
+ * @param bytes Input, width * height bytes in row-major order; any
+ *              non-zero byte is a live cell.
+ */
+void life_grid_pack(struct life_grid *grid, const uint8_t *bytes);
+
+/**
+ * @brief Counts the live cells on the board.
+ *
+ * @param grid The board.
+ * @return long long The number of live cells.
+ */
+long long life_grid_population(const struct life_grid *grid);
+
+/**
+ * @brief Places a pattern given as a table of {row, column} offsets.
+ *
+ * Cells that fall outside the board are ignored.
+ *
+ * @param grid The board.
+ * @param pattern Array of cell offsets representing the pattern.
+ * @param size Number of cells in the pattern array.
+ * @param start_x Starting row for the pattern.
+ * @param start_y Starting column for the pattern.
+ */
+void life_grid_place_pattern(struct life_grid *grid, const int pattern[][2], int size, int start_x, int start_y);
+
+/**
+ * @brief Advances the board by n generations.
+ *
+ * Uses grid->kernel, on grid->pool's threads if a pool is set. The
+ * buffers are swapped after each generation, never copied. Rows are
+ * split into one contiguous band per thread, and every row depends
+ * only on the previous generation, so the result is the same for any
+ * kernel and any number of threads.
+ *
+ * The blocked kernel is temporally blocked instead. It cuts the board
+ * into bands of whole rows sized to fit LIFE_BLOCK_BYTES. Each band is
+ * copied to a private buffer together with a skirt of k rows above and
+ * below it, where k is LIFE_TIME_BLOCK (or fewer generations at the
+ * end). The band is then advanced k generations in cache, each one
+ * computing one row less at each end of the skirt, and written back
+ * once. Memory traffic per generation drops by about a factor of k.
+ * The skirts are computed twice, which costs about k / band rows more
+ * arithmetic. Bands whose rows within k of them have no active tile
+ * cannot change in k generations and are skipped whole.
+ *
+ * @param grid The board to advance.
+ * @param n Number of generations.
+ * @return int 0 on success, -1 if the kernel's buffers could not be
+ *             allocated.
+ */
+int life_grid_step_n(struct life_grid *grid, long long n);
+
+/**
+ * @brief Advances the board by one generation (life_grid_step_n(grid, 1)).
+ *
+ * @param grid The board to advance.
+ * @return int 0 on success, -1 if the kernel's buffers could not be
+ *             allocated.
+ */
+int life_grid_step(struct life_grid *grid);
+
+/**
+ * @brief Returns the fraction of tiles skipped since the board was created.
+ *
+ * @param grid The board.
+ * @return double Skipped tiles divided by all tiles visited (0 to 1).
+ */
+double life_grid_skip_ratio(const struct life_grid *grid);
+
+/**
+ * @brief Turns the per-generation statistics of the step kernels on or off.
+ *
+ * While they are on, the kernels keep a struct life_tile_stats for
+ * every tile, updated in the same pass as each generation. While they
+ * are off the kernels do no statistics work at all.
+ *
+ * @param grid The board.
+ * @param enable 1 to turn them on, 0 to turn them off.
+ * @return int 0 on success, -1 if out of memory.
+ */
+int life_grid_track_stats(struct life_grid *grid, int enable);
+
+/**
+ * @brief Returns the population, births, deaths and bounding box of the board.
+ *
+ * Right after a generation computed with statistics on, this only
+ * adds up the tile records. Otherwise (statistics off, or the board
+ * was changed since) the board is scanned, and births and deaths are
+ * reported as -1.
+ *
+ * @param grid The board.
+ * @param stats Output.
+ */
+void life_grid_stats(const struct life_grid *grid, struct life_grid_stats *stats);
+
+/**
+ * @brief Returns the command-line name of a kernel ("packed", "simd").
+ */
+const char *life_kernel_name(enum life_kernel kernel);
+
+/**
+ * @brief Looks up a kernel by its command-line name.
+ *
+ * @param name Kernel name.
+ * @param kernel Output kernel.
+ * @return int 0 on success, -1 if the name is unknown.
+ */
+int life_kernel_parse(const char *name, enum life_kernel *kernel);
+
+#endif // LIFE_GRID_H
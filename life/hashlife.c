@@ -0,0 +1,612 @@
+/*******************************************************************
+ * Conway's Game of Life - HashLife Engine
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the universe declared in hashlife.h.
+ *
+ * Quadtree:
+ *   A node of level L is a square of 2^L x 2^L cells made of four
+ *   level L-1 children. Level 0 nodes are single cells. Every node
+ *   is looked up in a hash table keyed by its four children before it
+ *   is created, so equal squares share one node and can be compared
+ *   by pointer.
+ *
+ * Results:
+ *   next_gen(node, j) returns the central 2^(L-1) square of a level L
+ *   node advanced by 2^j generations (j <= L - 2). It only depends on
+ *   the node itself, so it is memoized on the node together with j.
+ *
+ * Collection:
+ *   Every next_gen() call that has to compute its result first checks
+ *   the memory cap. The nodes that the calls in progress still hold
+ *   (their own node, the nine squares and the partial results) are
+ *   pushed on a pin stack, so a collection can run at that point: it
+ *   marks the root, the empty nodes and the pins, and reclaims the
+ *   rest. The first pass also keeps the memoized results of the nodes
+ *   it keeps; only if that leaves more than half the cap in use are
+ *   the results dropped as well.
+ *******************************************************************/
+
+#include <stdlib.h>
+
+#include "hashlife.h"
+
+#define MAX_LEVEL 60        // Largest root: coordinates still fit a long long
+#define SLAB_NODES 4096     // Nodes allocated at once
+#define MIN_BUCKETS 4096
+#define PINS_PER_LEVEL 24   // Nodes one next_gen() call keeps pinned: itself, 9 squares, 9 + 4 results
+
+struct hl_node {
+    struct hl_node *nw, *ne, *sw, *se;  // Children; NULL for single cells
+    struct hl_node *chain;              // Next node in the same bucket
+    struct hl_node *result;             // Memoized future center, or NULL
+    uint64_t population;                // Live cells in this square
+    int level;                          // log2 of the side length
+    int result_step;                    // log2 of the generations in result
+    int marked;                         // Reachability flag used by eviction
+};
+
+struct slab {
+    struct slab *next;
+    struct hl_node nodes[SLAB_NODES];
+};
+
+struct hashlife {
+    struct hl_node **buckets;
+    size_t bucket_count;
+    size_t node_count;
+    struct slab *slabs;                 // All node storage
+    struct hl_node *free_list;          // Reclaimed nodes, linked by chain
+    struct hl_node cells[2];            // Level 0: dead and alive cell
+    struct hl_node *empty[MAX_LEVEL + 1];
+    struct hl_node *root;
+    size_t max_bytes;
+    uint64_t generation;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t collections;
+    struct life_ruleset rule;           // See hashlife_set_rule()
+    struct hl_node *pins[(MAX_LEVEL + 1) * PINS_PER_LEVEL];  // Nodes held by next_gen() calls in progress
+    size_t pin_count;
+    int failed;                         // The jump in progress ran out of memory
+};
+
+static size_t hash_children(const struct hl_node *nw, const struct hl_node *ne,
+                            const struct hl_node *sw, const struct hl_node *se) {
+    uint64_t h = (uint64_t)(uintptr_t)nw * 0x9E3779B97F4A7C15ULL;
+    h ^= (uint64_t)(uintptr_t)ne * 0xC2B2AE3D27D4EB4FULL;
+    h ^= (uint64_t)(uintptr_t)sw * 0x165667B19E3779F9ULL;
+    h ^= (uint64_t)(uintptr_t)se * 0x27D4EB2F165667C5ULL;
+    return (size_t)(h ^ (h >> 29));
+}
+
+/**
+ * @brief Memory held by live nodes and the hash table.
+ *
+ * Reclaimed nodes go to a free list and are reused before new slabs
+ * are allocated, so they are not counted.
+ */
+static size_t memory_in_use(const struct hashlife *hl) {
+    return hl->node_count * sizeof(struct hl_node) + hl->bucket_count * sizeof(struct hl_node *);
+}
+
+/**
+ * @brief Doubles the hash table once it holds more nodes than buckets.
+ */
+static void grow_table(struct hashlife *hl) {
+    size_t count = hl->bucket_count * 2;
+    struct hl_node **buckets = calloc(count, sizeof(*buckets));
+    if (buckets == NULL) {
+        return; // Keep the longer chains; lookups stay correct
+    }
+    for (size_t i = 0; i < hl->bucket_count; i++) {
+        struct hl_node *node = hl->buckets[i];
+        while (node != NULL) {
+            struct hl_node *next = node->chain;
+            size_t b = hash_children(node->nw, node->ne, node->sw, node->se) & (count - 1);
+            node->chain = buckets[b];
+            buckets[b] = node;
+            node = next;
+        }
+    }
+    free(hl->buckets);
+    hl->buckets = buckets;
+    hl->bucket_count = count;
+}
+
+static struct hl_node *alloc_node(struct hashlife *hl) {
+    if (hl->free_list == NULL) {
+        struct slab *slab = malloc(sizeof(*slab));
+        if (slab == NULL) {
+            return NULL;
+        }
+        slab->next = hl->slabs;
+        hl->slabs = slab;
+        for (int i = SLAB_NODES - 1; i >= 0; i--) {
+            slab->nodes[i].chain = hl->free_list;
+            hl->free_list = &slab->nodes[i];
+        }
+    }
+    struct hl_node *node = hl->free_list;
+    hl->free_list = node->chain;
+    return node;
+}
+
+/**
+ * @brief Returns the canonical node with the given children.
+ *
+ * @return struct hl_node* The node, or NULL if a child is NULL or
+ *                         memory runs out.
+ */
+static struct hl_node *join(struct hashlife *hl, struct hl_node *nw, struct hl_node *ne,
+                            struct hl_node *sw, struct hl_node *se) {
+    if (nw == NULL || ne == NULL || sw == NULL || se == NULL) {
+        return NULL;
+    }
+
+    size_t b = hash_children(nw, ne, sw, se) & (hl->bucket_count - 1);
+    for (struct hl_node *node = hl->buckets[b]; node != NULL; node = node->chain) {
+        if (node->nw == nw && node->ne == ne && node->sw == sw && node->se == se) {
+            return node;
+        }
+    }
+
+    struct hl_node *node = alloc_node(hl);
+    if (node == NULL) {
+        return NULL;
+    }
+    node->nw = nw;
+    node->ne = ne;
+    node->sw = sw;
+    node->se = se;
+    node->result = NULL;
+    node->result_step = -1;
+    node->population = nw->population + ne->population + sw->population + se->population;
+    node->level = nw->level + 1;
+    node->marked = 0;
+    node->chain = hl->buckets[b];
+    hl->buckets[b] = node;
+
+    if (++hl->node_count > hl->bucket_count) {
+        grow_table(hl);
+    }
+    return node;
+}
+
+/**
+ * @brief Returns the all-dead node of a given level.
+ */
+static struct hl_node *empty_node(struct hashlife *hl, int level) {
+    if (level == 0) {
+        return &hl->cells[0];
+    }
+    if (hl->empty[level] == NULL) {
+        struct hl_node *child = empty_node(hl, level - 1);
+        hl->empty[level] = join(hl, child, child, child, child);
+    }
+    return hl->empty[level];
+}
+
+/**
+ * @brief Central half of a node, without advancing time.
+ */
+static struct hl_node *center(struct hashlife *hl, struct hl_node *node) {
+    if (node == NULL) {
+        return NULL;
+    }
+    return join(hl, node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+}
+
+/**
+ * @brief Square straddling the border between two side-by-side nodes.
+ */
+static struct hl_node *center_horizontal(struct hashlife *hl, struct hl_node *w, struct hl_node *e) {
+    return join(hl, w->ne, e->nw, w->se, e->sw);
+}
+
+/**
+ * @brief Square straddling the border between two stacked nodes.
+ */
+static struct hl_node *center_vertical(struct hashlife *hl, struct hl_node *n, struct hl_node *s) {
+    return join(hl, n->sw, n->se, s->nw, s->ne);
+}
+
+/**
+ * @brief Advances the central 2x2 cells of a 4x4 node by one generation.
+ */
+static struct hl_node *base_case(struct hashlife *hl, struct hl_node *node) {
+    int cells[4][4];
+    struct hl_node *quads[2][2] = { { node->nw, node->ne }, { node->sw, node->se } };
+    for (int qx = 0; qx < 2; qx++) {
+        for (int qy = 0; qy < 2; qy++) {
+            struct hl_node *q = quads[qx][qy];
+            cells[qx * 2][qy * 2] = (int)q->nw->population;
+            cells[qx * 2][qy * 2 + 1] = (int)q->ne->population;
+            cells[qx * 2 + 1][qy * 2] = (int)q->sw->population;
+            cells[qx * 2 + 1][qy * 2 + 1] = (int)q->se->population;
+        }
+    }
+
+    struct hl_node *out[2][2];
+    for (int x = 1; x <= 2; x++) {
+        for (int y = 1; y <= 2; y++) {
+            int neighbors = 0;
+            for (int i = -1; i <= 1; i++) {
+                for (int j = -1; j <= 1; j++) {
+                    if (i != 0 || j != 0) {
+                        neighbors += cells[x + i][y + j];
+                    }
+                }
+            }
+            int alive = life_rule_next(&hl->rule, cells[x][y], neighbors);
+            out[x - 1][y - 1] = &hl->cells[alive];
+        }
+    }
+    return join(hl, out[0][0], out[0][1], out[1][0], out[1][1]);
+}
+
+/**
+ * @brief Marks a node and everything below it as reachable.
+ *
+ * @param results Also keep the memoized results of the marked nodes.
+ */
+static void mark(struct hl_node *node, int results) {
+    while (node != NULL && node->level > 0 && !node->marked) {
+        node->marked = 1;
+        mark(node->nw, results);
+        mark(node->ne, results);
+        mark(node->sw, results);
+        if (results) {
+            mark(node->result, results);
+        }
+        node = node->se;
+    }
+}
+
+/**
+ * @brief Reclaims every node not reachable from the root, the empty
+ * nodes or the pin stack.
+ *
+ * @param results Keep the memoized results of the nodes that stay;
+ *                otherwise they are evicted.
+ */
+static void collect(struct hashlife *hl, int results) {
+    mark(hl->root, results);
+    for (int level = 1; level <= MAX_LEVEL; level++) {
+        mark(hl->empty[level], results);
+    }
+    for (size_t i = 0; i < hl->pin_count; i++) {
+        mark(hl->pins[i], results);
+    }
+
+    for (size_t i = 0; i < hl->bucket_count; i++) {
+        struct hl_node **link = &hl->buckets[i];
+        while (*link != NULL) {
+            struct hl_node *node = *link;
+            if (node->marked) {
+                node->marked = 0;
+                if (!results) {
+                    node->result = NULL;
+                    node->result_step = -1;
+                }
+                link = &node->chain;
+            } else {
+                *link = node->chain;
+                node->chain = hl->free_list;
+                hl->free_list = node;
+                hl->node_count--;
+            }
+        }
+    }
+    hl->collections++;
+}
+
+/**
+ * @brief Brings the memory in use back under the cap.
+ *
+ * @return int 0 on success, -1 if the nodes still in use take more
+ *             than three quarters of the cap.
+ */
+static int reclaim(struct hashlife *hl) {
+    collect(hl, 1);
+    if (memory_in_use(hl) > hl->max_bytes / 2) {
+        collect(hl, 0);
+    }
+    return memory_in_use(hl) > hl->max_bytes / 4 * 3 ? -1 : 0;
+}
+
+static void pin(struct hashlife *hl, struct hl_node *node) {
+    hl->pins[hl->pin_count++] = node;
+}
+
+/**
+ * @brief Central half of a level L node advanced by 2^j generations.
+ *
+ * The node is cut into nine overlapping level L-1 squares. For a full
+ * step (j == L - 2) each square is advanced 2^(L-3) generations, and
+ * the four squares assembled from those results are advanced another
+ * 2^(L-3). For a smaller step the nine squares are only trimmed to
+ * their centers and all of the time is spent in the second round.
+ *
+ * Every node the call holds across a nested call is pinned, so the
+ * nested call may collect (see the Collection notes above).
+ */
+static struct hl_node *next_gen(struct hashlife *hl, struct hl_node *node, int j) {
+    if (node == NULL || hl->failed) {
+        return NULL;
+    }
+    if (node->population == 0) {
+        return empty_node(hl, node->level - 1);
+    }
+    if (node->result != NULL && node->result_step == j) {
+        hl->hits++;
+        return node->result;
+    }
+    hl->misses++;
+
+    size_t pinned = hl->pin_count;
+    pin(hl, node);
+    if (hl->max_bytes > 0 && memory_in_use(hl) > hl->max_bytes && reclaim(hl) != 0) {
+        hl->failed = 1;
+        hl->pin_count = pinned;
+        return NULL;
+    }
+
+    struct hl_node *result;
+    if (node->level == 2) {
+        result = base_case(hl, node);
+    } else {
+        struct hl_node *n[3][3];
+        n[0][0] = node->nw;
+        n[0][1] = center_horizontal(hl, node->nw, node->ne);
+        n[0][2] = node->ne;
+        n[1][0] = center_vertical(hl, node->nw, node->sw);
+        n[1][1] = center(hl, node);
+        n[1][2] = center_vertical(hl, node->ne, node->se);
+        n[2][0] = node->sw;
+        n[2][1] = center_horizontal(hl, node->sw, node->se);
+        n[2][2] = node->se;
+        for (int a = 0; a < 3; a++) {
+            for (int b = 0; b < 3; b++) {
+                pin(hl, n[a][b]);
+            }
+        }
+
+        int full = j == node->level - 2;
+        int inner = full ? node->level - 3 : j;
+        struct hl_node *r[3][3];
+        for (int a = 0; a < 3; a++) {
+            for (int b = 0; b < 3; b++) {
+                r[a][b] = full ? next_gen(hl, n[a][b], inner) : center(hl, n[a][b]);
+                pin(hl, r[a][b]);
+            }
+        }
+
+        struct hl_node *quads[4];
+        for (int q = 0; q < 4; q++) {
+            int a = q / 2, b = q % 2;
+            quads[q] = next_gen(hl, join(hl, r[a][b], r[a][b + 1], r[a + 1][b], r[a + 1][b + 1]), inner);
+            pin(hl, quads[q]);
+        }
+        result = join(hl, quads[0], quads[1], quads[2], quads[3]);
+    }
+    hl->pin_count = pinned;
+
+    if (result != NULL) {
+        node->result = result;
+        node->result_step = j;
+    }
+    return result;
+}
+
+struct hashlife *hashlife_create(size_t max_bytes) {
+    struct hashlife *hl = calloc(1, sizeof(*hl));
+    if (hl == NULL) {
+        return NULL;
+    }
+    hl->max_bytes = max_bytes;
+    hl->rule = (struct life_ruleset)LIFE_RULE_CONWAY;
+    hl->bucket_count = MIN_BUCKETS;
+    hl->buckets = calloc(hl->bucket_count, sizeof(*hl->buckets));
+    if (hl->buckets == NULL) {
+        free(hl);
+        return NULL;
+    }
+    hl->cells[0].population = 0;
+    hl->cells[1].population = 1;
+
+    hl->root = empty_node(hl, 3);
+    if (hl->root == NULL) {
+        hashlife_free(hl);
+        return NULL;
+    }
+    return hl;
+}
+
+void hashlife_free(struct hashlife *hl) {
+    if (hl == NULL) {
+        return;
+    }
+    while (hl->slabs != NULL) {
+        struct slab *next = hl->slabs->next;
+        free(hl->slabs);
+        hl->slabs = next;
+    }
+    free(hl->buckets);
+    free(hl);
+}
+
+/**
+ * @brief Grows the root by one level, keeping the pattern centered.
+ */
+static int expand(struct hashlife *hl) {
+    struct hl_node *root = hl->root;
+    if (root->level >= MAX_LEVEL) {
+        return -1;
+    }
+    struct hl_node *e = empty_node(hl, root->level - 1);
+    struct hl_node *bigger = join(hl,
+        join(hl, e, e, e, root->nw),
+        join(hl, e, e, root->ne, e),
+        join(hl, e, root->sw, e, e),
+        join(hl, root->se, e, e, e));
+    if (bigger == NULL) {
+        return -1;
+    }
+    hl->root = bigger;
+    return 0;
+}
+
+/**
+ * @brief Tells whether a cell lies inside the current root.
+ */
+static int in_root(const struct hashlife *hl, long long x, long long y) {
+    long long half = 1LL << (hl->root->level - 1);
+    return x >= -half && x < half && y >= -half && y < half;
+}
+
+/**
+ * @brief Returns a copy of node with one cell changed.
+ *
+ * @param x Row of the cell relative to the node's top-left corner.
+ * @param y Column of the cell relative to the node's top-left corner.
+ */
+static struct hl_node *set_cell(struct hashlife *hl, struct hl_node *node,
+                                long long x, long long y, int alive) {
+    if (node->level == 0) {
+        return &hl->cells[alive != 0];
+    }
+    long long half = 1LL << (node->level - 1);
+    struct hl_node *nw = node->nw, *ne = node->ne, *sw = node->sw, *se = node->se;
+    if (x < half) {
+        if (y < half) {
+            nw = set_cell(hl, nw, x, y, alive);
+        } else {
+            ne = set_cell(hl, ne, x, y - half, alive);
+        }
+    } else {
+        if (y < half) {
+            sw = set_cell(hl, sw, x - half, y, alive);
+        } else {
+            se = set_cell(hl, se, x - half, y - half, alive);
+        }
+    }
+    return join(hl, nw, ne, sw, se);
+}
+
+int hashlife_set(struct hashlife *hl, long long x, long long y, int alive) {
+    while (!in_root(hl, x, y)) {
+        if (expand(hl) != 0) {
+            return -1;
+        }
+    }
+    long long half = 1LL << (hl->root->level - 1);
+    struct hl_node *root = set_cell(hl, hl->root, x + half, y + half, alive);
+    if (root == NULL) {
+        return -1;
+    }
+    hl->root = root;
+    return 0;
+}
+
+int hashlife_get(const struct hashlife *hl, long long x, long long y) {
+    if (!in_root(hl, x, y)) {
+        return 0;
+    }
+    const struct hl_node *node = hl->root;
+    long long half = 1LL << (node->level - 1);
+    x += half;
+    y += half;
+    while (node->level > 0 && node->population > 0) {
+        half = 1LL << (node->level - 1);
+        int south = x >= half;
+        int east = y >= half;
+        if (south) {
+            x -= half;
+        }
+        if (east) {
+            y -= half;
+        }
+        node = south ? (east ? node->se : node->sw) : (east ? node->ne : node->nw);
+    }
+    return (int)node->population;
+}
+
+int hashlife_place_pattern(struct hashlife *hl, const int pattern[][2], int size,
+                           long long start_x, long long start_y) {
+    for (int i = 0; i < size; i++) {
+        if (hashlife_set(hl, start_x + pattern[i][0], start_y + pattern[i][1], 1) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Tells whether every live cell is in the central quarter of the root.
+ */
+static int centered(const struct hl_node *root) {
+    uint64_t inner = root->nw->se->se->population + root->ne->sw->sw->population +
+                     root->sw->ne->ne->population + root->se->nw->nw->population;
+    return inner == root->population;
+}
+
+int hashlife_step_pow2(struct hashlife *hl, int k) {
+    if (k < 0 || k > MAX_LEVEL - 4) {
+        return -1;
+    }
+
+    // The pattern can spread 2^k cells per side; keep it clear of the
+    // part of the root that the result drops.
+    while (hl->root->level < k + 3 || !centered(hl->root)) {
+        if (expand(hl) != 0) {
+            return -1;
+        }
+    }
+
+    hl->failed = 0;
+    struct hl_node *result = next_gen(hl, hl->root, k);
+    if (result == NULL) {
+        return -1;
+    }
+    hl->root = result;
+    hl->generation += 1ULL << k;
+    return 0;
+}
+
+int hashlife_advance(struct hashlife *hl, uint64_t generations) {
+    for (int k = 0; generations != 0; k++, generations >>= 1) {
+        if ((generations & 1) && hashlife_step_pow2(hl, k) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void hashlife_set_rule(struct hashlife *hl, const struct life_ruleset *rule) {
+    hl->rule = *rule;
+
+    // Every memoized result was computed under the old rule
+    for (size_t b = 0; b < hl->bucket_count; b++) {
+        for (struct hl_node *node = hl->buckets[b]; node != NULL; node = node->chain) {
+            node->result = NULL;
+        }
+    }
+}
+
+uint64_t hashlife_generation(const struct hashlife *hl) {
+    return hl->generation;
+}
+
+uint64_t hashlife_population(const struct hashlife *hl) {
+    return hl->root->population;
+}
+
+void hashlife_get_stats(const struct hashlife *hl, struct hashlife_stats *stats) {
+    stats->nodes = hl->node_count;
+    stats->bytes = memory_in_use(hl);
+    stats->hits = hl->hits;
+    stats->misses = hl->misses;
+    stats->collections = hl->collections;
+}
@@ -0,0 +1,146 @@
+/*******************************************************************
+ * Conway's Game of Life - HashLife Engine
+ *
+ * Author: hrosicka
+ * Description:
+ *   Simulates an unbounded plane with Gosper's HashLife algorithm.
+ *   The universe is a quadtree whose nodes are canonicalized in a
+ *   hash table, so identical regions are stored once. For every node
+ *   the future of its center is memoized, which lets periodic or
+ *   repetitive patterns (such as the Gosper glider gun) jump 2^k
+ *   generations in a single call.
+ *
+ * Memory:
+ *   The cap is checked before every result that has to be computed,
+ *   also in the middle of a jump. When it is exceeded, the nodes that
+ *   are neither part of the universe nor held by the jump in progress
+ *   are reclaimed, keeping the memoized results of the nodes left. If
+ *   more than half the cap is still in use, those results are evicted
+ *   too. A jump whose own nodes do not fit in three quarters of the
+ *   cap fails.
+ *
+ * Coordinates follow the rest of the repository: x is the row index
+ * and y is the column index. Both may be negative.
+ *******************************************************************/
+
+#ifndef LIFE_HASHLIFE_H
+#define LIFE_HASHLIFE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rule.h"
+
+struct hashlife;
+
+/**
+ * @brief Counters describing the state of a HashLife universe.
+ */
+struct hashlife_stats {
+    size_t nodes;           // Canonical nodes currently stored
+    size_t bytes;           // Memory held by nodes and the hash table
+    uint64_t hits;          // Memoized results reused
+    uint64_t misses;        // Results that had to be computed
+    uint64_t collections;   // Times unused nodes were reclaimed to honor the cap
+};
+
+/**
+ * @brief Creates an empty universe.
+ *
+ * @param max_bytes Memory cap for nodes and the hash table; 0 means
+ *                  no cap.
+ * @return struct hashlife* The universe, or NULL if out of memory.
+ */
+struct hashlife *hashlife_create(size_t max_bytes);
+
+/**
+ * @brief Frees a universe created by hashlife_create().
+ *
+ * @param hl The universe to free (may be NULL).
+ */
+void hashlife_free(struct hashlife *hl);
+
+/**
+ * @brief Sets the state of a single cell.
+ *
+ * @param hl The universe.
+ * @param x The row index of the cell.
+ * @param y The column index of the cell.
+ * @param alive 1 to make the cell alive, 0 to kill it.
+ * @return int 0 on success, -1 if out of memory.
+ */
+int hashlife_set(struct hashlife *hl, long long x, long long y, int alive);
+
+/**
+ * @brief Returns the state of a single cell.
+ *
+ * @return int 1 if the cell is alive, 0 otherwise.
+ */
+int hashlife_get(const struct hashlife *hl, long long x, long long y);
+
+/**
+ * @brief Places a pattern given as a table of {row, column} offsets.
+ *
+ * Accepts the same tables the programs pass to place_pattern().
+ *
+ * @param hl The universe.
+ * @param pattern Array of cell offsets representing the pattern.
+ * @param size Number of cells in the pattern array.
+ * @param start_x Starting row for the pattern.
+ * @param start_y Starting column for the pattern.
+ * @return int 0 on success, -1 if out of memory.
+ */
+int hashlife_place_pattern(struct hashlife *hl, const int pattern[][2], int size,
+                           long long start_x, long long start_y);
+
+/**
+ * @brief Sets the rule of later generations (B3/S23 by default).
+ *
+ * Forgets every memoized result, since those hold the future under
+ * the old rule.
+ *
+ * @param hl The universe.
+ * @param rule The rule; must not use B0.
+ */
+void hashlife_set_rule(struct hashlife *hl, const struct life_ruleset *rule);
+
+/**
+ * @brief Advances the universe by exactly 2^k generations in one call.
+ *
+ * @param hl The universe.
+ * @param k Base-2 logarithm of the number of generations (0 to 56).
+ * @return int 0 on success, -1 if k is out of range or out of memory
+ *             (including the cap); the universe is then unchanged.
+ */
+int hashlife_step_pow2(struct hashlife *hl, int k);
+
+/**
+ * @brief Advances the universe by an arbitrary number of generations.
+ *
+ * The count is split into power-of-two jumps, one per set bit.
+ *
+ * @param hl The universe.
+ * @param generations Number of generations to advance.
+ * @return int 0 on success, -1 if out of memory.
+ */
+int hashlife_advance(struct hashlife *hl, uint64_t generations);
+
+/**
+ * @brief Returns the number of generations simulated so far.
+ */
+uint64_t hashlife_generation(const struct hashlife *hl);
+
+/**
+ * @brief Returns the number of live cells in the universe.
+ */
+uint64_t hashlife_population(const struct hashlife *hl);
+
+/**
+ * @brief Fills in the node and cache counters of the universe.
+ *
+ * @param hl The universe.
+ * @param stats Output counters.
+ */
+void hashlife_get_stats(const struct hashlife *hl, struct hashlife_stats *stats);
+
+#endif // LIFE_HASHLIFE_H
@@ -0,0 +1,465 @@
+/*******************************************************************
+ * Conway's Game of Life - Pattern File Loader
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the loader declared in load.h.
+ *
+ *   Each parser walks the mapped bytes once with a cursor and calls
+ *   the board's run callback as soon as a run of live cells is
+ *   complete, so memory use does not depend on the pattern size.
+ *******************************************************************/
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "load.h"
+
+#define MAX_COUNT (1LL << 40)   // Largest run count or coordinate accepted
+
+/**
+ * @brief Parsing state shared by the three formats.
+ */
+struct parser {
+    const char *p;          // Next byte to read
+    const char *end;        // One past the last byte
+    long line;              // Line of p, counted from 1
+    long long x;            // Row offset of the pattern
+    long long y;            // Column offset of the pattern
+    life_load_run run;
+    void *board;
+    long long cells;        // Live cells handed to run
+};
+
+static int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Skips the rest of the current line, including its newline.
+ */
+static void skip_line(struct parser *ps) {
+    const char *newline = memchr(ps->p, '\n', (size_t)(ps->end - ps->p));
+    if (newline == NULL) {
+        ps->p = ps->end;
+    } else {
+        ps->p = newline + 1;
+        ps->line++;
+    }
+}
+
+/**
+ * @brief Skips spaces and tabs, but not newlines.
+ */
+static void skip_spaces(struct parser *ps) {
+    while (ps->p < ps->end && is_space(*ps->p)) {
+        ps->p++;
+    }
+}
+
+/**
+ * @brief Reads an optionally signed decimal number.
+ *
+ * @return int 0 on success, -1 if there is no number or it is out of
+ *             range.
+ */
+static int read_number(struct parser *ps, long long *value) {
+    int negative = 0;
+    if (ps->p < ps->end && (*ps->p == '-' || *ps->p == '+')) {
+        negative = *ps->p == '-';
+        ps->p++;
+    }
+    if (ps->p == ps->end || !is_digit(*ps->p)) {
+        return -1;
+    }
+    long long number = 0;
+    while (ps->p < ps->end && is_digit(*ps->p)) {
+        number = number * 10 + (*ps->p - '0');
+        if (number > MAX_COUNT) {
+            return -1;
+        }
+        ps->p++;
+    }
+    *value = negative ? -number : number;
+    return 0;
+}
+
+/**
+ * @brief Hands a run of live cells, relative to the pattern origin, to the board.
+ */
+static int emit(struct parser *ps, long long row, long long col, long long length) {
+    ps->cells += length;
+    return ps->run(ps->board, ps->x + row, ps->y + col, length);
+}
+
+/**
+ * @brief Reads the value of the "rule = B3/S23" header field.
+ *
+ * A Golly bounded-grid suffix (":T100,100") is ignored.
+ *
+ * @return int 0 on success, -1 if the rule cannot be run.
+ */
+static int read_rule(struct parser *ps, struct life_load_info *info) {
+    char text[LIFE_RULE_TEXT_MAX];
+    size_t length = 0;
+    while (ps->p < ps->end && *ps->p != ',' && *ps->p != ':' && *ps->p != '\n' && !is_space(*ps->p)) {
+        if (length + 1 == sizeof(text)) {
+            return -1;
+        }
+        text[length++] = *ps->p++;
+    }
+    text[length] = '\0';
+    if (life_rule_parse(text, &info->rule) != 0) {
+        return -1;
+    }
+    info->has_rule = 1;
+    return 0;
+}
+
+/**
+ * @brief Reads the "x = 3, y = 3, rule = B3/S23" header of an RLE file.
+ *
+ * Leaves the cursor on the line after the header.
+ */
+static int parse_rle_header(struct parser *ps, struct life_load_info *info) {
+    while (ps->p < ps->end && *ps->p != '\n') {
+        int is_rule = ps->end - ps->p > 4 && memcmp(ps->p, "rule", 4) == 0;
+        char key = *ps->p;
+        ps->p += is_rule ? 4 : 1;
+        skip_spaces(ps);
+        if (is_rule && ps->p < ps->end && *ps->p == '=') {
+            ps->p++;
+            skip_spaces(ps);
+            if (read_rule(ps, info) != 0) {
+                return -1;
+            }
+        } else if ((key == 'x' || key == 'y') && ps->p < ps->end && *ps->p == '=') {
+            ps->p++;
+            skip_spaces(ps);
+            long long value;
+            if (read_number(ps, &value) != 0 || value < 0) {
+                return -1;
+            }
+            if (key == 'x') {
+                info->width = value;
+            } else {
+                info->height = value;
+            }
+        }
+        // Anything else (separators, the rest of the rule) is skipped
+        while (ps->p < ps->end && *ps->p != ',' && *ps->p != '\n') {
+            ps->p++;
+        }
+        if (ps->p < ps->end && *ps->p == ',') {
+            ps->p++;
+        }
+        skip_spaces(ps);
+    }
+    skip_line(ps);
+    return 0;
+}
+
+static int parse_rle(struct parser *ps, struct life_load_info *info) {
+    // Comment lines and the header come first
+    for (;;) {
+        skip_spaces(ps);
+        if (ps->p == ps->end) {
+            return 0;
+        }
+        if (*ps->p == '#' || *ps->p == '\n') {
+            skip_line(ps);
+        } else if (*ps->p == 'x') {
+            if (parse_rle_header(ps, info) != 0) {
+                return -1;
+            }
+            break;
+        } else {
+            break;  // No header
+        }
+    }
+
+    // The cursor is kept in a local so it stays in a register across the run callbacks
+    const char *p = ps->p, *end = ps->end;
+    long long row = 0, col = 0;
+    int status = 0;
+    while (p < end) {
+        char c = *p++;
+        long long count = 1;
+        if (is_digit(c)) {
+            count = c - '0';
+            while (p < end && is_digit(*p) && count <= MAX_COUNT) {
+                count = count * 10 + (*p++ - '0');
+            }
+            if (p == end || count > MAX_COUNT) {
+                status = -1;
+                break;
+            }
+            c = *p++;
+        }
+        if (c == 'b' || c == '.') {
+            col += count;
+        } else if (c == '$') {
+            row += count;
+            col = 0;
+        } else if (c == '!') {
+            break;
+        } else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            // 'o', or any other state letter of a multi-state file, is alive
+            if (count > 0 && emit(ps, row, col, count) != 0) {
+                status = -1;
+                break;
+            }
+            col += count;
+        } else if (c == '\n' && count == 1) {
+            ps->line++;
+        } else if (!is_space(c) || count != 1) {
+            p--;
+            status = -1;
+            break;
+        }
+    }
+    ps->p = p;
+    return status;  // A missing '!' is tolerated
+}
+
+/**
+ * @brief Parses Life 1.06: one "column row" pair per line.
+ *
+ * Cells that continue a run on the same row are merged into one call.
+ */
+static int parse_life106(struct parser *ps) {
+    long long run_row = 0, run_col = 0, run_length = 0;
+    while (ps->p < ps->end) {
+        skip_spaces(ps);
+        if (ps->p == ps->end) {
+            break;
+        }
+        if (*ps->p == '#' || *ps->p == '\n') {
+            skip_line(ps);
+            continue;
+        }
+        long long col, row;
+        if (read_number(ps, &col) != 0) {
+            return -1;
+        }
+        skip_spaces(ps);
+        if (read_number(ps, &row) != 0) {
+            return -1;
+        }
+        skip_spaces(ps);
+        if (ps->p < ps->end && *ps->p != '\n') {
+            return -1;
+        }
+        skip_line(ps);
+
+        if (run_length > 0 && row == run_row && col == run_col + run_length) {
+            run_length++;
+            continue;
+        }
+        if (run_length > 0 && emit(ps, run_row, run_col, run_length) != 0) {
+            return -1;
+        }
+        run_row = row;
+        run_col = col;
+        run_length = 1;
+    }
+    return run_length > 0 ? emit(ps, run_row, run_col, run_length) : 0;
+}
+
+/**
+ * @brief Parses plaintext: 'O' alive, '.' dead, '!' comment lines.
+ */
+static int parse_cells(struct parser *ps) {
+    long long row = 0;
+    while (ps->p < ps->end) {
+        if (*ps->p == '!') {
+            skip_line(ps);
+            continue;
+        }
+        long long col = 0, start = -1;
+        while (ps->p < ps->end && *ps->p != '\n') {
+            char c = *ps->p;
+            int alive = c == 'O' || c == 'o' || c == '*';
+            if (alive && start < 0) {
+                start = col;
+            } else if (!alive) {
+                if (start >= 0 && emit(ps, row, start, col - start) != 0) {
+                    return -1;
+                }
+                start = -1;
+                if (c != '.' && !is_space(c)) {
+                    return -1;
+                }
+            }
+            col++;
+            ps->p++;
+        }
+        if (start >= 0 && emit(ps, row, start, col - start) != 0) {
+            return -1;
+        }
+        skip_line(ps);
+        row++;
+    }
+    return 0;
+}
+
+static int has_prefix(const char *data, size_t size, const char *prefix) {
+    size_t length = strlen(prefix);
+    return size >= length && memcmp(data, prefix, length) == 0;
+}
+
+/**
+ * @brief Guesses the format from the first lines of the file.
+ */
+static enum life_format detect_contents(const char *data, size_t size) {
+    if (has_prefix(data, size, "#Life 1.06")) {
+        return LIFE_FORMAT_LIFE106;
+    }
+    if (has_prefix(data, size, "!")) {
+        return LIFE_FORMAT_CELLS;
+    }
+    // RLE files may start with '#' comment lines before the header
+    const char *p = data, *end = data + size;
+    while (p < end && (*p == '#' || *p == '\n')) {
+        const char *newline = memchr(p, '\n', (size_t)(end - p));
+        p = newline != NULL ? newline + 1 : end;
+    }
+    while (p < end && is_space(*p)) {
+        p++;
+    }
+    if (p < end && (*p == '.' || *p == 'O')) {
+        return LIFE_FORMAT_CELLS;
+    }
+    return LIFE_FORMAT_RLE;
+}
+
+/**
+ * @brief Picks the format from the file extension, if it is a known one.
+ */
+static enum life_format detect_extension(const char *path) {
+    const char *dot = strrchr(path, '.');
+    if (dot == NULL || strchr(dot, '/') != NULL) {
+        return LIFE_FORMAT_AUTO;
+    }
+    if (strcmp(dot, ".rle") == 0) {
+        return LIFE_FORMAT_RLE;
+    }
+    if (strcmp(dot, ".lif") == 0 || strcmp(dot, ".life") == 0) {
+        return LIFE_FORMAT_LIFE106;
+    }
+    if (strcmp(dot, ".cells") == 0) {
+        return LIFE_FORMAT_CELLS;
+    }
+    return LIFE_FORMAT_AUTO;
+}
+
+int life_load_buffer(const char *data, size_t size, enum life_format format, long long x, long long y,
+                     life_load_run run, void *board, struct life_load_info *info) {
+    struct life_load_info local;
+    if (info == NULL) {
+        info = &local;
+    }
+    memset(info, 0, sizeof(*info));
+    if (format == LIFE_FORMAT_AUTO) {
+        format = detect_contents(data, size);
+    }
+    info->format = format;
+
+    struct parser ps = { .p = data, .end = data + size, .line = 1, .x = x, .y = y,
+                         .run = run, .board = board, .cells = 0 };
+    int status;
+    switch (format) {
+    case LIFE_FORMAT_LIFE106:
+        status = parse_life106(&ps);
+        break;
+    case LIFE_FORMAT_CELLS:
+        status = parse_cells(&ps);
+        break;
+    default:
+        status = parse_rle(&ps, info);
+        break;
+    }
+    info->cells = ps.cells;
+    if (status != 0) {
+        info->error_line = ps.line;
+    }
+    return status;
+}
+
+/**
+ * @brief Reads a file that cannot be mapped (a pipe) into memory.
+ *
+ * @return char* The contents, or NULL on failure; free() it.
+ */
+static char *read_all(int fd, size_t *size) {
+    size_t capacity = 1 << 16, used = 0;
+    char *data = malloc(capacity);
+    while (data != NULL) {
+        ssize_t got = read(fd, data + used, capacity - used);
+        if (got < 0) {
+            break;
+        }
+        if (got == 0) {
+            *size = used;
+            return data;
+        }
+        used += (size_t)got;
+        if (used == capacity) {
+            char *bigger = realloc(data, capacity * 2);
+            if (bigger == NULL) {
+                break;
+            }
+            data = bigger;
+            capacity *= 2;
+        }
+    }
+    free(data);
+    return NULL;
+}
+
+int life_load_file(const char *path, enum life_format format, long long x, long long y,
+                   life_load_run run, void *board, struct life_load_info *info) {
+    if (info != NULL) {
+        memset(info, 0, sizeof(*info));
+    }
+    if (format == LIFE_FORMAT_AUTO) {
+        format = detect_extension(path);
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    int status;
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        size_t size = (size_t)st.st_size;
+        void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+        status = life_load_buffer(data, size, format, x, y, run, board, info);
+        munmap(data, size);
+    } else {
+        size_t size = 0;
+        char *data = read_all(fd, &size);
+        status = data != NULL ? life_load_buffer(data, size, format, x, y, run, board, info) : -1;
+        free(data);
+    }
+    close(fd);
+    return status;
+}
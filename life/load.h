@@ -0,0 +1,87 @@
+/*******************************************************************
+ * Conway's Game of Life - Pattern File Loader
+ *
+ * Author: hrosicka
+ * Description:
+ *   Reads patterns in the three common formats:
+ *
+ *   - RLE (.rle): "x = 3, y = 3, rule = B3/S23" header followed by
+ *     run-length encoded rows ("bo$2bo$3o!").
+ *   - Life 1.06 (.lif, .life): "#Life 1.06" followed by one
+ *     "column row" pair per live cell.
+ *   - Plaintext (.cells): one line per row, 'O' alive and '.' dead,
+ *     '!' starts a comment line.
+ *
+ *   The file is mapped into memory and parsed in a single pass.
+ *   Cells are handed to the board as runs of live cells in one row
+ *   while parsing, so no intermediate cell list is ever built and
+ *   an RLE run of a million cells costs one call.
+ *
+ * Coordinates follow the rest of the repository: x is the row index
+ * and y is the column index.
+ *******************************************************************/
+
+#ifndef LIFE_LOAD_H
+#define LIFE_LOAD_H
+
+#include <stddef.h>
+
+#include "rule.h"
+
+enum life_format {
+    LIFE_FORMAT_AUTO,       // Detect from the extension and the contents
+    LIFE_FORMAT_RLE,
+    LIFE_FORMAT_LIFE106,
+    LIFE_FORMAT_CELLS
+};
+
+/**
+ * @brief Makes length consecutive cells of one row alive.
+ *
+ * @param board The board passed to life_load_file().
+ * @param x The row index.
+ * @param y The column index of the first cell.
+ * @param length Number of cells (at least 1).
+ * @return int 0 on success, -1 to stop loading (e.g. out of memory).
+ */
+typedef int (*life_load_run)(void *board, long long x, long long y, long long length);
+
+/**
+ * @brief What a loaded file contained.
+ */
+struct life_load_info {
+    enum life_format format;    // Format that was parsed
+    long long cells;            // Live cells loaded
+    long long width;            // Pattern size from the RLE header, else 0
+    long long height;
+    long error_line;            // Line of the first syntax error, else 0
+    int has_rule;               // Set if the RLE header named a rule
+    struct life_ruleset rule;   // That rule
+};
+
+/**
+ * @brief Loads a pattern file onto a board.
+ *
+ * @param path The file to read.
+ * @param format Format of the file, or LIFE_FORMAT_AUTO.
+ * @param x Row where the pattern's top-left corner is placed.
+ * @param y Column where the pattern's top-left corner is placed.
+ * @param run Receives the live cells.
+ * @param board Passed to run.
+ * @param info Filled in with details of the file (may be NULL).
+ * @return int 0 on success, -1 if the file cannot be read, is not
+ *             valid, or run failed.
+ */
+int life_load_file(const char *path, enum life_format format, long long x, long long y,
+                   life_load_run run, void *board, struct life_load_info *info);
+
+/**
+ * @brief Loads a pattern that is already in memory.
+ *
+ * Same as life_load_file() for size bytes at data; LIFE_FORMAT_AUTO
+ * detects the format from the contents only.
+ */
+int life_load_buffer(const char *data, size_t size, enum life_format format, long long x, long long y,
+                     life_load_run run, void *board, struct life_load_info *info);
+
+#endif // LIFE_LOAD_H
@@ -0,0 +1,55 @@
+/*******************************************************************
+ * Conway's Game of Life - Block Lookup Table
+ *
+ * Author: hrosicka
+ * Description:
+ *   Builds the tables declared in lut.h.
+ *******************************************************************/
+
+#include <pthread.h>
+
+#include "lut.h"
+
+static uint8_t table[LIFE_LUT_SIZE];
+static pthread_once_t table_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Returns cell (r, c) of a 4 x 4 block.
+ */
+static int block_cell(unsigned block, int r, int c) {
+    return (block >> (4 * r + c)) & 1;
+}
+
+void life_lut_build(uint8_t *out, const struct life_ruleset *rule) {
+    for (unsigned block = 0; block < LIFE_LUT_SIZE; block++) {
+        unsigned next = 0;
+        for (int bit = 0; bit < 4; bit++) {
+            int r = 1 + bit / 2, c = 1 + bit % 2;
+            int neighbors = 0;
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    if (dr != 0 || dc != 0) {
+                        neighbors += block_cell(block, r + dr, c + dc);
+                    }
+                }
+            }
+            if (life_rule_next(rule, block_cell(block, r, c), neighbors)) {
+                next |= 1u << bit;
+            }
+        }
+        out[block] = (uint8_t)next;
+    }
+}
+
+/**
+ * @brief Builds the shared B3/S23 table.
+ */
+static void build_table(void) {
+    const struct life_ruleset conway = LIFE_RULE_CONWAY;
+    life_lut_build(table, &conway);
+}
+
+const uint8_t *life_lut_table(void) {
+    pthread_once(&table_once, build_table);
+    return table;
+}
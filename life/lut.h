@@ -0,0 +1,87 @@
+/*******************************************************************
+ * Conway's Game of Life - Block Lookup Table
+ *
+ * Author: hrosicka
+ * Description:
+ *   A table of all 65,536 blocks of 4 x 4 cells, giving for each the
+ *   next generation of its 2 x 2 center. The center cells have all
+ *   eight neighbors inside the block, so one lookup advances four
+ *   cells without counting anything. The table takes 64 KB. The
+ *   B3/S23 table is shared and built once, on first use; a board with
+ *   another rule builds its own with life_lut_build().
+ *
+ * Block Index:
+ *   Bits 4r to 4r + 3 hold row r of the block (r = 0..3), bit c of a
+ *   row holds column c. Bit 0 of an entry is center cell (1, 1),
+ *   bit 1 is (1, 2), bit 2 is (2, 1) and bit 3 is (2, 2).
+ *******************************************************************/
+
+#ifndef LIFE_LUT_H
+#define LIFE_LUT_H
+
+#include <stdint.h>
+
+#include "rule.h"
+
+#define LIFE_LUT_SIZE (1 << 16)   // Entries (and bytes) of a block table
+
+/**
+ * @brief Returns the B3/S23 block table, building it on the first call.
+ *
+ * Safe to call from several threads.
+ */
+const uint8_t *life_lut_table(void);
+
+/**
+ * @brief Fills a block table for any rule.
+ *
+ * @param table LIFE_LUT_SIZE bytes.
+ * @param rule The rule.
+ */
+void life_lut_build(uint8_t *table, const struct life_ruleset *rule);
+
+/**
+ * @brief Computes one 64-column word of two rows with the block table.
+ *
+ * For each k, row k of the block window is described by three words:
+ * west[k] holds, at bit b, the cell in column b - 1 of the word (so
+ * bit 0 is the neighbor across the west edge), self[k] the row word
+ * itself, and east_bit[k] (0 or 1) the cell just past column 63.
+ * Rows 1 and 2 are the rows computed; rows 0 and 3 are their outer
+ * neighbors.
+ *
+ * @param table The table from life_lut_table() or life_lut_build().
+ * @param top Set to the next generation of row 1.
+ * @param bottom Set to the next generation of row 2.
+ */
+static inline void life_lut_step_word(const uint8_t *table, const uint64_t west[4], const uint64_t self[4],
+                                      const uint64_t east_bit[4], uint64_t *top, uint64_t *bottom) {
+    uint64_t upper = 0, lower = 0;
+
+    // Pairs 0..30: columns 2j - 1 .. 2j + 2 are bits 2j .. 2j + 3 of west
+    for (int j = 0; j < 31; j++) {
+        int shift = 2 * j;
+        unsigned index = (unsigned)((west[0] >> shift) & 15) |
+                         (unsigned)((west[1] >> shift) & 15) << 4 |
+                         (unsigned)((west[2] >> shift) & 15) << 8 |
+                         (unsigned)((west[3] >> shift) & 15) << 12;
+        unsigned next = table[index];
+        upper |= (uint64_t)(next & 3) << shift;
+        lower |= (uint64_t)(next >> 2) << shift;
+    }
+
+    // Pair 31 reaches one column past the word
+    unsigned index = 0;
+    for (int k = 0; k < 4; k++) {
+        unsigned row = (unsigned)(west[k] >> 62) | (unsigned)(self[k] >> 63) << 2 | (unsigned)east_bit[k] << 3;
+        index |= row << (4 * k);
+    }
+    unsigned next = table[index];
+    upper |= (uint64_t)(next & 3) << 62;
+    lower |= (uint64_t)(next >> 2) << 62;
+
+    *top = upper;
+    *bottom = lower;
+}
+
+#endif // LIFE_LUT_H
@@ -0,0 +1,393 @@
+/*******************************************************************
+ * Conway's Game of Life - Out-of-Core Board
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the memory-mapped board declared in mapped.h.
+ *******************************************************************/
+
+#define _GNU_SOURCE // For sync_file_range on Linux
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped.h"
+
+#define MAGIC "LIFEMMAP"
+
+/**
+ * @brief The 64-byte file header.
+ */
+struct mapped_header {
+    char magic[8];          // MAGIC, not terminated
+    int32_t width;
+    int32_t height;
+    uint32_t edges;         // enum life_edges
+    uint16_t birth;         // Bit n set: a dead cell with n neighbors is born
+    uint16_t survival;      // Bit n set: a live cell with n neighbors survives
+    int64_t generation;
+    uint8_t reserved[32];   // Zero
+};
+
+_Static_assert(sizeof(struct mapped_header) == 64, "mapped header must be 64 bytes");
+
+/**
+ * @brief Returns the size of a board file.
+ */
+static size_t file_size(int width, int height) {
+    return LIFE_MAPPED_ALIGN + (size_t)height * (size_t)((width + 63) / 64) * sizeof(uint64_t);
+}
+
+/**
+ * @brief Maps an open board file and fills in the board.
+ *
+ * @return struct life_mapped* The board, or NULL (the file is then closed).
+ */
+static struct life_mapped *map_file(int fd, const struct mapped_header *header) {
+    struct life_mapped *board = calloc(1, sizeof(*board));
+    if (board == NULL) {
+        close(fd);
+        return NULL;
+    }
+    board->width = header->width;
+    board->height = header->height;
+    board->words = (header->width + 63) / 64;
+    board->edges = (enum life_edges)header->edges;
+    board->generation = header->generation;
+    board->kernel = LIFE_KERNEL_PACKED;
+    board->rule = (struct life_ruleset){ header->birth, header->survival };
+    board->fd = fd;
+    board->map_size = file_size(board->width, board->height);
+    board->map = mmap(NULL, board->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (board->map == MAP_FAILED) {
+        close(fd);
+        free(board);
+        return NULL;
+    }
+    board->rows = (uint64_t *)((char *)board->map + LIFE_MAPPED_ALIGN);
+    madvise(board->map, board->map_size, MADV_SEQUENTIAL);
+
+    // Both generations of the window fit the budget; a band is at least a pass deep
+    size_t row_bytes = (size_t)board->words * sizeof(uint64_t);
+    long long band_rows = (long long)(LIFE_MAPPED_WINDOW_BYTES / (2 * row_bytes)) - 2 * LIFE_MAPPED_PASS;
+    if (band_rows < LIFE_MAPPED_PASS) {
+        band_rows = LIFE_MAPPED_PASS;
+    }
+    board->band_rows = band_rows < board->height ? (int)band_rows : board->height;
+    return board;
+}
+
+/**
+ * @brief Writes the size, rule and generation into the mapped header.
+ */
+static void store_header(struct life_mapped *board) {
+    struct mapped_header header = {
+        .width = board->width,
+        .height = board->height,
+        .edges = (uint32_t)board->edges,
+        .birth = (uint16_t)board->rule.birth,
+        .survival = (uint16_t)board->rule.survival,
+        .generation = board->generation,
+    };
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    memcpy(board->map, &header, sizeof(header));
+}
+
+struct life_mapped *life_mapped_create(const char *path, int width, int height, enum life_edges edges) {
+    if (width <= 0 || height <= 0) {
+        return NULL;
+    }
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+    // A file extended with ftruncate() reads as zeros and takes no disk space
+    if (ftruncate(fd, (off_t)file_size(width, height)) != 0) {
+        close(fd);
+        unlink(path);
+        return NULL;
+    }
+    struct mapped_header header = { .width = width, .height = height, .edges = (uint32_t)edges };
+    struct life_mapped *board = map_file(fd, &header);
+    if (board == NULL) {
+        unlink(path);
+        return NULL;
+    }
+    board->rule = (struct life_ruleset)LIFE_RULE_CONWAY;
+    store_header(board);
+    return board;
+}
+
+struct life_mapped *life_mapped_open(const char *path) {
+    int fd = open(path, O_RDWR);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct mapped_header header;
+    struct stat info;
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || fstat(fd, &info) != 0 ||
+        memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0 || header.width <= 0 || header.height <= 0 ||
+        header.edges > LIFE_EDGES_CLIP || (header.birth & 1) != 0 ||
+        (size_t)info.st_size < file_size(header.width, header.height)) {
+        close(fd);
+        return NULL;
+    }
+    return map_file(fd, &header);
+}
+
+int life_mapped_close(struct life_mapped *board) {
+    if (board == NULL) {
+        return 0;
+    }
+    store_header(board);
+    int status = msync(board->map, board->map_size, MS_SYNC) == 0 ? 0 : -1;
+    munmap(board->map, board->map_size);
+    if (close(board->fd) != 0) {
+        status = -1;
+    }
+    life_grid_free(board->window);
+    free(board->kept);
+    free(board);
+    return status;
+}
+
+void life_mapped_set_run(struct life_mapped *board, long long x, long long y, long long length) {
+    long long end = y + length;
+    if (x < 0 || x >= board->height || end <= 0 || y >= board->width || length <= 0) {
+        return;
+    }
+    if (y < 0) {
+        y = 0;
+    }
+    if (end > board->width) {
+        end = board->width;
+    }
+    uint64_t *row = board->rows + (size_t)x * board->words;
+    int first = (int)(y / 64), last = (int)((end - 1) / 64);
+    uint64_t head = ~0ULL << (y % 64);
+    uint64_t tail = ~0ULL >> (63 - (end - 1) % 64);
+    if (first == last) {
+        row[first] |= head & tail;
+    } else {
+        row[first] |= head;
+        for (int w = first + 1; w < last; w++) {
+            row[w] = ~0ULL;
+        }
+        row[last] |= tail;
+    }
+}
+
+/**
+ * @brief Finds the pages that hold rows [first, last) of the board.
+ *
+ * @return int 1 if there are any, 0 if the range is empty.
+ */
+static int page_range(const struct life_mapped *board, long long first, long long last,
+                      void **begin, size_t *length) {
+    first = first < 0 ? 0 : first;
+    last = last > board->height ? board->height : last;
+    if (first >= last) {
+        return 0;
+    }
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)(board->rows + (size_t)first * board->words) & ~(page - 1);
+    uintptr_t end = (uintptr_t)(board->rows + (size_t)last * board->words);
+    *begin = (void *)start;
+    *length = end - start;
+    return 1;
+}
+
+/**
+ * @brief Gives the kernel a hint about rows [first, last) of the board.
+ */
+static void advise(const struct life_mapped *board, long long first, long long last, int advice) {
+    void *begin;
+    size_t length;
+    if (page_range(board, first, last, &begin, &length)) {
+        madvise(begin, length, advice);
+    }
+}
+
+/**
+ * @brief Starts writing back rows [first, last) and drops them from the
+ * process; they are not needed again in this pass.
+ */
+static void release_rows(const struct life_mapped *board, int first, int last) {
+    void *begin;
+    size_t length;
+    if (!page_range(board, first, last, &begin, &length)) {
+        return;
+    }
+#ifdef __linux__
+    sync_file_range(board->fd, (off_t)((char *)begin - (char *)board->map), (off_t)length, SYNC_FILE_RANGE_WRITE);
+#else
+    msync(begin, length, MS_ASYNC);
+#endif
+    madvise(begin, length, MADV_DONTNEED);
+}
+
+/**
+ * @brief Makes the window a board of the given number of rows, with the
+ * board's kernel, rule and threads.
+ *
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int prepare_window(struct life_mapped *board, int rows) {
+    if (board->window == NULL || board->window->height != rows) {
+        life_grid_free(board->window);
+        board->window = life_grid_create(board->width, rows, board->edges);
+        if (board->window == NULL) {
+            return -1;
+        }
+    }
+    board->window->kernel = board->kernel;
+    board->window->rule = board->rule;
+    board->window->pool = board->pool;
+    // Its rows are about to be replaced from outside
+    board->window->all_active = 1;
+    return 0;
+}
+
+/**
+ * @brief Writes rows of the window back to rows [first, last) of the
+ * board, skipping rows that did not change.
+ *
+ * @param offset Window row that holds board row first.
+ */
+static void write_back(struct life_mapped *board, int first, int last, int offset) {
+    size_t row_bytes = (size_t)board->words * sizeof(uint64_t);
+    for (int x = first; x < last; x++) {
+        const uint64_t *row = board->window->cells + (size_t)(x - first + offset) * board->words;
+        uint64_t *out = board->rows + (size_t)x * board->words;
+        if (memcmp(out, row, row_bytes) != 0) {
+            memcpy(out, row, row_bytes);
+        }
+    }
+}
+
+/**
+ * @brief Advances a board that fits one window by k generations.
+ */
+static int step_whole(struct life_mapped *board, int k) {
+    if (prepare_window(board, board->height) != 0) {
+        return -1;
+    }
+    memcpy(board->window->cells, board->rows, (size_t)board->height * board->words * sizeof(uint64_t));
+    if (life_grid_step_n(board->window, k) != 0) {
+        return -1;
+    }
+    write_back(board, 0, board->height, 0);
+    return 0;
+}
+
+/**
+ * @brief Advances the board k generations, one band of rows at a time
+ * (see mapped.h).
+ *
+ * Band b holds rows [b * band_rows, (b + 1) * band_rows); its window
+ * reaches k rows further on each side, wrapping around a torus and
+ * stopping at the edges of a clipped board.
+ */
+static int step_bands(struct life_mapped *board, int k) {
+    const int words = board->words, height = board->height;
+    const size_t row_bytes = (size_t)words * sizeof(uint64_t);
+    const int wrap = board->edges == LIFE_EDGES_WRAP;
+    uint64_t *skirt = board->kept;                                  // Old rows above the band
+    uint64_t *first_rows = board->kept + (size_t)LIFE_MAPPED_PASS * words;  // Old rows 0 to k - 1
+    if (wrap) {
+        memcpy(first_rows, board->rows, (size_t)k * row_bytes);
+    }
+
+    int bands = (height + board->band_rows - 1) / board->band_rows;
+    for (int band = 0; band < bands; band++) {
+        int first = band * board->band_rows;
+        int last = first + board->band_rows < height ? first + board->band_rows : height;
+        long long start = first - k, end = last + k;
+        if (!wrap) {
+            start = start < 0 ? 0 : start;
+            end = end > height ? height : end;
+        }
+        advise(board, last, last + board->band_rows + k, MADV_WILLNEED);
+
+        if (prepare_window(board, (int)(end - start)) != 0) {
+            return -1;
+        }
+        uint64_t live = 0;
+        for (long long x = start; x < end; x++) {
+            const uint64_t *row;
+            if (band > 0 && x < first) {
+                row = skirt + (size_t)(x - (first - k)) * words;
+            } else if (x >= height) {
+                row = first_rows + (size_t)(x - height) * words;
+            } else if (x < 0) {
+                row = board->rows + (size_t)(x + height) * words;
+            } else {
+                row = board->rows + (size_t)x * words;
+            }
+            uint64_t *out = board->window->cells + (size_t)(x - start) * words;
+            memcpy(out, row, row_bytes);
+            for (int w = 0; w < words; w++) {
+                live |= out[w];
+            }
+        }
+        if (band + 1 < bands) {
+            // The next band's upper skirt, before this band overwrites it
+            memcpy(skirt, board->rows + (size_t)(last - k) * words, (size_t)k * row_bytes);
+        }
+        if (live == 0) {
+            // Dead cells with dead neighbors stay dead (rules with B0 are not allowed)
+            continue;
+        }
+
+        if (life_grid_step_n(board->window, k) != 0) {
+            return -1;
+        }
+        write_back(board, first, last, (int)(first - start));
+        release_rows(board, first, last);
+    }
+    return 0;
+}
+
+int life_mapped_step_n(struct life_mapped *board, long long n) {
+    if (board->kept == NULL) {
+        board->kept = malloc(2 * (size_t)LIFE_MAPPED_PASS * board->words * sizeof(uint64_t));
+        if (board->kept == NULL) {
+            return -1;
+        }
+    }
+    for (long long done = 0; done < n;) {
+        int k = n - done < LIFE_MAPPED_PASS ? (int)(n - done) : LIFE_MAPPED_PASS;
+        int status = board->height <= board->band_rows + 2 * k ? step_whole(board, k) : step_bands(board, k);
+        if (status != 0) {
+            return -1;
+        }
+        done += k;
+        board->generation += k;
+    }
+    store_header(board);
+    return 0;
+}
+
+long long life_mapped_population(const struct life_mapped *board) {
+    size_t count = (size_t)board->height * board->words;
+    long long total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += __builtin_popcountll(board->rows[i]);
+    }
+    return total;
+}
+
+void life_mapped_read_rows(const struct life_mapped *board, int x, int rows, int words, uint64_t *out) {
+    for (int r = 0; r < rows; r++) {
+        uint64_t *row = out + (size_t)r * words;
+        if (x + r < board->height) {
+            memcpy(row, board->rows + (size_t)(x + r) * board->words, (size_t)words * sizeof(uint64_t));
+        } else {
+            memset(row, 0, (size_t)words * sizeof(uint64_t));
+        }
+    }
+}
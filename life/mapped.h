@@ -0,0 +1,137 @@
+/*******************************************************************
+ * Conway's Game of Life - Out-of-Core Board
+ *
+ * Author: hrosicka
+ * Description:
+ *   Keeps a bit-packed board in a memory-mapped file, so the board may
+ *   be larger than RAM: a 10^6 x 10^6 board takes 125 GB. Only a
+ *   window of a few row bands is ever touched at a time, and the
+ *   file is read and written strictly front to back.
+ *
+ * How It Works:
+ *   - The board is advanced in passes of up to LIFE_MAPPED_PASS
+ *     generations. A pass walks the board in bands of rows. Each band
+ *     is copied into a life_grid window together with k rows above
+ *     and below it, stepped k generations with the usual kernels and
+ *     threads, and written back in place. After k generations the
+ *     rows within k of the window edges are wrong, but the band itself
+ *     is exact, so every byte of the file is read and written once per
+ *     k generations.
+ *   - The new band overwrites rows the next band still needs as its
+ *     upper skirt. Those k rows are kept in memory before the band is
+ *     written back, and on a torus the first k rows of the board are
+ *     kept at the start of the pass for the last band.
+ *   - The mapping is marked for sequential access, the next band is
+ *     requested ahead of time, and each band that has been written
+ *     back is handed to the kernel for write-back and dropped from
+ *     the process, so page faults stay sequential and memory use stays
+ *     at the window.
+ *   - Rows that did not change are not written, and bands that are
+ *     empty with their skirts are skipped, so empty regions are never
+ *     dirtied and stay holes in a sparse file.
+ *
+ * File Layout (integers in the writer's byte order):
+ *   - A 64-byte header: the magic "LIFEMMAP", the board size and edge
+ *     mode, the rule and the generation counter, padded to
+ *     LIFE_MAPPED_ALIGN bytes.
+ *   - The rows in life_grid layout, (width + 63) / 64 words each.
+ *
+ * Coordinates follow the rest of the repository: x is the row index
+ * and y is the column index.
+ *******************************************************************/
+
+#ifndef LIFE_MAPPED_H
+#define LIFE_MAPPED_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "grid.h"
+
+#define LIFE_MAPPED_PASS 16             // Most generations per pass over the file
+#define LIFE_MAPPED_WINDOW_BYTES (64 << 20)  // Memory budget of the band window
+#define LIFE_MAPPED_ALIGN 4096          // Offset of the first row in the file
+
+/**
+ * @brief A board kept in a memory-mapped file.
+ *
+ * kernel, rule and pool may be changed between calls to
+ * life_mapped_step_n(). The rule and generation are stored in the
+ * file after each call.
+ */
+struct life_mapped {
+    int width;                  // Number of columns
+    int height;                 // Number of rows
+    int words;                  // 64-bit words per row
+    enum life_edges edges;      // How the board edges behave
+    long long generation;       // Generations computed since the file was created
+    enum life_kernel kernel;    // Step kernel of the window
+    struct life_ruleset rule;   // The rule
+    struct life_pool *pool;     // Worker threads, or NULL (not owned)
+    int fd;                     // The open file
+    void *map;                  // The whole file
+    size_t map_size;
+    uint64_t *rows;             // First row, LIFE_MAPPED_ALIGN bytes into the file
+    int band_rows;              // Rows advanced per window
+    struct life_grid *window;   // A band and its skirts, or NULL between passes
+    uint64_t *kept;             // Rows kept across bands: the upper skirt, then the first rows
+};
+
+/**
+ * @brief Creates a file holding an empty board.
+ *
+ * The file is created sparse, so empty rows take no disk space.
+ *
+ * @param path The file; it must not exist yet.
+ * @param width Number of columns.
+ * @param height Number of rows.
+ * @param edges Edge mode of the board.
+ * @return struct life_mapped* The board, or NULL if the file cannot be
+ *         created or mapped.
+ */
+struct life_mapped *life_mapped_create(const char *path, int width, int height, enum life_edges edges);
+
+/**
+ * @brief Opens a board created by life_mapped_create().
+ *
+ * @return struct life_mapped* The board, or NULL if the file cannot be
+ *         opened or does not hold a board.
+ */
+struct life_mapped *life_mapped_open(const char *path);
+
+/**
+ * @brief Stores the header, unmaps and closes the file.
+ *
+ * @return int 0 on success, -1 if the file could not be written.
+ */
+int life_mapped_close(struct life_mapped *board);
+
+/**
+ * @brief Makes a horizontal run of cells alive (see life_grid_set_run()).
+ */
+void life_mapped_set_run(struct life_mapped *board, long long x, long long y, long long length);
+
+/**
+ * @brief Advances the board n generations.
+ *
+ * @return int 0 on success, -1 if the window cannot be allocated.
+ */
+int life_mapped_step_n(struct life_mapped *board, long long n);
+
+/**
+ * @brief Returns the number of live cells; reads the whole file.
+ */
+long long life_mapped_population(const struct life_mapped *board);
+
+/**
+ * @brief Copies the first words of some rows into bit-packed rows.
+ *
+ * @param board The board.
+ * @param x First row to copy; rows past the board read as dead.
+ * @param rows Number of rows.
+ * @param words 64-bit words per output row, at most board->words.
+ * @param out Output, rows * words words.
+ */
+void life_mapped_read_rows(const struct life_mapped *board, int x, int rows, int words, uint64_t *out);
+
+#endif // LIFE_MAPPED_H
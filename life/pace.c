@@ -0,0 +1,98 @@
+/*******************************************************************
+ * Conway's Game of Life - Frame Pacing
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the pacer declared in pace.h.
+ *******************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "clock.h"
+#include "pace.h"
+
+/**
+ * @brief Sleeps until the monotonic clock reaches deadline.
+ */
+static void sleep_until(long long deadline) {
+#ifdef __APPLE__
+    // No clock_nanosleep(): sleep for the time left instead
+    for (long long left = deadline - life_clock_now(); left > 0; left = deadline - life_clock_now()) {
+        struct timespec ts = { (time_t)(left / LIFE_CLOCK_NS_PER_SECOND), (long)(left % LIFE_CLOCK_NS_PER_SECOND) };
+        nanosleep(&ts, NULL);
+    }
+#else
+    struct timespec ts = { (time_t)(deadline / LIFE_CLOCK_NS_PER_SECOND), (long)(deadline % LIFE_CLOCK_NS_PER_SECOND) };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        // Interrupted by a signal: the deadline is absolute, so sleep again
+    }
+#endif
+}
+
+void life_pacer_start(struct life_pacer *pacer, long long period) {
+    *pacer = (struct life_pacer){ 0 };
+    pacer->period = period;
+    pacer->deadline = life_clock_now() + period;
+    pacer->last_frame = pacer->deadline - period - LIFE_CLOCK_NS_PER_SECOND;
+}
+
+void life_pacer_set_period(struct life_pacer *pacer, long long period) {
+    // An unpaced schedule has no deadlines to keep
+    pacer->deadline = pacer->period == 0 ? life_clock_now() + period : pacer->deadline + period - pacer->period;
+    pacer->period = period;
+}
+
+int life_pacer_frame(struct life_pacer *pacer) {
+    long long now = life_clock_now();
+    long long since = now - pacer->last_frame;
+    if (since < LIFE_CLOCK_NS_PER_SECOND / LIFE_PACE_MAX_FPS) {
+        return 0;
+    }
+    if (pacer->behind && since < LIFE_CLOCK_NS_PER_SECOND / LIFE_PACE_BEHIND_FPS) {
+        pacer->skipped++;
+        return 0;
+    }
+    pacer->last_frame = now;
+    pacer->frames++;
+    return 1;
+}
+
+void life_pacer_wait(struct life_pacer *pacer) {
+    if (pacer->period == 0) {
+        return;
+    }
+    long long now = life_clock_now();
+    pacer->behind = now > pacer->deadline;
+    if (pacer->behind) {
+        pacer->late++;
+    } else {
+        sleep_until(pacer->deadline);
+        now = life_clock_now();
+    }
+
+    // Smoothed change of the lag from tick to tick, as RTP measures jitter
+    long long lag = now - pacer->deadline;
+    long long change = lag > pacer->last_lag ? lag - pacer->last_lag : pacer->last_lag - lag;
+    if (pacer->ticks > 0) {
+        pacer->jitter += ((double)change - pacer->jitter) / 16.0;
+    }
+    pacer->last_lag = lag;
+    pacer->ticks++;
+    if (lag > pacer->lag_max) {
+        pacer->lag_max = lag;
+    }
+
+    pacer->deadline += pacer->period;
+    if (now - pacer->deadline > LIFE_PACE_MAX_BEHIND) {
+        pacer->deadline = now + pacer->period;
+        pacer->restarts++;
+    }
+}
+
+void life_pacer_format(const struct life_pacer *pacer, char *text, size_t size) {
+    snprintf(text, size, "Late: %lld/%lld (max %.1f ms)  Jitter: %.2f ms  Skipped: %lld  Restarts: %lld",
+             pacer->late, pacer->ticks, (double)pacer->lag_max * 1e-6, pacer->jitter * 1e-6, pacer->skipped,
+             pacer->restarts);
+}
@@ -0,0 +1,91 @@
+/*******************************************************************
+ * Conway's Game of Life - Frame Pacing
+ *
+ * Author: hrosicka
+ * Description:
+ *   Keeps an interactive run at a steady rate. Instead of sleeping a
+ *   fixed delay after each frame, which adds the time spent stepping
+ *   and drawing to every period, the loop waits for ticks that lie on
+ *   a fixed grid of deadlines on the monotonic clock.
+ *
+ * How It Works:
+ *   - Tick i is due at start + i * period. life_pacer_wait() sleeps
+ *     until the next deadline with an absolute clock_nanosleep(), so
+ *     time lost in one period is made up in the next ones and the rate
+ *     never drifts.
+ *   - A tick whose deadline has already passed when the loop gets to
+ *     it is late and is not waited for, so the loop catches up. If it
+ *     falls more than LIFE_PACE_MAX_BEHIND nanoseconds behind (the
+ *     process was stopped, say), the schedule starts over from now.
+ *   - life_pacer_frame() says whether to draw: at most
+ *     LIFE_PACE_MAX_FPS frames per second, and while the loop is
+ *     behind schedule only LIFE_PACE_BEHIND_FPS, so slow drawing
+ *     does not slow down the generations. Frames left out while
+ *     behind are counted as skipped.
+ *   - Each tick records how long after its deadline it really started
+ *     (its lag). The jitter is the running average of the change in lag
+ *     from one tick to the next, smoothed over about 16 ticks as RTP
+ *     does (RFC 3550), and the largest lag shows the worst stall.
+ *******************************************************************/
+
+#ifndef LIFE_PACE_H
+#define LIFE_PACE_H
+
+#include <stddef.h>
+
+#define LIFE_PACE_MAX_FPS 60                    // Most frames drawn per second
+#define LIFE_PACE_BEHIND_FPS 10                 // Frames drawn per second while behind schedule
+#define LIFE_PACE_MAX_BEHIND 1000000000LL       // Nanoseconds behind before the schedule starts over
+
+/**
+ * @brief The schedule of a loop and its timing statistics.
+ */
+struct life_pacer {
+    long long period;       // Nanoseconds between ticks, 0 to run unpaced
+    long long deadline;     // Monotonic time of the next tick
+    long long last_frame;   // Monotonic time of the last frame drawn
+    int behind;             // The last tick was late
+    long long ticks;        // Ticks so far
+    long long late;         // Ticks that started after their deadline had passed
+    long long frames;       // Frames drawn
+    long long skipped;      // Frames left out while behind schedule
+    long long restarts;     // Times the schedule started over
+    long long last_lag;     // Nanoseconds the last tick started after its deadline
+    long long lag_max;      // Largest lag so far
+    double jitter;          // Smoothed change of the lag between ticks (ns)
+};
+
+/**
+ * @brief Starts a schedule whose first tick is one period from now.
+ *
+ * @param pacer The pacer.
+ * @param period Nanoseconds between ticks; 0 never waits.
+ */
+void life_pacer_start(struct life_pacer *pacer, long long period);
+
+/**
+ * @brief Changes the period from the next tick on.
+ */
+void life_pacer_set_period(struct life_pacer *pacer, long long period);
+
+/**
+ * @brief Says whether the loop should draw a frame now.
+ *
+ * @return int 1 if the frame should be drawn, 0 to leave it out.
+ */
+int life_pacer_frame(struct life_pacer *pacer);
+
+/**
+ * @brief Sleeps until the next tick is due and advances the schedule.
+ *
+ * Returns at once if the tick is already due.
+ */
+void life_pacer_wait(struct life_pacer *pacer);
+
+/**
+ * @brief Formats the timing statistics, e.g. "Late: 2/500 (max 3.1 ms)
+ * Jitter: 0.06 ms  Skipped: 0  Restarts: 0".
+ */
+void life_pacer_format(const struct life_pacer *pacer, char *text, size_t size);
+
+#endif // LIFE_PACE_H
@@ -0,0 +1,145 @@
+/*******************************************************************
+ * Conway's Game of Life - Persistent Worker Pool
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the worker pool declared in pool.h.
+ *
+ *   Workers sleep on a condition variable until the round counter
+ *   moves, run the posted task, and count themselves out. The thread
+ *   that posted the task runs its own share and then waits until the
+ *   count drops to zero.
+ *******************************************************************/
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "pool.h"
+
+struct worker {
+    struct life_pool *pool;
+    int index;
+    pthread_t thread;
+};
+
+struct life_pool {
+    int threads;              // Threads per run, including the caller
+    struct worker *workers;   // threads - 1 background workers
+    pthread_mutex_t lock;
+    pthread_cond_t start;     // Signaled when a new round is posted
+    pthread_cond_t done;      // Signaled when the last worker finishes
+    life_pool_task task;      // Task of the current round
+    void *arg;
+    unsigned long round;      // Number of rounds posted so far
+    int pending;              // Workers still busy in this round
+    int stop;                 // Set when the pool is shutting down
+};
+
+static void *worker_main(void *data) {
+    struct worker *self = data;
+    struct life_pool *pool = self->pool;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (pool->round == seen && !pool->stop) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stop) {
+            break;
+        }
+        seen = pool->round;
+        life_pool_task task = pool->task;
+        void *arg = pool->arg;
+        pthread_mutex_unlock(&pool->lock);
+
+        task(arg, self->index, pool->threads);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+struct life_pool *life_pool_create(int threads) {
+    struct life_pool *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool->threads = threads < 1 ? 1 : threads;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    if (pool->threads > 1) {
+        pool->workers = calloc((size_t)pool->threads - 1, sizeof(struct worker));
+        if (pool->workers == NULL) {
+            life_pool_free(pool);
+            return NULL;
+        }
+        for (int i = 0; i < pool->threads - 1; i++) {
+            pool->workers[i].pool = pool;
+            pool->workers[i].index = i + 1;
+            if (pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]) != 0) {
+                // Run with the workers that did start
+                pool->threads = i + 1;
+                break;
+            }
+        }
+    }
+    return pool;
+}
+
+void life_pool_free(struct life_pool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    if (pool->workers != NULL) {
+        for (int i = 0; i < pool->threads - 1; i++) {
+            pthread_join(pool->workers[i].thread, NULL);
+        }
+        free(pool->workers);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+int life_pool_threads(const struct life_pool *pool) {
+    return pool->threads;
+}
+
+void life_pool_run(struct life_pool *pool, life_pool_task task, void *arg) {
+    if (pool->threads == 1) {
+        task(arg, 0, 1);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->arg = arg;
+    pool->pending = pool->threads - 1;
+    pool->round++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    task(arg, 0, pool->threads);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
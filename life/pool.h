@@ -0,0 +1,58 @@
+/*******************************************************************
+ * Conway's Game of Life - Persistent Worker Pool
+ *
+ * Author: hrosicka
+ * Description:
+ *   A fixed set of POSIX threads that is created once and then reused
+ *   for every generation. Each call to life_pool_run() hands the same
+ *   task to all threads and returns only when every thread is done,
+ *   so it doubles as the per-generation barrier.
+ *******************************************************************/
+
+#ifndef LIFE_POOL_H
+#define LIFE_POOL_H
+
+/**
+ * @brief Work function run by every thread of the pool.
+ *
+ * @param arg The argument given to life_pool_run().
+ * @param index Index of the calling thread, 0 to count - 1.
+ * @param count Total number of threads taking part.
+ */
+typedef void (*life_pool_task)(void *arg, int index, int count);
+
+struct life_pool;
+
+/**
+ * @brief Starts a pool of worker threads.
+ *
+ * The calling thread takes part in every run as thread 0, so only
+ * threads - 1 extra threads are started.
+ *
+ * @param threads Number of threads to use (values below 1 mean 1).
+ * @return struct life_pool* The pool, or NULL on failure.
+ */
+struct life_pool *life_pool_create(int threads);
+
+/**
+ * @brief Stops the worker threads and frees the pool.
+ *
+ * @param pool The pool to free (may be NULL).
+ */
+void life_pool_free(struct life_pool *pool);
+
+/**
+ * @brief Returns the number of threads taking part in each run.
+ */
+int life_pool_threads(const struct life_pool *pool);
+
+/**
+ * @brief Runs a task on every thread and waits for all of them.
+ *
+ * @param pool The pool.
+ * @param task Work function; called once per thread.
+ * @param arg Argument passed to every call of task.
+ */
+void life_pool_run(struct life_pool *pool, life_pool_task task, void *arg);
+
+#endif // LIFE_POOL_H
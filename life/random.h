@@ -0,0 +1,69 @@
+/*******************************************************************
+ * Conway's Game of Life - Random Numbers
+ *
+ * Author: hrosicka
+ * Description:
+ *   The seeded generators behind every random board: the --census and
+ *   --ensemble soups and the --conform boards. A run is reproduced by
+ *   its seed alone, on any platform and with any number of threads.
+ *
+ * How It Works:
+ *   - life_splitmix64() steps a 64-bit counter by a fixed odd constant
+ *     and scrambles it. It is good enough on its own for a few numbers
+ *     per seed, and turns one seed into the state of the generator.
+ *   - life_xoshiro_next() is xoshiro256** (Blackman and Vigna): 256
+ *     bits of state, a few shifts and rotations per number.
+ *******************************************************************/
+
+#ifndef LIFE_RANDOM_H
+#define LIFE_RANDOM_H
+
+#include <stdint.h>
+
+/**
+ * @brief xoshiro256** generator.
+ */
+struct life_xoshiro {
+    uint64_t s[4];
+};
+
+/**
+ * @brief Returns the next number of a splitmix64 sequence.
+ */
+static inline uint64_t life_splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t life_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * @brief Fills the state of a generator from a splitmix64 sequence.
+ */
+static inline void life_xoshiro_seed(struct life_xoshiro *rng, uint64_t seed) {
+    for (int k = 0; k < 4; k++) {
+        rng->s[k] = life_splitmix64(&seed);
+    }
+}
+
+/**
+ * @brief Returns the next number of the generator.
+ */
+static inline uint64_t life_xoshiro_next(struct life_xoshiro *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = life_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = life_rotl(s[3], 45);
+    return result;
+}
+
+#endif // LIFE_RANDOM_H
@@ -0,0 +1,548 @@
+/*******************************************************************
+ * Conway's Game of Life - Frame Recorder
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the recorder declared in record.h.
+ *
+ *   The ring holds the frames from head to head + queued. The frame at
+ *   head stays counted while the encoder works on it, so the stepping
+ *   loop always fills the slot just past the queue, which the encoder
+ *   never touches.
+ *******************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "record.h"
+
+#define MAGIC "LIFEFRMS"
+#define STREAM_VERSION 1
+#define WRITE_BUFFER (1 << 20)      // stdio buffer of the output file
+#define GIF_MAX_SIZE 65535          // Largest GIF width or height
+#define GIF_MIN_CODE_SIZE 2         // LZW root codes 0-3, of which 0 and 1 are used
+#define GIF_MAX_CODES 4096          // LZW codes are at most 12 bits
+
+enum record_format {
+    RECORD_STREAM,  // Delta frame stream
+    RECORD_GIF      // Animated GIF
+};
+
+/**
+ * @brief The 32-byte header of a delta frame stream.
+ */
+struct stream_header {
+    char magic[8];          // MAGIC, not terminated
+    uint32_t version;       // STREAM_VERSION
+    int32_t width;          // Frame size in pixels
+    int32_t height;
+    int32_t scale;          // Board cells per pixel
+    uint8_t reserved[8];    // Zero
+};
+
+_Static_assert(sizeof(struct stream_header) == 32, "frame stream header must be 32 bytes");
+
+struct frame {
+    long long generation;
+    uint64_t *rows;         // height rows of words words
+};
+
+struct life_recorder {
+    enum record_format format;
+    FILE *file;
+    int scale;
+    long long every;
+    int width;              // Frame size in pixels
+    int height;
+    int words;              // 64-bit words per frame row
+    size_t frame_words;     // height * words
+    uint64_t *merged;       // Board rows ORed together while shrinking (stepping loop only)
+
+    pthread_mutex_t lock;
+    pthread_cond_t ready;   // Signaled when a frame is queued or the recorder stops
+    struct frame slots[LIFE_RECORD_SLOTS];
+    int head;               // Oldest queued frame
+    int queued;             // Frames queued, including the one being encoded
+    int stop;               // Set by life_recorder_close()
+    long long dropped;
+    pthread_t thread;
+
+    // Encoder thread only
+    uint64_t *shown;        // Last frame written
+    uint64_t *delta;        // Scratch: XOR of two frames
+    long long written;      // Frames written
+    struct frame held;      // GIF: frame waiting for the next one to know its delay
+    int holding;
+    uint16_t (*codes)[2];   // GIF: LZW code table, codes[prefix][pixel]
+    int failed;
+};
+
+/**
+ * @brief Returns 1 if any bit in columns [from, to) of a row is set.
+ */
+static int any_bits(const uint64_t *row, int from, int to) {
+    int first = from / 64, last = (to - 1) / 64;
+    for (int w = first; w <= last; w++) {
+        uint64_t mask = ~0ULL;
+        if (w == first) {
+            mask &= ~0ULL << (from % 64);
+        }
+        if (w == last) {
+            mask &= ~0ULL >> (63 - (to - 1) % 64);
+        }
+        if (row[w] & mask) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Copies the board into a frame, one pixel per scale x scale block.
+ */
+static void capture(struct life_recorder *recorder, const struct life_grid *grid, uint64_t *out) {
+    int scale = recorder->scale;
+    if (scale == 1) {
+        memcpy(out, grid->cells, recorder->frame_words * sizeof(uint64_t));
+        return;
+    }
+
+    memset(out, 0, recorder->frame_words * sizeof(uint64_t));
+    for (int px = 0; px < recorder->height; px++) {
+        int first = px * scale;
+        int last = first + scale < grid->height ? first + scale : grid->height;
+        uint64_t *merged = recorder->merged;
+        memcpy(merged, grid->cells + (size_t)first * grid->words, (size_t)grid->words * sizeof(uint64_t));
+        for (int x = first + 1; x < last; x++) {
+            const uint64_t *row = grid->cells + (size_t)x * grid->words;
+            for (int w = 0; w < grid->words; w++) {
+                merged[w] |= row[w];
+            }
+        }
+
+        uint64_t *pixels = out + (size_t)px * recorder->words;
+        for (int py = 0; py < recorder->width; py++) {
+            int from = py * scale;
+            int to = from + scale < grid->width ? from + scale : grid->width;
+            if (any_bits(merged, from, to)) {
+                pixels[py / 64] |= 1ULL << (py % 64);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Streams words as zero/literal records, as checkpoints do.
+ *
+ * @return int 0 on success, -1 on a write error.
+ */
+static int write_records(FILE *file, const uint64_t *words, uint64_t total) {
+    uint64_t i = 0;
+    while (i < total) {
+        uint64_t zeros = 0;
+        while (i + zeros < total && words[i + zeros] == 0) {
+            zeros++;
+        }
+        uint64_t start = i + zeros, end = start;
+        while (end < total && (words[end] != 0 || (end + 1 < total && words[end + 1] != 0))) {
+            end++;
+        }
+        uint64_t counts[2] = { zeros, end - start };
+        if (fwrite(counts, sizeof(counts), 1, file) != 1 ||
+            fwrite(words + start, sizeof(uint64_t), counts[1], file) != counts[1]) {
+            return -1;
+        }
+        i = end;
+    }
+    return 0;
+}
+
+/**
+ * @brief Appends one frame to a delta frame stream.
+ */
+static int write_stream_frame(struct life_recorder *recorder, const struct frame *frame) {
+    for (size_t w = 0; w < recorder->frame_words; w++) {
+        recorder->delta[w] = frame->rows[w] ^ recorder->shown[w];
+    }
+    int64_t generation = frame->generation;
+    if (fwrite(&generation, sizeof(generation), 1, recorder->file) != 1) {
+        return -1;
+    }
+    return write_records(recorder->file, recorder->delta, recorder->frame_words);
+}
+
+static void put_u16(unsigned char *out, int value) {
+    out[0] = (unsigned char)(value & 0xff);
+    out[1] = (unsigned char)((value >> 8) & 0xff);
+}
+
+/**
+ * @brief Packs LZW codes least significant bit first into GIF data sub-blocks.
+ */
+struct gif_bits {
+    FILE *file;
+    uint32_t bits;              // Pending bits, the oldest in bit 0
+    int count;                  // Number of pending bits
+    unsigned char block[256];   // Length byte, then up to 255 data bytes
+    int failed;
+};
+
+static void flush_block(struct gif_bits *out) {
+    if (out->block[0] > 0 && fwrite(out->block, 1, (size_t)out->block[0] + 1, out->file) != (size_t)out->block[0] + 1) {
+        out->failed = 1;
+    }
+    out->block[0] = 0;
+}
+
+static void put_code(struct gif_bits *out, int code, int size) {
+    out->bits |= (uint32_t)code << out->count;
+    out->count += size;
+    while (out->count >= 8) {
+        out->block[++out->block[0]] = (unsigned char)(out->bits & 0xff);
+        out->bits >>= 8;
+        out->count -= 8;
+        if (out->block[0] == 255) {
+            flush_block(out);
+        }
+    }
+}
+
+static inline int frame_pixel(const struct life_recorder *recorder, const uint64_t *rows, int x, int y) {
+    return (int)((rows[(size_t)x * recorder->words + y / 64] >> (y % 64)) & 1);
+}
+
+/**
+ * @brief Writes one GIF image: a rectangle of the frame, LZW-compressed.
+ */
+static int write_gif_image(struct life_recorder *recorder, const uint64_t *rows, int top, int left,
+                           int height, int width, int delay) {
+    unsigned char control[8] = { 0x21, 0xf9, 4, 1 << 2, 0, 0, 0, 0 };  // Disposal 1: keep the frame
+    put_u16(control + 4, delay);
+    unsigned char descriptor[11] = { 0x2c, 0, 0, 0, 0, 0, 0, 0, 0, 0, GIF_MIN_CODE_SIZE };
+    put_u16(descriptor + 1, left);
+    put_u16(descriptor + 3, top);
+    put_u16(descriptor + 5, width);
+    put_u16(descriptor + 7, height);
+    if (fwrite(control, sizeof(control), 1, recorder->file) != 1 ||
+        fwrite(descriptor, sizeof(descriptor), 1, recorder->file) != 1) {
+        return -1;
+    }
+
+    const int clear = 1 << GIF_MIN_CODE_SIZE, end = clear + 1;
+    struct gif_bits out = { recorder->file, 0, 0, { 0 }, 0 };
+    int size = GIF_MIN_CODE_SIZE + 1;
+    int last_code = end;
+    memset(recorder->codes, 0, GIF_MAX_CODES * sizeof(*recorder->codes));
+    put_code(&out, clear, size);
+
+    int prefix = frame_pixel(recorder, rows, top, left);
+    for (long long i = 1; i < (long long)width * height; i++) {
+        int pixel = frame_pixel(recorder, rows, top + (int)(i / width), left + (int)(i % width));
+        if (recorder->codes[prefix][pixel] != 0) {
+            prefix = recorder->codes[prefix][pixel];
+            continue;
+        }
+        put_code(&out, prefix, size);
+        recorder->codes[prefix][pixel] = (uint16_t)++last_code;
+        if (last_code >= (1 << size)) {
+            size++;
+        }
+        if (last_code == GIF_MAX_CODES - 1) {
+            put_code(&out, clear, size);
+            memset(recorder->codes, 0, GIF_MAX_CODES * sizeof(*recorder->codes));
+            size = GIF_MIN_CODE_SIZE + 1;
+            last_code = end;
+        }
+        prefix = pixel;
+    }
+    // The decoder adds one more code on reading the last one
+    put_code(&out, prefix, size);
+    if (last_code + 1 >= (1 << size) && (1 << size) < GIF_MAX_CODES) {
+        size++;
+    }
+    put_code(&out, end, size);
+    if (out.count > 0) {
+        put_code(&out, 0, 8 - out.count);
+    }
+    flush_block(&out);
+    if (fputc(0, recorder->file) == EOF) {
+        return -1;
+    }
+    return out.failed ? -1 : 0;
+}
+
+/**
+ * @brief Writes a GIF frame covering the pixels that changed since the
+ * last frame written.
+ */
+static int write_gif_frame(struct life_recorder *recorder, const struct frame *frame, int delay) {
+    if (recorder->written == 0) {
+        return write_gif_image(recorder, frame->rows, 0, 0, recorder->height, recorder->width, delay);
+    }
+
+    int top = -1, bottom = -1;
+    uint64_t *columns = recorder->delta;
+    memset(columns, 0, (size_t)recorder->words * sizeof(uint64_t));
+    for (int x = 0; x < recorder->height; x++) {
+        const uint64_t *now = frame->rows + (size_t)x * recorder->words;
+        const uint64_t *before = recorder->shown + (size_t)x * recorder->words;
+        uint64_t any = 0;
+        for (int w = 0; w < recorder->words; w++) {
+            uint64_t changed = now[w] ^ before[w];
+            columns[w] |= changed;
+            any |= changed;
+        }
+        if (any) {
+            if (top < 0) {
+                top = x;
+            }
+            bottom = x;
+        }
+    }
+    if (top < 0) {
+        // Nothing changed: repeat one pixel to carry the delay
+        return write_gif_image(recorder, frame->rows, 0, 0, 1, 1, delay);
+    }
+
+    int left = -1, right = -1;
+    for (int w = 0; w < recorder->words; w++) {
+        if (columns[w] != 0) {
+            if (left < 0) {
+                left = w * 64 + __builtin_ctzll(columns[w]);
+            }
+            right = w * 64 + 63 - __builtin_clzll(columns[w]);
+        }
+    }
+    return write_gif_image(recorder, frame->rows, top, left, bottom - top + 1, right - left + 1, delay);
+}
+
+/**
+ * @brief Returns the GIF delay of a frame followed by one gap generations later.
+ */
+static int gif_delay(const struct life_recorder *recorder, long long gap) {
+    long long delay = LIFE_RECORD_DELAY * gap / recorder->every;
+    return delay < 1 ? 1 : delay > 0xffff ? 0xffff : (int)delay;
+}
+
+/**
+ * @brief Makes frame the last frame written.
+ */
+static void shown_is(struct life_recorder *recorder, const struct frame *frame) {
+    memcpy(recorder->shown, frame->rows, recorder->frame_words * sizeof(uint64_t));
+    recorder->written++;
+}
+
+/**
+ * @brief Writes a frame taken from the ring.
+ *
+ * A GIF frame is only written once the next one arrives, so that its
+ * delay is known; the frame itself is held until then.
+ */
+static void encode(struct life_recorder *recorder, const struct frame *frame) {
+    if (recorder->failed) {
+        return;
+    }
+    if (recorder->format == RECORD_STREAM) {
+        if (write_stream_frame(recorder, frame) != 0) {
+            recorder->failed = 1;
+            return;
+        }
+        shown_is(recorder, frame);
+    } else {
+        if (recorder->holding) {
+            int delay = gif_delay(recorder, frame->generation - recorder->held.generation);
+            if (write_gif_frame(recorder, &recorder->held, delay) != 0) {
+                recorder->failed = 1;
+                return;
+            }
+            shown_is(recorder, &recorder->held);
+        }
+        memcpy(recorder->held.rows, frame->rows, recorder->frame_words * sizeof(uint64_t));
+        recorder->held.generation = frame->generation;
+        recorder->holding = 1;
+    }
+    if (fflush(recorder->file) != 0) {
+        recorder->failed = 1;
+    }
+}
+
+static void *encoder_main(void *data) {
+    struct life_recorder *recorder = data;
+
+    pthread_mutex_lock(&recorder->lock);
+    while (1) {
+        while (recorder->queued == 0 && !recorder->stop) {
+            pthread_cond_wait(&recorder->ready, &recorder->lock);
+        }
+        if (recorder->queued == 0) {
+            break;
+        }
+        struct frame *frame = &recorder->slots[recorder->head];
+        pthread_mutex_unlock(&recorder->lock);
+
+        encode(recorder, frame);
+
+        pthread_mutex_lock(&recorder->lock);
+        recorder->head = (recorder->head + 1) % LIFE_RECORD_SLOTS;
+        recorder->queued--;
+    }
+    pthread_mutex_unlock(&recorder->lock);
+    return NULL;
+}
+
+/**
+ * @brief Writes the start of the file: the stream header, or the GIF
+ * header, palette (dead white, alive black) and loop extension.
+ */
+static int write_header(struct life_recorder *recorder) {
+    if (recorder->format == RECORD_STREAM) {
+        struct stream_header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = STREAM_VERSION;
+        header.width = recorder->width;
+        header.height = recorder->height;
+        header.scale = recorder->scale;
+        return fwrite(&header, sizeof(header), 1, recorder->file) == 1 ? 0 : -1;
+    }
+
+    unsigned char header[13 + 6 + 19] = "GIF89a";
+    put_u16(header + 6, recorder->width);
+    put_u16(header + 8, recorder->height);
+    header[10] = 0x80;  // Global color table of 2 entries
+    const unsigned char palette[6] = { 0xff, 0xff, 0xff, 0, 0, 0 };
+    const unsigned char loop[19] = { 0x21, 0xff, 11, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0', 3, 1, 0, 0, 0 };
+    memcpy(header + 13, palette, sizeof(palette));
+    memcpy(header + 19, loop, sizeof(loop));
+    return fwrite(header, sizeof(header), 1, recorder->file) == 1 ? 0 : -1;
+}
+
+/**
+ * @brief Releases the buffers of a recorder whose thread is not running.
+ */
+static void free_recorder(struct life_recorder *recorder) {
+    for (int i = 0; i < LIFE_RECORD_SLOTS; i++) {
+        free(recorder->slots[i].rows);
+    }
+    free(recorder->merged);
+    free(recorder->shown);
+    free(recorder->delta);
+    free(recorder->held.rows);
+    free(recorder->codes);
+    free(recorder);
+}
+
+struct life_recorder *life_recorder_open(const struct life_record_options *options) {
+    if (options->scale < 1 || options->every < 1 || options->width < 1 || options->height < 1) {
+        return NULL;
+    }
+    struct life_recorder *recorder = calloc(1, sizeof(*recorder));
+    if (recorder == NULL) {
+        return NULL;
+    }
+
+    size_t length = strlen(options->path);
+    recorder->format = length >= 4 && strcmp(options->path + length - 4, ".gif") == 0 ? RECORD_GIF : RECORD_STREAM;
+    recorder->scale = options->scale;
+    recorder->every = options->every;
+    recorder->width = (options->width + options->scale - 1) / options->scale;
+    recorder->height = (options->height + options->scale - 1) / options->scale;
+    recorder->words = (recorder->width + 63) / 64;
+    recorder->frame_words = (size_t)recorder->height * recorder->words;
+    if (recorder->format == RECORD_GIF && (recorder->width > GIF_MAX_SIZE || recorder->height > GIF_MAX_SIZE)) {
+        free(recorder);
+        return NULL;
+    }
+
+    int ok = 1;
+    size_t frame_bytes = recorder->frame_words * sizeof(uint64_t);
+    for (int i = 0; i < LIFE_RECORD_SLOTS; i++) {
+        ok = ok && (recorder->slots[i].rows = malloc(frame_bytes)) != NULL;
+    }
+    ok = ok && (recorder->shown = calloc(recorder->frame_words, sizeof(uint64_t))) != NULL;
+    ok = ok && (recorder->delta = malloc(frame_bytes)) != NULL;
+    if (recorder->scale > 1) {
+        ok = ok && (recorder->merged = malloc((size_t)(options->width + 63) / 64 * sizeof(uint64_t))) != NULL;
+    }
+    if (recorder->format == RECORD_GIF) {
+        ok = ok && (recorder->held.rows = malloc(frame_bytes)) != NULL;
+        ok = ok && (recorder->codes = malloc(GIF_MAX_CODES * sizeof(*recorder->codes))) != NULL;
+    }
+    ok = ok && (recorder->file = fopen(options->path, "wb")) != NULL;
+    if (!ok) {
+        free_recorder(recorder);
+        return NULL;
+    }
+    setvbuf(recorder->file, NULL, _IOFBF, WRITE_BUFFER);
+
+    pthread_mutex_init(&recorder->lock, NULL);
+    pthread_cond_init(&recorder->ready, NULL);
+    if (write_header(recorder) != 0 || fflush(recorder->file) != 0 ||
+        pthread_create(&recorder->thread, NULL, encoder_main, recorder) != 0) {
+        pthread_mutex_destroy(&recorder->lock);
+        pthread_cond_destroy(&recorder->ready);
+        fclose(recorder->file);
+        remove(options->path);
+        free_recorder(recorder);
+        return NULL;
+    }
+    return recorder;
+}
+
+void life_recorder_submit(struct life_recorder *recorder, const struct life_grid *grid, long long generation) {
+    pthread_mutex_lock(&recorder->lock);
+    if (recorder->queued == LIFE_RECORD_SLOTS) {
+        // The encoder is behind: take back the newest frame it has not started
+        recorder->queued--;
+        recorder->dropped++;
+    }
+    struct frame *frame = &recorder->slots[(recorder->head + recorder->queued) % LIFE_RECORD_SLOTS];
+    pthread_mutex_unlock(&recorder->lock);
+
+    capture(recorder, grid, frame->rows);
+    frame->generation = generation;
+
+    pthread_mutex_lock(&recorder->lock);
+    recorder->queued++;
+    pthread_cond_signal(&recorder->ready);
+    pthread_mutex_unlock(&recorder->lock);
+}
+
+int life_recorder_close(struct life_recorder *recorder, struct life_record_totals *totals) {
+    if (recorder == NULL) {
+        return 0;
+    }
+    pthread_mutex_lock(&recorder->lock);
+    recorder->stop = 1;
+    pthread_cond_signal(&recorder->ready);
+    pthread_mutex_unlock(&recorder->lock);
+    pthread_join(recorder->thread, NULL);
+
+    if (recorder->format == RECORD_GIF && !recorder->failed) {
+        if (recorder->holding) {
+            if (write_gif_frame(recorder, &recorder->held, LIFE_RECORD_DELAY) == 0) {
+                shown_is(recorder, &recorder->held);
+            } else {
+                recorder->failed = 1;
+            }
+        }
+        if (fputc(0x3b, recorder->file) == EOF) {  // Trailer
+            recorder->failed = 1;
+        }
+    }
+    if (fclose(recorder->file) != 0) {
+        recorder->failed = 1;
+    }
+    if (totals != NULL) {
+        totals->written = recorder->written;
+        totals->dropped = recorder->dropped;
+    }
+
+    int status = recorder->failed ? -1 : 0;
+    pthread_mutex_destroy(&recorder->lock);
+    pthread_cond_destroy(&recorder->ready);
+    free_recorder(recorder);
+    return status;
+}
@@ -0,0 +1,98 @@
+/*******************************************************************
+ * Conway's Game of Life - Frame Recorder
+ *
+ * Author: hrosicka
+ * Description:
+ *   Records a run to a file without slowing it down. The stepping
+ *   loop hands over snapshots of the board, and a background thread
+ *   encodes and writes them.
+ *
+ * How It Works:
+ *   - life_recorder_submit() copies the board into a free slot of a
+ *     ring of LIFE_RECORD_SLOTS frames, shrunk by the scale factor
+ *     on the way: a recorded pixel is alive if any cell of its
+ *     scale x scale block is. The lock is only held to move the ring
+ *     indices, never while copying or encoding.
+ *   - If the encoder falls behind and the ring is full, the newest
+ *     waiting frame is replaced by the new one and counted as
+ *     dropped, so the stepping loop never waits for the encoder.
+ *     Frames are encoded against the last frame written, so dropping
+ *     one never breaks the stream.
+ *   - The encoder thread writes each frame as soon as it is taken
+ *     from the ring (a GIF frame as soon as the next one arrives), so
+ *     a run that is interrupted still leaves a readable file.
+ *
+ * Formats (chosen by the file name):
+ *   - ".gif": an animated GIF that loops. Each frame after the first
+ *     only covers the rectangle of pixels that changed, and its delay
+ *     is LIFE_RECORD_DELAY centiseconds per stride of generations
+ *     since the previous frame, so dropped frames do not speed up the
+ *     animation.
+ *   - Anything else: a delta frame stream. A 32-byte header (the magic
+ *     "LIFEFRMS", the version, the frame width and height, the scale)
+ *     is followed by the frames. Each frame is its 64-bit generation
+ *     and then the XOR of its rows with the previous frame, in the
+ *     life_grid row layout, as records of two 64-bit counts ("zero
+ *     words", "literal words") each followed by that many literal
+ *     words, until every word of the frame is covered. Integers are in
+ *     the writer's byte order.
+ *******************************************************************/
+
+#ifndef LIFE_RECORD_H
+#define LIFE_RECORD_H
+
+#include "grid.h"
+
+#define LIFE_RECORD_SLOTS 8     // Frames waiting for the encoder, at most
+#define LIFE_RECORD_DELAY 10    // GIF delay in centiseconds per stride
+
+struct life_recorder;
+
+/**
+ * @brief Parameters of a recording.
+ */
+struct life_record_options {
+    const char *path;       // Output file; ".gif" for a GIF, else a delta stream
+    int width;              // Board size
+    int height;
+    int scale;              // Board cells per recorded pixel, in each direction
+    long long every;        // Generations between frames (GIF timing only)
+};
+
+/**
+ * @brief Totals of a finished recording.
+ */
+struct life_record_totals {
+    long long written;      // Frames written
+    long long dropped;      // Frames replaced before they were encoded
+};
+
+/**
+ * @brief Creates the file and starts the encoder thread.
+ *
+ * @return struct life_recorder* The recorder, or NULL if the file
+ *         cannot be created, a GIF would be larger than 65535 pixels
+ *         in either direction, or memory runs out.
+ */
+struct life_recorder *life_recorder_open(const struct life_record_options *options);
+
+/**
+ * @brief Queues a snapshot of the board; never waits for the encoder.
+ *
+ * @param recorder The recorder.
+ * @param grid The board, of the size given to life_recorder_open().
+ * @param generation Generation the board is at.
+ */
+void life_recorder_submit(struct life_recorder *recorder, const struct life_grid *grid, long long generation);
+
+/**
+ * @brief Encodes the frames still queued, finishes the file and frees
+ * the recorder.
+ *
+ * @param recorder The recorder, or NULL.
+ * @param totals Filled in with the frame counts, or NULL.
+ * @return int 0 on success, -1 if the file could not be written.
+ */
+int life_recorder_close(struct life_recorder *recorder, struct life_record_totals *totals);
+
+#endif // LIFE_RECORD_H
@@ -0,0 +1,54 @@
+/*******************************************************************
+ * Conway's Game of Life - Scalar Reference
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the reference step declared in reference.h.
+ *******************************************************************/
+
+#include "reference.h"
+
+int life_count_live_neighbors(const uint8_t *cells, int width, int height, enum life_edges edges, int x, int y) {
+    int count = 0;
+    for (int i = -1; i <= 1; i++) {
+        for (int j = -1; j <= 1; j++) {
+            if (i == 0 && j == 0) continue; // Skip the cell itself
+
+            int neighbor_x = x + i;
+            int neighbor_y = y + j;
+
+            if (edges == LIFE_EDGES_WRAP) {
+                // Handle wrap-around edges
+                neighbor_x = (neighbor_x + height) % height;
+                neighbor_y = (neighbor_y + width) % width;
+            } else if (neighbor_x < 0 || neighbor_x >= height || neighbor_y < 0 || neighbor_y >= width) {
+                continue; // Only count neighbors within grid bounds
+            }
+
+            if (cells[(long long)neighbor_x * width + neighbor_y] == 1) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+void life_reference_step(const uint8_t *cells, uint8_t *next, int width, int height, enum life_edges edges,
+                         const struct life_ruleset *rule, long long *births, long long *deaths) {
+    long long born = 0, died = 0;
+    for (int i = 0; i < height; i++) {
+        for (int j = 0; j < width; j++) {
+            long long cell = (long long)i * width + j;
+            int neighbors = life_count_live_neighbors(cells, width, height, edges, i, j);
+            next[cell] = (uint8_t)life_rule_next(rule, cells[cell], neighbors);
+            born += !cells[cell] && next[cell];
+            died += cells[cell] && !next[cell];
+        }
+    }
+    if (births != NULL) {
+        *births = born;
+    }
+    if (deaths != NULL) {
+        *deaths = died;
+    }
+}
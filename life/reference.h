@@ -0,0 +1,56 @@
+/*******************************************************************
+ * Conway's Game of Life - Scalar Reference
+ *
+ * Author: hrosicka
+ * Description:
+ *   The original one-cell-at-a-time step of the programs, kept as the
+ *   reference the fast kernels are checked against (see conform.h).
+ *   It is deliberately the obvious loop: each cell counts its eight
+ *   neighbors with life_count_live_neighbors() and applies the rule.
+ *   It is far too slow for real runs and is never used by them.
+ *
+ * Coordinates follow the rest of the repository: x is the row index
+ * and y is the column index.
+ *******************************************************************/
+
+#ifndef LIFE_REFERENCE_H
+#define LIFE_REFERENCE_H
+
+#include <stdint.h>
+
+#include "grid.h"
+
+/**
+ * @brief Counts the number of living neighbors for a given cell.
+ *
+ * Iterates over the surrounding 3x3 neighborhood (excluding the cell
+ * itself). On a torus neighbor coordinates wrap around to the opposite
+ * edge, as in the glider program; on a clipped board they are ignored
+ * outside the grid, as in the gun program.
+ *
+ * @param cells The board, one byte per cell in row-major order.
+ * @param width Number of columns.
+ * @param height Number of rows.
+ * @param edges Edge mode of the board.
+ * @param x The row index of the cell.
+ * @param y The column index of the cell.
+ * @return int The number of living neighbors (0-8).
+ */
+int life_count_live_neighbors(const uint8_t *cells, int width, int height, enum life_edges edges, int x, int y);
+
+/**
+ * @brief Computes the next generation of a board, one cell at a time.
+ *
+ * @param cells The board, one byte per cell (0 or 1) in row-major order.
+ * @param next Output, the next generation in the same layout.
+ * @param width Number of columns.
+ * @param height Number of rows.
+ * @param edges Edge mode of the board.
+ * @param rule The rule.
+ * @param births Set to the number of cells that came alive, if not NULL.
+ * @param deaths Set to the number of cells that died, if not NULL.
+ */
+void life_reference_step(const uint8_t *cells, uint8_t *next, int width, int height, enum life_edges edges,
+                         const struct life_ruleset *rule, long long *births, long long *deaths);
+
+#endif // LIFE_REFERENCE_H
@@ -0,0 +1,171 @@
+/*******************************************************************
+ * Conway's Game of Life - Diff-Based Terminal Renderer
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the renderer declared in render.h.
+ *
+ * Frame Encoding:
+ *   Cells are compared with the frame on screen row by row. A run
+ *   of changed cells in one row costs one cursor move ("ESC[row;colH")
+ *   followed by their glyphs, because the terminal cursor advances
+ *   by itself while glyphs are printed.
+ *******************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "render.h"
+
+#define MOVE_MAX 24     // Longest cursor move sequence
+#define SCREEN_UNKNOWN 2   // Screen state that matches no cell
+
+struct life_render {
+    int rows;
+    int cols;
+    const char *glyphs[2];      // Dead and live glyph
+    size_t glyph_len;           // Bytes (and columns) per glyph
+    unsigned char *screen;      // Cell states currently on screen
+    char *buffer;               // Output of one frame
+    size_t capacity;
+    size_t last_bytes;          // Size of the last frame written
+    int drawn;                  // Set once the first frame is on screen
+    char status[LIFE_RENDER_STATUS_MAX + 1];   // Status line on screen
+};
+
+struct life_render *life_render_create(int rows, int cols, const char *alive_glyph, const char *dead_glyph) {
+    if (rows <= 0 || cols <= 0) {
+        return NULL;
+    }
+    struct life_render *render = calloc(1, sizeof(*render));
+    if (render == NULL) {
+        return NULL;
+    }
+    render->rows = rows;
+    render->cols = cols;
+    render->glyphs[0] = dead_glyph;
+    render->glyphs[1] = alive_glyph;
+    render->glyph_len = strlen(alive_glyph);
+
+    size_t cells = (size_t)rows * (size_t)cols;
+    // Worst case: every cell changed and needs its own cursor move
+    render->capacity = cells * (MOVE_MAX + render->glyph_len) + LIFE_RENDER_STATUS_MAX + 64;
+    render->screen = malloc(cells);
+    render->buffer = malloc(render->capacity);
+    if (render->screen == NULL || render->buffer == NULL) {
+        life_render_free(render);
+        return NULL;
+    }
+    memset(render->screen, SCREEN_UNKNOWN, cells);
+    render->status[0] = '\0';
+    return render;
+}
+
+/**
+ * @brief Writes the whole buffer to the terminal.
+ */
+static int write_all(const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(STDOUT_FILENO, data, size);
+        if (written <= 0) {
+            return -1;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return 0;
+}
+
+void life_render_free(struct life_render *render) {
+    if (render == NULL) {
+        return;
+    }
+    if (render->drawn) {
+        // Show the cursor again, below the window and the status line
+        char tail[MOVE_MAX + 8];
+        int len = snprintf(tail, sizeof(tail), "\x1b[%d;1H\x1b[?25h", render->rows + 2);
+        write_all(tail, (size_t)len);
+    }
+    free(render->screen);
+    free(render->buffer);
+    free(render);
+}
+
+/**
+ * @brief Appends a cursor move to 1-based terminal row and column.
+ */
+static size_t put_move(char *out, int row, size_t col) {
+    // Hand-rolled instead of snprintf: this runs once per changed run
+    char digits[24];
+    size_t len = 0;
+    out[len++] = '\x1b';
+    out[len++] = '[';
+    for (int pass = 0; pass < 2; pass++) {
+        size_t value = pass == 0 ? (size_t)row : col;
+        int n = 0;
+        do {
+            digits[n++] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (n > 0) {
+            out[len++] = digits[--n];
+        }
+        out[len++] = pass == 0 ? ';' : 'H';
+    }
+    return len;
+}
+
+int life_render_frame(struct life_render *render, life_render_cell cell, const void *board, const char *status) {
+    char *out = render->buffer;
+    size_t len = 0;
+
+    if (!render->drawn) {
+        // First frame: clear the screen and hide the cursor
+        static const char clear[] = "\x1b[2J\x1b[?25l";
+        memcpy(out, clear, sizeof(clear) - 1);
+        len += sizeof(clear) - 1;
+        render->drawn = 1;
+    }
+
+    for (int x = 0; x < render->rows; x++) {
+        unsigned char *shown = render->screen + (size_t)x * render->cols;
+        int in_run = 0;
+        for (int y = 0; y < render->cols; y++) {
+            unsigned char alive = (unsigned char)(cell(board, x, y) != 0);
+            if (alive == shown[y]) {
+                in_run = 0;
+                continue;
+            }
+            if (!in_run) {
+                len += put_move(out + len, x + 1, (size_t)y * render->glyph_len + 1);
+                in_run = 1;
+            }
+            memcpy(out + len, render->glyphs[alive], render->glyph_len);
+            len += render->glyph_len;
+            shown[y] = alive;
+        }
+    }
+
+    if (status == NULL) {
+        status = "";
+    }
+    if (strncmp(status, render->status, LIFE_RENDER_STATUS_MAX) != 0) {
+        size_t status_len = strnlen(status, LIFE_RENDER_STATUS_MAX);
+        len += put_move(out + len, render->rows + 1, 1);
+        memcpy(out + len, status, status_len);
+        len += status_len;
+        memcpy(out + len, "\x1b[K", 3); // Erase the rest of the old line
+        len += 3;
+        memcpy(render->status, status, status_len);
+        render->status[status_len] = '\0';
+    }
+
+    render->last_bytes = len;
+    return len > 0 ? write_all(out, len) : 0;
+}
+
+size_t life_render_last_bytes(const struct life_render *render) {
+    return render->last_bytes;
+}
@@ -0,0 +1,73 @@
+/*******************************************************************
+ * Conway's Game of Life - Diff-Based Terminal Renderer
+ *
+ * Author: hrosicka
+ * Description:
+ *   Draws a window of the board with ANSI escape sequences. The
+ *   renderer keeps the frame that is currently on screen and, for
+ *   each new frame, only emits cursor moves and glyphs for the cells
+ *   that changed. The whole frame is built in one buffer allocated
+ *   up front and handed to the terminal with a single write() call,
+ *   so output is proportional to the changes and nothing flickers.
+ *******************************************************************/
+
+#ifndef LIFE_RENDER_H
+#define LIFE_RENDER_H
+
+#include <stddef.h>
+
+#define LIFE_RENDER_STATUS_MAX 256   // Longest status line, in bytes
+
+struct life_render;
+
+/**
+ * @brief Returns the state of cell (x, y) of a board.
+ *
+ * @param board The board passed to life_render_frame().
+ * @param x The row index of the cell.
+ * @param y The column index of the cell.
+ * @return int 1 if the cell is alive, 0 otherwise.
+ */
+typedef int (*life_render_cell)(const void *board, long long x, long long y);
+
+/**
+ * @brief Creates a renderer for a window of rows x cols cells.
+ *
+ * Both glyphs must take the same number of terminal columns.
+ *
+ * @param rows Rows shown, starting at row 0 of the board.
+ * @param cols Columns shown, starting at column 0 of the board.
+ * @param alive_glyph Printed for a live cell.
+ * @param dead_glyph Printed for a dead cell.
+ * @return struct life_render* The renderer, or NULL if out of memory.
+ */
+struct life_render *life_render_create(int rows, int cols, const char *alive_glyph, const char *dead_glyph);
+
+/**
+ * @brief Restores the cursor and frees the renderer.
+ *
+ * @param render The renderer (may be NULL).
+ */
+void life_render_free(struct life_render *render);
+
+/**
+ * @brief Brings the screen up to date with the board.
+ *
+ * The first frame clears the screen and draws every cell; later
+ * frames only redraw the cells that changed since the last one.
+ *
+ * @param render The renderer.
+ * @param cell Reads one cell of the board.
+ * @param board Passed to cell.
+ * @param status Line printed below the window (may be NULL); cut
+ *               at LIFE_RENDER_STATUS_MAX bytes.
+ * @return int 0 on success, -1 if the terminal could not be written.
+ */
+int life_render_frame(struct life_render *render, life_render_cell cell, const void *board, const char *status);
+
+/**
+ * @brief Returns the number of bytes written for the last frame.
+ */
+size_t life_render_last_bytes(const struct life_render *render);
+
+#endif // LIFE_RENDER_H
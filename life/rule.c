@@ -0,0 +1,118 @@
+/*******************************************************************
+ * Conway's Game of Life - Rule Strings
+ *
+ * Author: hrosicka
+ * Description:
+ *   Parsing and formatting of the "B.../S..." rules declared in
+ *   rule.h.
+ *******************************************************************/
+
+#include <ctype.h>
+#include <stdio.h>
+
+#include "rule.h"
+
+/**
+ * @brief A rule known by name.
+ */
+struct named_rule {
+    const char *name;
+    const char *text;
+};
+
+static const struct named_rule named_rules[] = {
+    { "life", "B3/S23" },
+    { "highlife", "B36/S23" },
+    { "seeds", "B2/S" },
+    { "daynight", "B3678/S34678" },
+};
+
+/**
+ * @brief Compares two names, ignoring case.
+ */
+static int same_name(const char *a, const char *b) {
+    for (; *a != '\0' && *b != '\0'; a++, b++) {
+        if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) {
+            return 0;
+        }
+    }
+    return *a == *b;
+}
+
+/**
+ * @brief Reads a run of neighbor counts ("236") into a mask.
+ *
+ * @return const char* The first character after the digits, or NULL
+ *         if a digit is 9 or repeated.
+ */
+static const char *parse_counts(const char *text, uint16_t *mask) {
+    *mask = 0;
+    for (; *text >= '0' && *text <= '9'; text++) {
+        uint16_t bit = (uint16_t)(1u << (*text - '0'));
+        if (*text == '9' || (*mask & bit)) {
+            return NULL;
+        }
+        *mask |= bit;
+    }
+    return text;
+}
+
+int life_rule_parse(const char *text, struct life_ruleset *rule) {
+    for (size_t i = 0; i < sizeof(named_rules) / sizeof(named_rules[0]); i++) {
+        if (same_name(text, named_rules[i].name)) {
+            text = named_rules[i].text;
+            break;
+        }
+    }
+
+    struct life_ruleset parsed = { 0, 0 };
+    char first = (char)toupper((unsigned char)text[0]);
+    if (first == 'B' || first == 'S') {
+        // "B3/S23" or "S23/B3"
+        uint16_t *masks[2] = { first == 'B' ? &parsed.birth : &parsed.survival,
+                               first == 'B' ? &parsed.survival : &parsed.birth };
+        const char *p = parse_counts(text + 1, masks[0]);
+        if (p == NULL || *p != '/' || toupper((unsigned char)p[1]) != (first == 'B' ? 'S' : 'B')) {
+            return -1;
+        }
+        p = parse_counts(p + 2, masks[1]);
+        if (p == NULL || *p != '\0') {
+            return -1;
+        }
+    } else {
+        // "23/3": survival first
+        const char *p = parse_counts(text, &parsed.survival);
+        if (p == NULL || *p != '/') {
+            return -1;
+        }
+        p = parse_counts(p + 1, &parsed.birth);
+        if (p == NULL || *p != '\0') {
+            return -1;
+        }
+    }
+    if (parsed.birth & 1) {
+        return -1;  // B0 would fill empty space
+    }
+    *rule = parsed;
+    return 0;
+}
+
+void life_rule_format(const struct life_ruleset *rule, char *text, size_t size) {
+    char buffer[LIFE_RULE_TEXT_MAX];
+    size_t length = 0;
+    buffer[length++] = 'B';
+    for (int n = 0; n <= 8; n++) {
+        if ((rule->birth >> n) & 1) {
+            buffer[length++] = (char)('0' + n);
+        }
+    }
+    buffer[length++] = '/';
+    buffer[length++] = 'S';
+    for (int n = 0; n <= 8; n++) {
+        if ((rule->survival >> n) & 1) {
+            buffer[length++] = (char)('0' + n);
+        }
+    }
+    buffer[length] = '\0';
+    snprintf(text, size, "%s", buffer);
+}
@@ -0,0 +1,167 @@
+/*******************************************************************
+ * Conway's Game of Life - Bitwise Rule
+ *
+ * Author: hrosicka
+ * Description:
+ *   Life-like rules for 64 cells at once, shared by the engines that
+ *   store one bit per cell (grid.c and sparse.c). For every cell the
+ *   eight neighbors are summed with a tree of bitwise full adders.
+ *
+ *   A rule is written "B.../S...": the neighbor counts at which a
+ *   dead cell is born and a live cell survives. Conway's Game of Life
+ *   is B3/S23, HighLife B36/S23, Seeds B2/S and Day & Night
+ *   B3678/S34678. A rule is stored as a 2 x 9 transition table, one
+ *   9-bit row per cell state.
+ *
+ *   - life_rule() is B3/S23 only. Its rules reduce to a handful of
+ *     AND/OR operations on the sum bits; it is the fast path.
+ *   - life_rule_generic() evaluates any rule without branches. It
+ *     sums the neighbors into four bit planes and ORs together the
+ *     counts allowed by the table. When the rule is a compile-time
+ *     constant, the compiler drops the counts the rule never uses.
+ *
+ *   Rules with B0 are not supported: every engine assumes that empty
+ *   space stays empty.
+ *******************************************************************/
+
+#ifndef LIFE_RULE_H
+#define LIFE_RULE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LIFE_RULE_CONWAY { 1u << 3, (1u << 2) | (1u << 3) }   // B3/S23 initializer
+#define LIFE_RULE_TEXT_MAX 24   // Longest text from life_rule_format(), terminator included
+
+/**
+ * @brief A life-like rule as a 2 x 9 transition table.
+ *
+ * Bit n of birth is the next state of a dead cell with n live
+ * neighbors, bit n of survival that of a live cell.
+ */
+struct life_ruleset {
+    uint16_t birth;
+    uint16_t survival;
+};
+
+/**
+ * @brief Parses a rule.
+ *
+ * Accepts "B3/S23" (letters in either case, either order), the
+ * survival-first form "23/3", and the names life, highlife, seeds
+ * and daynight (in any case).
+ *
+ * @param text The rule text.
+ * @param rule Set to the rule on success.
+ * @return int 0 on success, -1 if the text is not a rule or uses B0.
+ */
+int life_rule_parse(const char *text, struct life_ruleset *rule);
+
+/**
+ * @brief Writes a rule as "B.../S..." into text.
+ *
+ * @param size Size of text; LIFE_RULE_TEXT_MAX always suffices.
+ */
+void life_rule_format(const struct life_ruleset *rule, char *text, size_t size);
+
+/**
+ * @brief Returns 1 if the rule is B3/S23.
+ */
+static inline int life_rule_is_conway(const struct life_ruleset *rule) {
+    const struct life_ruleset conway = LIFE_RULE_CONWAY;
+    return rule->birth == conway.birth && rule->survival == conway.survival;
+}
+
+/**
+ * @brief Returns the next state of one cell (0 or 1).
+ */
+static inline int life_rule_next(const struct life_ruleset *rule, int alive, int neighbors) {
+    return ((alive ? rule->survival : rule->birth) >> neighbors) & 1;
+}
+
+/**
+ * @brief Computes the next state of 64 cells from their neighbor rows.
+ *
+ * Each argument holds one neighbor direction for the 64 cells. The
+ * upper and lower triples are each reduced to a 2-bit sum, the two
+ * horizontal neighbors to another one, and those are added once more.
+ * A cell has two or three neighbors exactly when the weight-2 bits
+ * add up to one; the weight-1 bit then tells two from three.
+ *
+ * @return uint64_t The 64 cells of the next generation.
+ */
+static inline uint64_t life_rule(uint64_t nw, uint64_t n, uint64_t ne,
+                                 uint64_t w, uint64_t self, uint64_t e,
+                                 uint64_t sw, uint64_t s, uint64_t se) {
+    // Upper row: 2-bit sum (u1 u0)
+    uint64_t u0 = nw ^ n ^ ne;
+    uint64_t u1 = (nw & n) | (ne & (nw ^ n));
+
+    // Lower row: 2-bit sum (l1 l0)
+    uint64_t l0 = sw ^ s ^ se;
+    uint64_t l1 = (sw & s) | (se & (sw ^ s));
+
+    // Middle row: 2-bit sum (m1 m0)
+    uint64_t m0 = w ^ e;
+    uint64_t m1 = w & e;
+
+    // Weight-1 bits: sum bit and carry into weight 2
+    uint64_t s0 = u0 ^ l0 ^ m0;
+    uint64_t c0 = (u0 & l0) | (m0 & (u0 ^ l0));
+
+    // Exactly one of the four weight-2 bits set <=> 2 or 3 neighbors
+    uint64_t p = u1 ^ l1, q = u1 & l1;
+    uint64_t r = m1 ^ c0, t = m1 & c0;
+    uint64_t two_or_three = (p ^ r) & ~(q | t);
+
+    return two_or_three & (s0 | self);
+}
+
+/**
+ * @brief Computes the next state of 64 cells under any rule.
+ *
+ * Same arguments as life_rule(). The neighbor count of every cell is
+ * built as four bit planes (weights 1, 2, 4 and 8); each count n the
+ * rule uses selects the cells whose planes spell n.
+ *
+ * @param rule The rule.
+ * @return uint64_t The 64 cells of the next generation.
+ */
+static inline uint64_t life_rule_generic(const struct life_ruleset *rule,
+                                         uint64_t nw, uint64_t n, uint64_t ne,
+                                         uint64_t w, uint64_t self, uint64_t e,
+                                         uint64_t sw, uint64_t s, uint64_t se) {
+    // Same row sums as life_rule(), each a 2-bit number
+    uint64_t u0 = nw ^ n ^ ne;
+    uint64_t u1 = (nw & n) | (ne & (nw ^ n));
+    uint64_t l0 = sw ^ s ^ se;
+    uint64_t l1 = (sw & s) | (se & (sw ^ s));
+    uint64_t m0 = w ^ e;
+    uint64_t m1 = w & e;
+
+    // Weight 1 and its carry
+    uint64_t b0 = u0 ^ l0 ^ m0;
+    uint64_t c0 = (u0 & l0) | (m0 & (u0 ^ l0));
+
+    // Weight 2 holds u1 + l1 + m1 + c0 (0 to 4), added as two pairs
+    uint64_t x = u1 ^ l1, cx = u1 & l1;
+    uint64_t y = m1 ^ c0, cy = m1 & c0;
+    uint64_t b1 = x ^ y;
+    uint64_t b2 = (x & y) ^ cx ^ cy;
+    uint64_t b3 = cx & cy;
+
+    uint64_t next = 0;
+    for (int count = 0; count <= 8; count++) {
+        uint64_t born = (uint64_t)0 - ((rule->birth >> count) & 1);
+        uint64_t survives = (uint64_t)0 - ((rule->survival >> count) & 1);
+        if ((born | survives) == 0) {
+            continue;
+        }
+        uint64_t match = ((count & 1) ? b0 : ~b0) & ((count & 2) ? b1 : ~b1) &
+                         ((count & 4) ? b2 : ~b2) & ((count & 8) ? b3 : ~b3);
+        next |= match & ((born & ~self) | (survives & self));
+    }
+    return next;
+}
+
+#endif // LIFE_RULE_H
@@ -0,0 +1,281 @@
+/*******************************************************************
+ * Conway's Game of Life - Vectorized Byte-Per-Cell Step Kernel
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the kernels declared in simd.h.
+ *
+ * Layout of the Work:
+ *   Each output row is produced from the row above, the row itself
+ *   and the row below. Columns whose three horizontal neighbors are
+ *   inside the row are summed with plain unaligned vector loads,
+ *   free of bounds checks and modulo arithmetic.
+ *
+ *   On a halo-padded board that holds for every cell, because the
+ *   ghost border already contains what lies past each edge; the edge
+ *   mode only matters when the border is filled.
+ *
+ *   The CPUID choice is made once, under pthread_once(), and the
+ *   choice of life_simd_select() is an atomic pointer, so pool
+ *   threads can read both while they step.
+ *******************************************************************/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#include "simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LIFE_SIMD_X86 1
+#endif
+
+typedef void (*row_kernel)(uint8_t *out, const uint8_t *up, const uint8_t *mid,
+                           const uint8_t *down, int first, int last);
+
+/**
+ * @brief Conway's rules for one cell given its neighbor count.
+ */
+static inline uint8_t conway_next(uint8_t self, int neighbors) {
+    return (uint8_t)(neighbors == 3 || (self && neighbors == 2));
+}
+
+/**
+ * @brief Scalar kernel for columns [first, last) of an output row.
+ *
+ * Requires first >= 1 and last <= width - 1, so that every neighbor
+ * column is inside the row.
+ */
+static void row_scalar(uint8_t *out, const uint8_t *up, const uint8_t *mid,
+                       const uint8_t *down, int first, int last) {
+    for (int j = first; j < last; j++) {
+        int neighbors = up[j - 1] + up[j] + up[j + 1] +
+                        mid[j - 1] + mid[j + 1] +
+                        down[j - 1] + down[j] + down[j + 1];
+        out[j] = conway_next(mid[j], neighbors);
+    }
+}
+
+/**
+ * @brief Transition table of a rule: next[alive][neighbors].
+ */
+struct rule_table {
+    uint8_t next[2][9];
+};
+
+static void build_rule_table(struct rule_table *table, const struct life_ruleset *rule) {
+    for (int alive = 0; alive < 2; alive++) {
+        for (int n = 0; n <= 8; n++) {
+            table->next[alive][n] = (uint8_t)life_rule_next(rule, alive, n);
+        }
+    }
+}
+
+/**
+ * @brief Scalar kernel for any rule; same contract as row_scalar().
+ *
+ * The vector kernels hard-code B3/S23, so other rules come here.
+ */
+static void row_table(uint8_t *out, const uint8_t *up, const uint8_t *mid,
+                      const uint8_t *down, int first, int last, const struct rule_table *table) {
+    for (int j = first; j < last; j++) {
+        int neighbors = up[j - 1] + up[j] + up[j + 1] +
+                        mid[j - 1] + mid[j + 1] +
+                        down[j - 1] + down[j] + down[j + 1];
+        out[j] = table->next[mid[j]][neighbors];
+    }
+}
+
+#ifdef LIFE_SIMD_X86
+
+__attribute__((target("sse2")))
+static void row_sse2(uint8_t *out, const uint8_t *up, const uint8_t *mid,
+                     const uint8_t *down, int first, int last) {
+    const __m128i two = _mm_set1_epi8(2);
+    const __m128i three = _mm_set1_epi8(3);
+    const __m128i one = _mm_set1_epi8(1);
+    int j = first;
+
+    for (; j + 16 <= last; j += 16) {
+#define LOAD(p) _mm_loadu_si128((const __m128i *)(p))
+        __m128i sum = _mm_add_epi8(_mm_add_epi8(LOAD(up + j - 1), LOAD(up + j)), LOAD(up + j + 1));
+        sum = _mm_add_epi8(sum, _mm_add_epi8(LOAD(mid + j - 1), LOAD(mid + j + 1)));
+        sum = _mm_add_epi8(sum, _mm_add_epi8(_mm_add_epi8(LOAD(down + j - 1), LOAD(down + j)), LOAD(down + j + 1)));
+        __m128i self = LOAD(mid + j);
+#undef LOAD
+        // Born or survives with 3; survives with 2 only if alive
+        __m128i alive = _mm_or_si128(_mm_cmpeq_epi8(sum, three),
+                                     _mm_and_si128(_mm_cmpeq_epi8(sum, two),
+                                                   _mm_cmpeq_epi8(self, one)));
+        _mm_storeu_si128((__m128i *)(out + j), _mm_and_si128(alive, one));
+    }
+    row_scalar(out, up, mid, down, j, last);
+}
+
+__attribute__((target("avx2")))
+static void row_avx2(uint8_t *out, const uint8_t *up, const uint8_t *mid,
+                     const uint8_t *down, int first, int last) {
+    const __m256i two = _mm256_set1_epi8(2);
+    const __m256i three = _mm256_set1_epi8(3);
+    const __m256i one = _mm256_set1_epi8(1);
+    int j = first;
+
+    for (; j + 32 <= last; j += 32) {
+#define LOAD(p) _mm256_loadu_si256((const __m256i *)(p))
+        __m256i sum = _mm256_add_epi8(_mm256_add_epi8(LOAD(up + j - 1), LOAD(up + j)), LOAD(up + j + 1));
+        sum = _mm256_add_epi8(sum, _mm256_add_epi8(LOAD(mid + j - 1), LOAD(mid + j + 1)));
+        sum = _mm256_add_epi8(sum, _mm256_add_epi8(_mm256_add_epi8(LOAD(down + j - 1), LOAD(down + j)), LOAD(down + j + 1)));
+        __m256i self = LOAD(mid + j);
+#undef LOAD
+        __m256i alive = _mm256_or_si256(_mm256_cmpeq_epi8(sum, three),
+                                        _mm256_and_si256(_mm256_cmpeq_epi8(sum, two),
+                                                         _mm256_cmpeq_epi8(self, one)));
+        _mm256_storeu_si256((__m256i *)(out + j), _mm256_and_si256(alive, one));
+    }
+    row_sse2(out, up, mid, down, j, last);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void row_avx512(uint8_t *out, const uint8_t *up, const uint8_t *mid,
+                       const uint8_t *down, int first, int last) {
+    const __m512i two = _mm512_set1_epi8(2);
+    const __m512i three = _mm512_set1_epi8(3);
+    const __m512i one = _mm512_set1_epi8(1);
+    int j = first;
+
+    for (; j + 64 <= last; j += 64) {
+#define LOAD(p) _mm512_loadu_si512((const void *)(p))
+        __m512i sum = _mm512_add_epi8(_mm512_add_epi8(LOAD(up + j - 1), LOAD(up + j)), LOAD(up + j + 1));
+        sum = _mm512_add_epi8(sum, _mm512_add_epi8(LOAD(mid + j - 1), LOAD(mid + j + 1)));
+        sum = _mm512_add_epi8(sum, _mm512_add_epi8(_mm512_add_epi8(LOAD(down + j - 1), LOAD(down + j)), LOAD(down + j + 1)));
+        __m512i self = LOAD(mid + j);
+#undef LOAD
+        __mmask64 alive = _mm512_cmpeq_epi8_mask(sum, three) |
+                          (_mm512_cmpeq_epi8_mask(sum, two) & _mm512_cmpeq_epi8_mask(self, one));
+        _mm512_storeu_si512((void *)(out + j), _mm512_maskz_mov_epi8(alive, one));
+    }
+    row_avx2(out, up, mid, down, j, last);
+}
+
+#endif // LIFE_SIMD_X86
+
+struct isa_entry {
+    const char *name;
+    row_kernel kernel;
+};
+
+static const struct isa_entry isa_scalar = { "scalar", row_scalar };
+#ifdef LIFE_SIMD_X86
+static const struct isa_entry isa_sse2 = { "sse2", row_sse2 };
+static const struct isa_entry isa_avx2 = { "avx2", row_avx2 };
+static const struct isa_entry isa_avx512 = { "avx512", row_avx512 };
+#endif
+
+// Widest kernel the CPU supports, found once by detect_isa()
+static const struct isa_entry *detected_isa = NULL;
+static pthread_once_t detect_once = PTHREAD_ONCE_INIT;
+
+// Kernel forced by life_simd_select(), or NULL for the detected one
+static _Atomic(const struct isa_entry *) selected_isa = NULL;
+
+/**
+ * @brief Picks the widest instruction set the CPU supports.
+ */
+static void detect_isa(void) {
+    detected_isa = &isa_scalar;
+#ifdef LIFE_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) {
+        detected_isa = &isa_avx512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        detected_isa = &isa_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        detected_isa = &isa_sse2;
+    }
+#endif
+}
+
+static const struct isa_entry *current_isa(void) {
+    const struct isa_entry *isa = atomic_load(&selected_isa);
+    if (isa != NULL) {
+        return isa;
+    }
+    pthread_once(&detect_once, detect_isa);
+    return detected_isa;
+}
+
+const char *life_simd_isa(void) {
+    return current_isa()->name;
+}
+
+int life_simd_select(const char *isa) {
+    const struct isa_entry *entry = NULL;
+    if (strcmp(isa, "auto") == 0) {
+        atomic_store(&selected_isa, NULL);
+        return 0;
+    }
+    if (strcmp(isa, "scalar") == 0) {
+        entry = &isa_scalar;
+    }
+#ifdef LIFE_SIMD_X86
+    pthread_once(&detect_once, detect_isa);
+    if (strcmp(isa, "sse2") == 0 && __builtin_cpu_supports("sse2")) {
+        entry = &isa_sse2;
+    } else if (strcmp(isa, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+        entry = &isa_avx2;
+    } else if (strcmp(isa, "avx512") == 0 && __builtin_cpu_supports("avx512bw")) {
+        entry = &isa_avx512;
+    }
+#endif
+    if (entry == NULL) {
+        return -1;
+    }
+    atomic_store(&selected_isa, entry);
+    return 0;
+}
+
+void life_simd_fill_halo(uint8_t *cells, int width, int height, enum life_edges edges) {
+    const size_t stride = (size_t)width + 2;
+    uint8_t *top = cells;
+    uint8_t *bottom = cells + (height + 1) * stride;
+
+    if (edges == LIFE_EDGES_CLIP) {
+        for (int x = 1; x <= height; x++) {
+            cells[x * stride] = 0;
+            cells[x * stride + width + 1] = 0;
+        }
+        memset(top, 0, stride);
+        memset(bottom, 0, stride);
+        return;
+    }
+
+    // Columns first, so that the row copies below carry the corners
+    for (int x = 1; x <= height; x++) {
+        uint8_t *row = cells + x * stride;
+        row[0] = row[width];
+        row[width + 1] = row[1];
+    }
+    memcpy(top, cells + height * stride, stride);
+    memcpy(bottom, cells + stride, stride);
+}
+
+void life_simd_step_halo(uint8_t *next, const uint8_t *cells, int width, int first, int last,
+                         const struct life_ruleset *rule) {
+    const row_kernel kernel = current_isa()->kernel;
+    const size_t stride = (size_t)width + 2;
+
+    if (!life_rule_is_conway(rule)) {
+        struct rule_table table;
+        build_rule_table(&table, rule);
+        for (int x = first; x < last; x++) {
+            const uint8_t *up = cells + x * stride;
+            row_table(next + (x + 1) * stride, up, up + stride, up + 2 * stride, 1, width + 1, &table);
+        }
+        return;
+    }
+    for (int x = first; x < last; x++) {
+        const uint8_t *up = cells + x * stride;
+        kernel(next + (x + 1) * stride, up, up + stride, up + 2 * stride, 1, width + 1);
+    }
+}
@@ -0,0 +1,87 @@
+/*******************************************************************
+ * Conway's Game of Life - Vectorized Byte-Per-Cell Step Kernel
+ *
+ * Author: hrosicka
+ * Description:
+ *   Advances a board stored as one byte per cell (0 = dead,
+ *   1 = alive, row-major, with a one-cell ghost border) by one
+ *   generation.
+ *   Neighbor sums are formed with byte-wise vector additions, so
+ *   16 (SSE2), 32 (AVX2) or 64 (AVX-512) cells are updated per
+ *   instruction.
+ *
+ *   The instruction set is picked at run time with CPUID, so one
+ *   binary runs on every x86-64 machine. Other architectures, and
+ *   CPUs without SSE2, use the portable scalar version.
+ *   life_simd_select() overrides the choice, for example to compare
+ *   the instruction sets on one machine.
+ *******************************************************************/
+
+#ifndef LIFE_SIMD_H
+#define LIFE_SIMD_H
+
+#include <stdint.h>
+
+#include "grid.h"
+
+/**
+ * @brief Fills the ghost border of a halo-padded board.
+ *
+ * A halo-padded board of width x height cells is stored in
+ * (width + 2) x (height + 2) bytes: cell (x, y) is at byte
+ * (x + 1) * (width + 2) + (y + 1), surrounded by one ghost cell on
+ * every side. The ghost cells receive a copy of the opposite edge on
+ * a torus and zeros on a clipped board.
+ *
+ * @param cells The padded board.
+ * @param width Number of columns, without the border.
+ * @param height Number of rows, without the border.
+ * @param edges Edge mode of the board.
+ */
+void life_simd_fill_halo(uint8_t *cells, int width, int height, enum life_edges edges);
+
+/**
+ * @brief Computes rows [first, last) of the next generation of a
+ * halo-padded board.
+ *
+ * The ghost border of cells must have been filled with
+ * life_simd_fill_halo(). Every cell then has all eight neighbors in
+ * memory, so the kernel runs without any edge checks. Only interior
+ * cells of next are written. Threads may compute disjoint row ranges
+ * of the same generation.
+ *
+ * The result is bit-identical to applying the rule cell by cell
+ * (for B3/S23: a live cell survives with 2 or 3 neighbors, a dead
+ * cell is born with exactly 3). The vector kernels implement B3/S23
+ * only; other rules run a scalar loop over the rule's 2 x 9 table.
+ *
+ * @param next Output board, halo-padded.
+ * @param cells Current board, halo-padded.
+ * @param width Number of columns, without the border.
+ * @param first First row to compute.
+ * @param last One past the last row to compute.
+ * @param rule The rule.
+ */
+void life_simd_step_halo(uint8_t *next, const uint8_t *cells, int width, int first, int last,
+                         const struct life_ruleset *rule);
+
+/**
+ * @brief Returns the name of the instruction set used by life_simd_step_halo().
+ *
+ * @return const char* "avx512", "avx2", "sse2" or "scalar".
+ */
+const char *life_simd_isa(void);
+
+/**
+ * @brief Forces life_simd_step_halo() to use a specific instruction set.
+ *
+ * Call it between generations, not while a step is running.
+ *
+ * @param isa "avx512", "avx2", "sse2", "scalar", or "auto" to restore
+ *            the CPUID choice.
+ * @return int 0 on success, -1 if the name is unknown or the CPU does
+ *             not support it.
+ */
+int life_simd_select(const char *isa);
+
+#endif // LIFE_SIMD_H
@@ -0,0 +1,430 @@
+/*******************************************************************
+ * Conway's Game of Life - Unbounded Sparse Plane
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the plane declared in sparse.h.
+ *
+ * Tiles:
+ *   Tile (tx, ty) covers rows tx * 64 to tx * 64 + 63 and columns
+ *   ty * 64 to ty * 64 + 63. Bit b of tile row r holds column
+ *   ty * 64 + b. Every tile holds two generations; plane->phase says
+ *   which one is current, so one flip advances all tiles at once.
+ *
+ *   A generation runs in three passes: create the neighbor tiles
+ *   that births may spill into, compute every tile from its own rows
+ *   and the edge rows and columns of its eight neighbors, then free
+ *   the tiles that are empty and not touched by live cells next door.
+ *******************************************************************/
+
+#include <stdlib.h>
+
+#include "rule.h"
+#include "sparse.h"
+
+#define MIN_BUCKETS 256
+#define LAST_ROW (LIFE_SPARSE_TILE - 1)
+
+struct sparse_tile {
+    long long tx, ty;                           // Tile position
+    struct sparse_tile *chain;                  // Next tile in the same bucket
+    size_t index;                               // Position in plane->tiles
+    uint64_t rows[2][LIFE_SPARSE_TILE];         // Two generations, see phase
+};
+
+struct life_sparse {
+    struct sparse_tile **buckets;
+    size_t bucket_count;
+    struct sparse_tile **tiles;                 // Every tile, for iteration
+    size_t tile_count;
+    size_t tile_capacity;
+    int phase;                                  // Current generation in rows[]
+    long long generation;
+    struct life_ruleset rule;                   // See life_sparse_set_rule()
+};
+
+/**
+ * @brief Returns the tile index of a cell coordinate (rounded down).
+ */
+static long long tile_of(long long v) {
+    return v >= 0 ? v / LIFE_SPARSE_TILE : -((-(v + 1)) / LIFE_SPARSE_TILE) - 1;
+}
+
+static size_t hash_tile(long long tx, long long ty) {
+    uint64_t h = (uint64_t)tx * 0x9E3779B97F4A7C15ULL;
+    h ^= (uint64_t)ty * 0xC2B2AE3D27D4EB4FULL;
+    return (size_t)(h ^ (h >> 29));
+}
+
+static struct sparse_tile *find_tile(const struct life_sparse *plane, long long tx, long long ty) {
+    size_t b = hash_tile(tx, ty) & (plane->bucket_count - 1);
+    for (struct sparse_tile *tile = plane->buckets[b]; tile != NULL; tile = tile->chain) {
+        if (tile->tx == tx && tile->ty == ty) {
+            return tile;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Doubles the hash table once it holds more tiles than buckets.
+ */
+static void grow_table(struct life_sparse *plane) {
+    size_t count = plane->bucket_count * 2;
+    struct sparse_tile **buckets = calloc(count, sizeof(*buckets));
+    if (buckets == NULL) {
+        return; // Keep the longer chains; lookups stay correct
+    }
+    for (size_t i = 0; i < plane->tile_count; i++) {
+        struct sparse_tile *tile = plane->tiles[i];
+        size_t b = hash_tile(tile->tx, tile->ty) & (count - 1);
+        tile->chain = buckets[b];
+        buckets[b] = tile;
+    }
+    free(plane->buckets);
+    plane->buckets = buckets;
+    plane->bucket_count = count;
+}
+
+/**
+ * @brief Returns the tile at (tx, ty), creating an empty one if needed.
+ *
+ * @return struct sparse_tile* The tile, or NULL if out of memory.
+ */
+static struct sparse_tile *get_tile(struct life_sparse *plane, long long tx, long long ty) {
+    struct sparse_tile *tile = find_tile(plane, tx, ty);
+    if (tile != NULL) {
+        return tile;
+    }
+
+    if (plane->tile_count == plane->tile_capacity) {
+        size_t capacity = plane->tile_capacity * 2;
+        struct sparse_tile **tiles = realloc(plane->tiles, capacity * sizeof(*tiles));
+        if (tiles == NULL) {
+            return NULL;
+        }
+        plane->tiles = tiles;
+        plane->tile_capacity = capacity;
+    }
+    tile = calloc(1, sizeof(*tile));
+    if (tile == NULL) {
+        return NULL;
+    }
+    tile->tx = tx;
+    tile->ty = ty;
+    tile->index = plane->tile_count;
+    plane->tiles[plane->tile_count++] = tile;
+
+    size_t b = hash_tile(tx, ty) & (plane->bucket_count - 1);
+    tile->chain = plane->buckets[b];
+    plane->buckets[b] = tile;
+    if (plane->tile_count > plane->bucket_count) {
+        grow_table(plane);
+    }
+    return tile;
+}
+
+static void remove_tile(struct life_sparse *plane, struct sparse_tile *tile) {
+    struct sparse_tile **link = &plane->buckets[hash_tile(tile->tx, tile->ty) & (plane->bucket_count - 1)];
+    while (*link != tile) {
+        link = &(*link)->chain;
+    }
+    *link = tile->chain;
+
+    // Move the last tile into the freed slot of the list
+    struct sparse_tile *last = plane->tiles[--plane->tile_count];
+    plane->tiles[tile->index] = last;
+    last->index = tile->index;
+    free(tile);
+}
+
+struct life_sparse *life_sparse_create(void) {
+    struct life_sparse *plane = calloc(1, sizeof(*plane));
+    if (plane == NULL) {
+        return NULL;
+    }
+    plane->rule = (struct life_ruleset)LIFE_RULE_CONWAY;
+    plane->bucket_count = MIN_BUCKETS;
+    plane->buckets = calloc(plane->bucket_count, sizeof(*plane->buckets));
+    plane->tile_capacity = MIN_BUCKETS;
+    plane->tiles = malloc(plane->tile_capacity * sizeof(*plane->tiles));
+    if (plane->buckets == NULL || plane->tiles == NULL) {
+        life_sparse_free(plane);
+        return NULL;
+    }
+    return plane;
+}
+
+void life_sparse_free(struct life_sparse *plane) {
+    if (plane == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < plane->tile_count; i++) {
+        free(plane->tiles[i]);
+    }
+    free(plane->tiles);
+    free(plane->buckets);
+    free(plane);
+}
+
+int life_sparse_set(struct life_sparse *plane, long long x, long long y, int alive) {
+    long long tx = tile_of(x), ty = tile_of(y);
+    struct sparse_tile *tile = alive ? get_tile(plane, tx, ty) : find_tile(plane, tx, ty);
+    if (tile == NULL) {
+        return alive ? -1 : 0;
+    }
+    uint64_t *row = &tile->rows[plane->phase][x - tx * LIFE_SPARSE_TILE];
+    uint64_t bit = 1ULL << (y - ty * LIFE_SPARSE_TILE);
+    if (alive) {
+        *row |= bit;
+    } else {
+        *row &= ~bit;
+    }
+    return 0;
+}
+
+int life_sparse_set_run(struct life_sparse *plane, long long x, long long y, long long length) {
+    long long tx = tile_of(x);
+    int row = (int)(x - tx * LIFE_SPARSE_TILE);
+    while (length > 0) {
+        long long ty = tile_of(y);
+        int bit = (int)(y - ty * LIFE_SPARSE_TILE);
+        int count = LIFE_SPARSE_TILE - bit < length ? LIFE_SPARSE_TILE - bit : (int)length;
+        struct sparse_tile *tile = get_tile(plane, tx, ty);
+        if (tile == NULL) {
+            return -1;
+        }
+        uint64_t mask = count == 64 ? ~0ULL : ((1ULL << count) - 1) << bit;
+        tile->rows[plane->phase][row] |= mask;
+        y += count;
+        length -= count;
+    }
+    return 0;
+}
+
+int life_sparse_get(const struct life_sparse *plane, long long x, long long y) {
+    long long tx = tile_of(x), ty = tile_of(y);
+    const struct sparse_tile *tile = find_tile(plane, tx, ty);
+    if (tile == NULL) {
+        return 0;
+    }
+    uint64_t row = tile->rows[plane->phase][x - tx * LIFE_SPARSE_TILE];
+    return (int)((row >> (y - ty * LIFE_SPARSE_TILE)) & 1);
+}
+
+int life_sparse_place_pattern(struct life_sparse *plane, const int pattern[][2], int size,
+                              long long start_x, long long start_y) {
+    for (int i = 0; i < size; i++) {
+        if (life_sparse_set(plane, start_x + pattern[i][0], start_y + pattern[i][1], 1) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void life_sparse_read_rows(const struct life_sparse *plane, long long x, long long y,
+                           int rows, int words, uint64_t *out) {
+    long long ty = tile_of(y);
+    for (int r = 0; r < rows; r++) {
+        long long tx = tile_of(x + r);
+        int row = (int)(x + r - tx * LIFE_SPARSE_TILE);
+        for (int w = 0; w < words; w++) {
+            const struct sparse_tile *tile = find_tile(plane, tx, ty + w);
+            out[(size_t)r * words + w] = tile != NULL ? tile->rows[plane->phase][row] : 0;
+        }
+    }
+}
+
+/**
+ * @brief Creates the neighbor tiles that the next generation may reach.
+ *
+ * A live cell on a tile edge can give birth to cells in the tile
+ * across that edge; a live corner cell also in the diagonal tile.
+ *
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int expand(struct life_sparse *plane) {
+    // Tiles created here are empty, so they need no expansion themselves
+    size_t count = plane->tile_count;
+    for (size_t i = 0; i < count; i++) {
+        const struct sparse_tile *tile = plane->tiles[i];
+        const uint64_t *rows = tile->rows[plane->phase];
+        uint64_t any = 0;
+        for (int r = 0; r < LIFE_SPARSE_TILE; r++) {
+            any |= rows[r];
+        }
+        if (any == 0) {
+            continue;
+        }
+
+        uint64_t top = rows[0], bottom = rows[LAST_ROW];
+        const int reach[3][3] = {
+            { (int)(top & 1), top != 0, (int)(top >> 63) },
+            { (int)(any & 1), 0, (int)(any >> 63) },
+            { (int)(bottom & 1), bottom != 0, (int)(bottom >> 63) },
+        };
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                if (reach[dx + 1][dy + 1] &&
+                    get_tile(plane, tile->tx + dx, tile->ty + dy) == NULL) {
+                    return -1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Computes the next generation of one tile.
+ *
+ * Rows -1 and 64 come from the tiles above and below; the bits shifted
+ * in at columns -1 and 64 come from the tiles to the left and right.
+ * Missing tiles are empty.
+ */
+static void step_tile(const struct life_sparse *plane, struct sparse_tile *tile) {
+    const int cur = plane->phase;
+    const struct sparse_tile *around[3][3];
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            around[dx + 1][dy + 1] = dx == 0 && dy == 0
+                ? tile : find_tile(plane, tile->tx + dx, tile->ty + dy);
+        }
+    }
+
+    // Rows -1 to 64 of the tile, and their shifts by one column
+    uint64_t mid[LIFE_SPARSE_TILE + 2], west[LIFE_SPARSE_TILE + 2], east[LIFE_SPARSE_TILE + 2];
+    for (int r = 0; r < LIFE_SPARSE_TILE + 2; r++) {
+        int band = r == 0 ? 0 : (r == LIFE_SPARSE_TILE + 1 ? 2 : 1);
+        int row = (r + LAST_ROW) % LIFE_SPARSE_TILE;
+        const struct sparse_tile *w = around[band][0], *c = around[band][1], *e = around[band][2];
+        uint64_t center = c != NULL ? c->rows[cur][row] : 0;
+        uint64_t west_in = w != NULL ? w->rows[cur][row] >> 63 : 0;
+        uint64_t east_in = e != NULL ? (e->rows[cur][row] & 1) << 63 : 0;
+        mid[r] = center;
+        west[r] = (center << 1) | west_in;
+        east[r] = (center >> 1) | east_in;
+    }
+
+    uint64_t *next = tile->rows[1 - cur];
+    if (life_rule_is_conway(&plane->rule)) {
+        for (int r = 0; r < LIFE_SPARSE_TILE; r++) {
+            next[r] = life_rule(west[r], mid[r], east[r],
+                                west[r + 1], mid[r + 1], east[r + 1],
+                                west[r + 2], mid[r + 2], east[r + 2]);
+        }
+        return;
+    }
+    for (int r = 0; r < LIFE_SPARSE_TILE; r++) {
+        next[r] = life_rule_generic(&plane->rule, west[r], mid[r], east[r],
+                                    west[r + 1], mid[r + 1], east[r + 1],
+                                    west[r + 2], mid[r + 2], east[r + 2]);
+    }
+}
+
+/**
+ * @brief Tells whether a live cell next door can reach an empty tile.
+ *
+ * Mirrors expand(): such a tile would be created again right away.
+ */
+static int is_needed(const struct life_sparse *plane, const struct sparse_tile *tile) {
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            const struct sparse_tile *other = find_tile(plane, tile->tx + dx, tile->ty + dy);
+            if (other == NULL || other == tile) {
+                continue;
+            }
+            // The other tile's edge that faces this one
+            const uint64_t *rows = other->rows[plane->phase];
+            uint64_t edge = 0;
+            if (dx != 0) {
+                edge = rows[dx < 0 ? LAST_ROW : 0];
+            } else {
+                for (int r = 0; r < LIFE_SPARSE_TILE; r++) {
+                    edge |= rows[r];
+                }
+            }
+            if (dy != 0) {
+                edge &= dy < 0 ? 1ULL << 63 : 1;
+            }
+            if (edge != 0) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Frees the empty tiles that no live cell can reach.
+ */
+static void prune(struct life_sparse *plane) {
+    // Walk backwards: removal moves the last tile into the freed slot
+    for (size_t i = plane->tile_count; i-- > 0;) {
+        struct sparse_tile *tile = plane->tiles[i];
+        const uint64_t *rows = tile->rows[plane->phase];
+        uint64_t any = 0;
+        for (int r = 0; r < LIFE_SPARSE_TILE; r++) {
+            any |= rows[r];
+        }
+        if (any == 0 && !is_needed(plane, tile)) {
+            remove_tile(plane, tile);
+        }
+    }
+}
+
+int life_sparse_step_n(struct life_sparse *plane, long long n) {
+    for (long long i = 0; i < n; i++) {
+        if (expand(plane) != 0) {
+            return -1;
+        }
+        for (size_t t = 0; t < plane->tile_count; t++) {
+            step_tile(plane, plane->tiles[t]);
+        }
+        plane->phase = 1 - plane->phase;
+        plane->generation++;
+        prune(plane);
+    }
+    return 0;
+}
+
+void life_sparse_set_rule(struct life_sparse *plane, const struct life_ruleset *rule) {
+    plane->rule = *rule;
+}
+
+long long life_sparse_generation(const struct life_sparse *plane) {
+    return plane->generation;
+}
+
+long long life_sparse_population(const struct life_sparse *plane) {
+    long long total = 0;
+    for (size_t i = 0; i < plane->tile_count; i++) {
+        const uint64_t *rows = plane->tiles[i]->rows[plane->phase];
+        for (int r = 0; r < LIFE_SPARSE_TILE; r++) {
+            total += __builtin_popcountll(rows[r]);
+        }
+    }
+    return total;
+}
+
+size_t life_sparse_list_cells(const struct life_sparse *plane, long long (*cells)[2], size_t capacity) {
+    size_t count = 0;
+    for (size_t i = 0; i < plane->tile_count; i++) {
+        const struct sparse_tile *tile = plane->tiles[i];
+        const uint64_t *rows = tile->rows[plane->phase];
+        for (int r = 0; r < LIFE_SPARSE_TILE; r++) {
+            for (uint64_t row = rows[r]; row != 0; row &= row - 1) {
+                if (count < capacity) {
+                    cells[count][0] = tile->tx * LIFE_SPARSE_TILE + r;
+                    cells[count][1] = tile->ty * LIFE_SPARSE_TILE + __builtin_ctzll(row);
+                }
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+size_t life_sparse_tiles(const struct life_sparse *plane) {
+    return plane->tile_count;
+}
@@ -0,0 +1,157 @@
+/*******************************************************************
+ * Conway's Game of Life - Unbounded Sparse Plane
+ *
+ * Author: hrosicka
+ * Description:
+ *   Simulates an unbounded plane one generation at a time. The plane
+ *   is cut into square tiles of LIFE_SPARSE_TILE x LIFE_SPARSE_TILE
+ *   cells, stored bit-packed (one 64-bit word per tile row) and kept
+ *   in a hash map keyed by tile position. Only tiles that hold live
+ *   cells exist:
+ *
+ *   - before each generation, an empty neighbor tile is created next
+ *     to every tile whose live cells touch the shared edge or corner,
+ *     since births can spill into it;
+ *   - after each generation, tiles left without live cells are freed.
+ *
+ *   Memory and time therefore follow the live region, not its
+ *   bounding box: gliders leaving a glider gun never hit an edge.
+ *
+ * Coordinates follow the rest of the repository: x is the row index
+ * and y is the column index. Both may be negative.
+ *******************************************************************/
+
+#ifndef LIFE_SPARSE_H
+#define LIFE_SPARSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rule.h"
+
+#define LIFE_SPARSE_TILE 64   // Tile side in cells (one word per tile row)
+
+struct life_sparse;
+
+/**
+ * @brief Creates an empty plane.
+ *
+ * @return struct life_sparse* The plane, or NULL if out of memory.
+ */
+struct life_sparse *life_sparse_create(void);
+
+/**
+ * @brief Frees a plane created by life_sparse_create().
+ *
+ * @param plane The plane to free (may be NULL).
+ */
+void life_sparse_free(struct life_sparse *plane);
+
+/**
+ * @brief Sets the state of a single cell.
+ *
+ * @param plane The plane.
+ * @param x The row index of the cell.
+ * @param y The column index of the cell.
+ * @param alive 1 to make the cell alive, 0 to kill it.
+ * @return int 0 on success, -1 if out of memory.
+ */
+int life_sparse_set(struct life_sparse *plane, long long x, long long y, int alive);
+
+/**
+ * @brief Makes a horizontal run of cells alive.
+ *
+ * Each tile the run crosses is looked up once.
+ *
+ * @param plane The plane.
+ * @param x The row index of the run.
+ * @param y The column index of its first cell.
+ * @param length Number of cells in the run.
+ * @return int 0 on success, -1 if out of memory.
+ */
+int life_sparse_set_run(struct life_sparse *plane, long long x, long long y, long long length);
+
+/**
+ * @brief Returns the state of a single cell.
+ *
+ * @return int 1 if the cell is alive, 0 otherwise.
+ */
+int life_sparse_get(const struct life_sparse *plane, long long x, long long y);
+
+/**
+ * @brief Places a pattern given as a table of {row, column} offsets.
+ *
+ * Accepts the same tables as life_grid_place_pattern(); offsets and
+ * the starting position may be negative.
+ *
+ * @param plane The plane.
+ * @param pattern Array of cell offsets representing the pattern.
+ * @param size Number of cells in the pattern array.
+ * @param start_x Starting row for the pattern.
+ * @param start_y Starting column for the pattern.
+ * @return int 0 on success, -1 if out of memory.
+ */
+int life_sparse_place_pattern(struct life_sparse *plane, const int pattern[][2], int size,
+                              long long start_x, long long start_y);
+
+/**
+ * @brief Copies a window of the plane into bit-packed rows.
+ *
+ * Word w of output row r holds columns y + 64 * w to y + 64 * w + 63
+ * of row x + r, in the layout of a life_grid row.
+ *
+ * @param plane The plane.
+ * @param x First row of the window.
+ * @param y First column of the window; a multiple of LIFE_SPARSE_TILE.
+ * @param rows Number of rows to copy.
+ * @param words 64-bit words per output row.
+ * @param out Output, rows * words words.
+ */
+void life_sparse_read_rows(const struct life_sparse *plane, long long x, long long y,
+                           int rows, int words, uint64_t *out);
+
+/**
+ * @brief Sets the rule of later generations (B3/S23 by default).
+ *
+ * @param plane The plane.
+ * @param rule The rule; must not use B0.
+ */
+void life_sparse_set_rule(struct life_sparse *plane, const struct life_ruleset *rule);
+
+/**
+ * @brief Advances the plane by n generations.
+ *
+ * @param plane The plane.
+ * @param n Number of generations.
+ * @return int 0 on success, -1 if out of memory (the plane is then
+ *             left at the last completed generation).
+ */
+int life_sparse_step_n(struct life_sparse *plane, long long n);
+
+/**
+ * @brief Returns the number of generations simulated so far.
+ */
+long long life_sparse_generation(const struct life_sparse *plane);
+
+/**
+ * @brief Returns the number of live cells on the plane.
+ */
+long long life_sparse_population(const struct life_sparse *plane);
+
+/**
+ * @brief Lists the live cells of the plane, in no particular order.
+ *
+ * @param plane The plane.
+ * @param cells Output, {row, column} of each live cell.
+ * @param capacity Entries available in cells; cells past it are
+ *                 counted but not written.
+ * @return size_t The number of live cells.
+ */
+size_t life_sparse_list_cells(const struct life_sparse *plane, long long (*cells)[2], size_t capacity);
+
+/**
+ * @brief Returns the number of tiles currently allocated.
+ */
+size_t life_sparse_tiles(const struct life_sparse *plane);
+
+#endif // LIFE_SPARSE_H
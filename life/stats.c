@@ -0,0 +1,132 @@
+/*******************************************************************
+ * Conway's Game of Life - Run Statistics
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the timers and stream declared in stats.h.
+ *******************************************************************/
+
+#include <string.h>
+
+#include "clock.h"
+#include "stats.h"
+
+static const char *const phase_names[] = {
+    [LIFE_PHASE_STEP] = "step",
+    [LIFE_PHASE_COPY] = "copy",
+    [LIFE_PHASE_RENDER] = "render",
+    [LIFE_PHASE_SLEEP] = "sleep",
+    [LIFE_PHASE_OTHER] = "other",
+};
+
+void life_timers_start(struct life_timers *timers) {
+    memset(timers, 0, sizeof(*timers));
+    timers->mark = life_clock_seconds();
+}
+
+void life_timers_lap(struct life_timers *timers, enum life_phase phase) {
+    double now = life_clock_seconds();
+    timers->seconds[phase] += now - timers->mark;
+    timers->mark = now;
+}
+
+const char *life_phase_name(enum life_phase phase) {
+    return phase_names[phase];
+}
+
+void life_stats_format_line(char *text, size_t size, const struct life_grid_stats *stats,
+                            const struct life_timers *now, const struct life_timers *then,
+                            long long generations) {
+    int length;
+    if (stats->births >= 0) {
+        length = snprintf(text, size, "Live: %lld (+%lld -%lld)", stats->live, stats->births, stats->deaths);
+    } else {
+        length = snprintf(text, size, "Live: %lld", stats->live);
+    }
+    if (length >= 0 && (size_t)length < size) {
+        if (stats->min_x >= 0) {
+            length += snprintf(text + length, size - (size_t)length, "  Box: %d,%d-%d,%d",
+                               stats->min_x, stats->min_y, stats->max_x, stats->max_y);
+        } else {
+            length += snprintf(text + length, size - (size_t)length, "  Box: none");
+        }
+    }
+    if (generations <= 0 || length < 0 || (size_t)length >= size) {
+        return;
+    }
+    length += snprintf(text + length, size - (size_t)length, "  ms/gen:");
+    for (int p = 0; p < LIFE_PHASE_COUNT && (size_t)length < size; p++) {
+        double seconds = now->seconds[p] - then->seconds[p];
+        if (seconds > 0.0) {
+            length += snprintf(text + length, size - (size_t)length, " %s %.3f",
+                               phase_names[p], seconds * 1e3 / (double)generations);
+        }
+    }
+}
+
+/**
+ * @brief Tells whether a name ends with a suffix.
+ */
+static int ends_with(const char *name, const char *suffix) {
+    size_t length = strlen(name), suffix_length = strlen(suffix);
+    return length >= suffix_length && strcmp(name + length - suffix_length, suffix) == 0;
+}
+
+int life_stats_open(struct life_stats_stream *stream, const char *path) {
+    stream->format = ends_with(path, ".json") || ends_with(path, ".jsonl") ? LIFE_STATS_JSON : LIFE_STATS_CSV;
+    stream->file = fopen(path, "w");
+    if (stream->file == NULL) {
+        return -1;
+    }
+    if (stream->format == LIFE_STATS_CSV) {
+        fprintf(stream->file, "generation,live,births,deaths,min_x,min_y,max_x,max_y");
+        for (int p = 0; p < LIFE_PHASE_COUNT; p++) {
+            fprintf(stream->file, ",%s_s", phase_names[p]);
+        }
+        fprintf(stream->file, "\n");
+    }
+    return 0;
+}
+
+int life_stats_write(struct life_stats_stream *stream, long long generation,
+                     const struct life_grid_stats *stats, const struct life_timers *timers) {
+    FILE *file = stream->file;
+    if (stream->format == LIFE_STATS_CSV) {
+        fprintf(file, "%lld,%lld,", generation, stats->live);
+        if (stats->births >= 0) {
+            fprintf(file, "%lld,%lld", stats->births, stats->deaths);
+        } else {
+            fprintf(file, ",");
+        }
+        fprintf(file, ",%d,%d,%d,%d", stats->min_x, stats->min_y, stats->max_x, stats->max_y);
+        for (int p = 0; p < LIFE_PHASE_COUNT; p++) {
+            fprintf(file, ",%.9f", timers->seconds[p]);
+        }
+    } else {
+        fprintf(file, "{\"generation\":%lld,\"live\":%lld,", generation, stats->live);
+        if (stats->births >= 0) {
+            fprintf(file, "\"births\":%lld,\"deaths\":%lld,", stats->births, stats->deaths);
+        } else {
+            fprintf(file, "\"births\":null,\"deaths\":null,");
+        }
+        if (stats->min_x >= 0) {
+            fprintf(file, "\"box\":[%d,%d,%d,%d]", stats->min_x, stats->min_y, stats->max_x, stats->max_y);
+        } else {
+            fprintf(file, "\"box\":null");
+        }
+        for (int p = 0; p < LIFE_PHASE_COUNT; p++) {
+            fprintf(file, ",\"%s_s\":%.9f", phase_names[p], timers->seconds[p]);
+        }
+        fprintf(file, "}");
+    }
+    return fprintf(file, "\n") < 0 || ferror(file) ? -1 : 0;
+}
+
+int life_stats_close(struct life_stats_stream *stream) {
+    if (stream->file == NULL) {
+        return 0;
+    }
+    int status = fclose(stream->file) == 0 ? 0 : -1;
+    stream->file = NULL;
+    return status;
+}
@@ -0,0 +1,123 @@
+/*******************************************************************
+ * Conway's Game of Life - Run Statistics
+ *
+ * Author: hrosicka
+ * Description:
+ *   Phase timers and the statistics stream of the programs.
+ *
+ *   A run is divided into phases: computing generations, copying
+ *   frames out, rendering, sleeping, and everything else. Each call to
+ *   life_timers_lap() reads the monotonic clock once and charges the
+ *   time since the previous lap to one phase, so the phases always add
+ *   up to the wall-clock time of the run.
+ *
+ *   The stream writes one record per generation, with the board
+ *   statistics of life_grid_stats() and the time spent in each phase
+ *   so far, as CSV or as one JSON object per line.
+ *******************************************************************/
+
+#ifndef LIFE_STATS_H
+#define LIFE_STATS_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "grid.h"
+
+enum life_phase {
+    LIFE_PHASE_STEP,     // Computing generations
+    LIFE_PHASE_COPY,     // Copying frames out of the board
+    LIFE_PHASE_RENDER,   // Drawing frames
+    LIFE_PHASE_SLEEP,    // Waiting between frames
+    LIFE_PHASE_OTHER,    // Checkpoints, statistics output, ...
+    LIFE_PHASE_COUNT
+};
+
+/**
+ * @brief Time spent in each phase since life_timers_start().
+ */
+struct life_timers {
+    double seconds[LIFE_PHASE_COUNT];
+    double mark;        // Clock reading of the last lap
+};
+
+enum life_stats_format {
+    LIFE_STATS_CSV,     // Header line, then one line per record
+    LIFE_STATS_JSON     // One JSON object per line
+};
+
+/**
+ * @brief An open statistics stream.
+ */
+struct life_stats_stream {
+    FILE *file;         // NULL if the stream is closed
+    enum life_stats_format format;
+};
+
+/**
+ * @brief Zeroes the timers and starts the first lap.
+ */
+void life_timers_start(struct life_timers *timers);
+
+/**
+ * @brief Charges the time since the last lap to a phase.
+ */
+void life_timers_lap(struct life_timers *timers, enum life_phase phase);
+
+/**
+ * @brief Returns the name of a phase ("step", "copy", ...).
+ */
+const char *life_phase_name(enum life_phase phase);
+
+/**
+ * @brief Formats the board statistics and the time per generation
+ * spent in each phase between two snapshots of the timers.
+ *
+ * Phases with no time in between are left out.
+ *
+ * @param text Output buffer.
+ * @param size Size of the buffer.
+ * @param stats Statistics of the board.
+ * @param now The timers now.
+ * @param then The timers at the earlier snapshot.
+ * @param generations Generations computed in between.
+ */
+void life_stats_format_line(char *text, size_t size, const struct life_grid_stats *stats,
+                            const struct life_timers *now, const struct life_timers *then,
+                            long long generations);
+
+/**
+ * @brief Creates a statistics file, replacing any file of that name.
+ *
+ * The format is JSON if the name ends in ".json" or ".jsonl", and CSV
+ * otherwise.
+ *
+ * @param stream Opened stream.
+ * @param path Name of the file.
+ * @return int 0 on success, -1 if the file cannot be created.
+ */
+int life_stats_open(struct life_stats_stream *stream, const char *path);
+
+/**
+ * @brief Appends the record of one generation.
+ *
+ * Births and deaths that are not known (-1) are written as empty CSV
+ * fields or JSON nulls.
+ *
+ * @param stream The stream.
+ * @param generation The generation the board is at.
+ * @param stats Statistics of the board.
+ * @param timers Time spent in each phase so far.
+ * @return int 0 on success, -1 on a write error.
+ */
+int life_stats_write(struct life_stats_stream *stream, long long generation,
+                     const struct life_grid_stats *stats, const struct life_timers *timers);
+
+/**
+ * @brief Closes a stream (closing a closed stream does nothing).
+ *
+ * @return int 0 on success, -1 if buffered records could not be written.
+ */
+int life_stats_close(struct life_stats_stream *stream);
+
+#endif // LIFE_STATS_H
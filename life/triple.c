@@ -0,0 +1,53 @@
+/*******************************************************************
+ * Conway's Game of Life - Lock-Free Triple Buffer
+ *
+ * Author: hrosicka
+ * Description:
+ *   Implementation of the triple buffer declared in triple.h.
+ *
+ * Synchronization:
+ *   The release half of the producer's exchange orders the frame
+ *   contents before the new index; the acquire half of the
+ *   consumer's exchange orders the index before its reads. The
+ *   FRESH bit tells the consumer whether the middle slot is newer
+ *   than its front slot.
+ *******************************************************************/
+
+#include <stddef.h>
+
+#include "triple.h"
+
+#define FRESH 4u        // Set in middle when it holds an unread frame
+#define INDEX_MASK 3u
+
+void life_triple_init(struct life_triple *triple, void *a, void *b, void *c) {
+    triple->slots[0] = a;
+    triple->slots[1] = b;
+    triple->slots[2] = c;
+    triple->back = 0;
+    triple->front = 1;
+    atomic_init(&triple->middle, 2u);
+}
+
+void *life_triple_back(struct life_triple *triple) {
+    return triple->slots[triple->back];
+}
+
+void life_triple_publish(struct life_triple *triple) {
+    unsigned old = atomic_exchange_explicit(&triple->middle, (unsigned)triple->back | FRESH,
+                                            memory_order_acq_rel);
+    triple->back = (int)(old & INDEX_MASK);
+}
+
+void *life_triple_read(struct life_triple *triple, int *fresh) {
+    int is_fresh = (atomic_load_explicit(&triple->middle, memory_order_relaxed) & FRESH) != 0;
+    if (is_fresh) {
+        unsigned old = atomic_exchange_explicit(&triple->middle, (unsigned)triple->front,
+                                                memory_order_acq_rel);
+        triple->front = (int)(old & INDEX_MASK);
+    }
+    if (fresh != NULL) {
+        *fresh = is_fresh;
+    }
+    return triple->slots[triple->front];
+}
@@ -0,0 +1,61 @@
+/*******************************************************************
+ * Conway's Game of Life - Lock-Free Triple Buffer
+ *
+ * Author: hrosicka
+ * Description:
+ *   Hands complete frames from one producer thread to one consumer
+ *   thread without locks. There are three slots: the producer fills
+ *   its back slot, the consumer reads its front slot, and the third
+ *   slot holds the latest published frame. Publishing and reading
+ *   each swap a slot index with one atomic exchange, so neither side
+ *   ever waits for the other and the consumer never sees a frame
+ *   that is half written. Frames the consumer does not pick up in
+ *   time are simply overwritten by newer ones.
+ *******************************************************************/
+
+#ifndef LIFE_TRIPLE_H
+#define LIFE_TRIPLE_H
+
+#include <stdatomic.h>
+
+struct life_triple {
+    void *slots[3];             // Caller-owned frame storage
+    int back;                   // Slot owned by the producer
+    int front;                  // Slot owned by the consumer
+    atomic_uint middle;         // Published slot index, plus LIFE_TRIPLE_FRESH
+};
+
+/**
+ * @brief Prepares a triple buffer over three caller-owned slots.
+ *
+ * @param triple The triple buffer.
+ * @param a, b, c The slots; a starts as the producer's back slot and
+ *                b as the consumer's front slot.
+ */
+void life_triple_init(struct life_triple *triple, void *a, void *b, void *c);
+
+/**
+ * @brief Returns the slot the producer may fill.
+ */
+void *life_triple_back(struct life_triple *triple);
+
+/**
+ * @brief Publishes the back slot as the latest frame (producer only).
+ *
+ * The producer receives a new back slot in exchange.
+ */
+void life_triple_publish(struct life_triple *triple);
+
+/**
+ * @brief Returns the latest published frame (consumer only).
+ *
+ * If nothing new was published since the last call, the same frame
+ * is returned again.
+ *
+ * @param triple The triple buffer.
+ * @param fresh Set to 1 if the frame is new, 0 otherwise (may be NULL).
+ * @return void* The frame, valid until the next call.
+ */
+void *life_triple_read(struct life_triple *triple, int *fresh);
+
+#endif // LIFE_TRIPLE_H